@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "config.h"
+
+#if NAM_DEV_DIAGNOSTICS
+// ProcessBlock() sections, in chain order. Each block records the time from the previous mark to the end of the
+// section, so bookkeeping between stages is charged to the stage that follows it.
+enum class DevDiagnosticsStage : size_t
+{
+  Input = 0,
+  Staging,
+  Transpose,
+  Gate,
+  Compressor,
+  Boost,
+  Model,
+  ModelCrossfade,
+  ToneStack,
+  Master,
+  CabA,
+  CabB,
+  PostFilters,
+  EQ,
+  Doubler,
+  Delay,
+  Reverb,
+  Output,
+  Count
+};
+
+constexpr size_t kDevDiagnosticsStageCount = static_cast<size_t>(DevDiagnosticsStage::Count);
+
+inline const char* GetDevDiagnosticsStageName(const DevDiagnosticsStage stage)
+{
+  constexpr std::array<const char*, kDevDiagnosticsStageCount> kNames = {
+    "input", "staging", "transpose", "gate", "comp", "boost", "model", "model-xfade", "tonestack",
+    "master", "cab-a", "cab-b", "post-filters", "eq", "doubler", "delay", "reverb", "output"};
+  const size_t index = static_cast<size_t>(stage);
+  return index < kNames.size() ? kNames[index] : "?";
+}
+
+// Stack-local lap timer for one ProcessBlock() call; stages that did not run this block stay at kNotRun.
+struct DevDiagnosticsStageLaps
+{
+  static constexpr uint64_t kNotRun = ~uint64_t{0};
+
+  explicit DevDiagnosticsStageLaps(const uint64_t startNs) noexcept
+  : lastMarkNs(startNs)
+  {
+    elapsedNs.fill(kNotRun);
+  }
+
+  void Mark(const DevDiagnosticsStage stage, const uint64_t nowNs) noexcept
+  {
+    elapsedNs[static_cast<size_t>(stage)] = (nowNs > lastMarkNs) ? (nowNs - lastMarkNs) : 0;
+    lastMarkNs = nowNs;
+  }
+
+  std::array<uint64_t, kDevDiagnosticsStageCount> elapsedNs;
+  uint64_t lastMarkNs;
+};
+
+// Per-stage block-time histograms. One writer (the audio thread) and any number of readers (UI, CSV dump); all
+// counters are relaxed atomics and the writer never does a read-modify-write, so recording is wait-free.
+// Bins are quarter-octaves from 64 ns to ~67 ms; bin 0 holds anything faster.
+class DevDiagnosticsStageTiming
+{
+public:
+  static constexpr size_t kBinsPerOctave = 4;
+  static constexpr size_t kOctaveCount = 20;
+  static constexpr size_t kBinCount = 2 + kBinsPerOctave * kOctaveCount;
+  static constexpr double kFirstBinUpperNs = 64.0;
+
+  struct StageStats
+  {
+    uint64_t count = 0;
+    double meanNs = 0.0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+  };
+
+  // Audio thread, once per block before any Record(). Applies a pending RequestReset().
+  void BeginBlock() noexcept
+  {
+    if (!mResetRequested.load(std::memory_order_acquire))
+      return;
+    for (auto& stage : mStages)
+    {
+      for (auto& bin : stage.bins)
+        bin.store(0, std::memory_order_relaxed);
+      stage.count.store(0, std::memory_order_relaxed);
+      stage.totalNs.store(0, std::memory_order_relaxed);
+      stage.maxNs.store(0, std::memory_order_relaxed);
+    }
+    mResetRequested.store(false, std::memory_order_release);
+  }
+
+  // Audio thread only.
+  void Record(const DevDiagnosticsStageLaps& laps) noexcept
+  {
+    for (size_t s = 0; s < kDevDiagnosticsStageCount; ++s)
+      if (laps.elapsedNs[s] != DevDiagnosticsStageLaps::kNotRun)
+        Record(static_cast<DevDiagnosticsStage>(s), laps.elapsedNs[s]);
+  }
+
+  void Record(const DevDiagnosticsStage stage, const uint64_t elapsedNs) noexcept
+  {
+    auto& slot = mStages[static_cast<size_t>(stage)];
+    auto& bin = slot.bins[GetBinIndex(elapsedNs)];
+    bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.totalNs.store(slot.totalNs.load(std::memory_order_relaxed) + elapsedNs, std::memory_order_relaxed);
+    if (elapsedNs > slot.maxNs.load(std::memory_order_relaxed))
+      slot.maxNs.store(elapsedNs, std::memory_order_relaxed);
+  }
+
+  // Any thread. Takes effect at the next BeginBlock().
+  void RequestReset() noexcept { mResetRequested.store(true, std::memory_order_release); }
+
+  // Any thread. Percentiles are bin upper edges, so they over-estimate by at most a quarter octave (~19%).
+  StageStats GetStats(const DevDiagnosticsStage stage) const noexcept
+  {
+    const auto& slot = mStages[static_cast<size_t>(stage)];
+    std::array<uint32_t, kBinCount> bins = {};
+    uint64_t binTotal = 0;
+    for (size_t i = 0; i < kBinCount; ++i)
+    {
+      bins[i] = slot.bins[i].load(std::memory_order_relaxed);
+      binTotal += bins[i];
+    }
+    StageStats stats;
+    stats.count = slot.count.load(std::memory_order_relaxed);
+    stats.maxNs = static_cast<double>(slot.maxNs.load(std::memory_order_relaxed));
+    if (stats.count == 0 || binTotal == 0)
+      return stats;
+    stats.meanNs = static_cast<double>(slot.totalNs.load(std::memory_order_relaxed)) / static_cast<double>(stats.count);
+    stats.p50Ns = std::min(stats.maxNs, PercentileFromBins(bins, binTotal, 0.50));
+    stats.p99Ns = std::min(stats.maxNs, PercentileFromBins(bins, binTotal, 0.99));
+    return stats;
+  }
+
+  // Any thread. One row per stage: summary columns, then the count in each histogram bin ("le_<upper edge>_us").
+  void WriteCSV(std::ostream& out) const
+  {
+    out << "stage,count,mean_us,p50_us,p99_us,max_us";
+    for (size_t i = 0; i < kBinCount; ++i)
+    {
+      // Edges rounded to the nanosecond keep the header readable.
+      if (i + 1 == kBinCount)
+        out << ",gt_" << std::round(GetBinUpperNs(i - 1)) * 1.0e-3 << "_us";
+      else
+        out << ",le_" << std::round(GetBinUpperNs(i)) * 1.0e-3 << "_us";
+    }
+    out << "\n";
+    for (size_t s = 0; s < kDevDiagnosticsStageCount; ++s)
+    {
+      const auto stage = static_cast<DevDiagnosticsStage>(s);
+      const StageStats stats = GetStats(stage);
+      out << GetDevDiagnosticsStageName(stage) << "," << stats.count << "," << stats.meanNs * 1.0e-3 << ","
+          << stats.p50Ns * 1.0e-3 << "," << stats.p99Ns * 1.0e-3 << "," << stats.maxNs * 1.0e-3;
+      for (const auto& bin : mStages[s].bins)
+        out << "," << bin.load(std::memory_order_relaxed);
+      out << "\n";
+    }
+  }
+
+  static double GetBinUpperNs(const size_t binIndex)
+  {
+    return kFirstBinUpperNs * std::exp2(static_cast<double>(binIndex) / static_cast<double>(kBinsPerOctave));
+  }
+
+private:
+  struct StageSlot
+  {
+    std::array<std::atomic<uint32_t>, kBinCount> bins = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+  };
+
+  static size_t GetBinIndex(const uint64_t elapsedNs) noexcept
+  {
+    if (static_cast<double>(elapsedNs) <= kFirstBinUpperNs)
+      return 0;
+    const double position =
+      std::ceil(std::log2(static_cast<double>(elapsedNs) / kFirstBinUpperNs) * static_cast<double>(kBinsPerOctave));
+    return std::min(static_cast<size_t>(position), kBinCount - 1);
+  }
+
+  static double PercentileFromBins(const std::array<uint32_t, kBinCount>& bins, const uint64_t total,
+                                   const double fraction)
+  {
+    const auto rank =
+      std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBinCount; ++i)
+    {
+      cumulative += bins[i];
+      if (cumulative >= rank)
+        return GetBinUpperNs(std::min(i, kBinCount - 2));
+    }
+    return GetBinUpperNs(kBinCount - 2);
+  }
+
+  std::array<StageSlot, kDevDiagnosticsStageCount> mStages;
+  std::atomic<bool> mResetRequested{false};
+};
+#endif
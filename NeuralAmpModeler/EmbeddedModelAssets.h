@@ -4,11 +4,25 @@
 
 namespace embedded_model
 {
+// One "weights" array of a model config, stored as float32 rather than JSON text.
+struct EmbeddedModelWeightArray
+{
+  const char* jsonPointer; // where the array goes in the config, e.g. "/config/submodels/1/model/weights"
+  size_t offset; // into EmbeddedModelAsset::weights; a multiple of 4, so every array is 16-byte aligned
+  size_t count;
+};
+
+// The model config is JSON with every non-empty "weights" array emptied; the arrays themselves are stored in
+// weights. The loader parses the (small) config and copies the arrays back in (EmbeddedModelConfig.h), so no float
+// text is parsed.
 struct EmbeddedModelAsset
 {
   const char* token;
   const char* json;
   size_t jsonSize;
+  const float* weights;
+  const EmbeddedModelWeightArray* weightArrays;
+  size_t numWeightArrays;
 };
 
 const EmbeddedModelAsset* GetAmpModelAsset(const char* token);
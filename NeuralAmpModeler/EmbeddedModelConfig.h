@@ -0,0 +1,31 @@
+#pragma once
+
+// Model config of an embedded asset, shared by the plug-in loader and nam-model-zoo.
+
+#include <cstring>
+#include <vector>
+
+#include "EmbeddedModelAssets.h"
+#include "json.hpp"
+
+namespace embedded_model
+{
+// Puts the asset's float32 weight arrays back into its parsed config. With topLevelWeights, the model's own "/weights"
+// array is copied there as floats (for nam::get_dsp() through nam::dspData) and removed from the config; only arrays
+// the core reads from json, those of container submodels, become json arrays.
+inline void InsertWeightArrays(const EmbeddedModelAsset& asset, nlohmann::json& config,
+                               std::vector<float>* topLevelWeights = nullptr)
+{
+  for (size_t i = 0; i < asset.numWeightArrays; ++i)
+  {
+    const auto& array = asset.weightArrays[i];
+    const float* weights = asset.weights + array.offset;
+    if (topLevelWeights != nullptr && std::strcmp(array.jsonPointer, "/weights") == 0)
+      topLevelWeights->assign(weights, weights + array.count);
+    else
+      config.at(nlohmann::json::json_pointer(array.jsonPointer)) = std::vector<float>(weights, weights + array.count);
+  }
+  if (topLevelWeights != nullptr)
+    config.erase("weights");
+}
+} // namespace embedded_model
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RTSemaphore.h"
+#include "RTThreadPriority.h"
+
+// Process-wide helper threads behind every ForkJoinExecutor: a few workers however many plug-in instances fork, so
+// 20 instances don't bring 20 helpers. Idle workers sleep on a semaphore. They run in the real-time class
+// (RTThreadPriority.h) so a task the audio thread joins on isn't preempted by ordinary threads halfway through; one
+// that wakes late only costs the parallelism, because Join() takes an unclaimed task back.
+class ForkJoinPool
+{
+public:
+  using Task = void (*)(void* context);
+
+  // One forked task. Owned by the forking thread and reused from fork to fork.
+  struct Ticket
+  {
+    Task task = nullptr;
+    void* context = nullptr;
+    std::atomic<int> state{kIdle};
+    size_t slot = 0;
+    // Posted once by every worker that takes the ticket out of its slot, whether it ran the task or not.
+    RTSemaphore done;
+  };
+
+  enum : int
+  {
+    kIdle = 0,
+    kPending,
+    kRunning,
+    kTakenBack
+  };
+
+  static constexpr size_t kMaxWorkers = 4;
+  // Forks in flight at once, across all instances; Submit() fails beyond that and the caller runs the task itself.
+  static constexpr size_t kNumSlots = 64;
+  // Scheduling period announced for the workers; they serve every instance's callbacks, so a short host block.
+  static constexpr double kWorkerPeriodSeconds = 128.0 / 48000.0;
+
+  static ForkJoinPool& Get()
+  {
+    static ForkJoinPool pool;
+    return pool;
+  }
+
+  ~ForkJoinPool() { _StopWorkers(); }
+
+  ForkJoinPool(const ForkJoinPool&) = delete;
+  ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+  // Not on the audio thread. The workers run while at least one user holds the pool.
+  void AddUser()
+  {
+    std::lock_guard<std::mutex> lock(mUsersMutex);
+    if (mNumUsers++ == 0)
+      _StartWorkers();
+  }
+
+  void RemoveUser()
+  {
+    std::lock_guard<std::mutex> lock(mUsersMutex);
+    if (mNumUsers > 0 && --mNumUsers == 0)
+      _StopWorkers();
+  }
+
+  // Lock-free. Returns false if every slot is taken.
+  bool Submit(Ticket& ticket)
+  {
+    for (size_t i = 0; i < kNumSlots; ++i)
+    {
+      Ticket* expected = nullptr;
+      if (mSlots[i].compare_exchange_strong(expected, &ticket, std::memory_order_acq_rel))
+      {
+        ticket.slot = i;
+        mWork.Post();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes a submitted ticket back out of its slot. Returns false if a worker already has it, in which case that
+  // worker posts ticket.done.
+  bool Unlink(Ticket& ticket)
+  {
+    Ticket* expected = &ticket;
+    return mSlots[ticket.slot].compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+  }
+
+private:
+  ForkJoinPool() = default;
+
+  void _StartWorkers()
+  {
+    const size_t numWorkers =
+      std::clamp<size_t>(static_cast<size_t>(std::thread::hardware_concurrency()) / 2, 1, kMaxWorkers);
+    mStop.store(false, std::memory_order_relaxed);
+    for (size_t i = 0; i < numWorkers; ++i)
+      mWorkers.emplace_back([this]() {
+        PromoteCurrentThreadToRealtime(kWorkerPeriodSeconds);
+        _Run();
+      });
+  }
+
+  void _StopWorkers()
+  {
+    if (mWorkers.empty())
+      return;
+    mStop.store(true, std::memory_order_release);
+    for (size_t i = 0; i < mWorkers.size(); ++i)
+      mWork.Post();
+    for (auto& worker : mWorkers)
+      worker.join();
+    mWorkers.clear();
+    // Posts no worker consumed would wake the next set of workers for nothing; harmless, so they are left.
+  }
+
+  void _Run()
+  {
+    while (true)
+    {
+      mWork.Wait();
+      if (mStop.load(std::memory_order_acquire))
+        return;
+      for (auto& slot : mSlots)
+      {
+        Ticket* ticket = slot.load(std::memory_order_acquire);
+        if (ticket == nullptr || !slot.compare_exchange_strong(ticket, nullptr, std::memory_order_acq_rel))
+          continue;
+        int expected = kPending;
+        if (ticket->state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+          ticket->task(ticket->context);
+        // Last touch: the forking thread may reuse the ticket as soon as this is posted.
+        ticket->done.Post();
+        break;
+      }
+    }
+  }
+
+  std::array<std::atomic<Ticket*>, kNumSlots> mSlots{};
+  RTSemaphore mWork;
+  std::atomic<bool> mStop{false};
+  std::vector<std::thread> mWorkers;
+  std::mutex mUsersMutex;
+  int mNumUsers = 0;
+};
+
+// Runs one task on the shared ForkJoinPool while the calling thread does its own share, then joins; no latency, both
+// halves finish inside the caller's callback. If no worker has picked the task up by the time the caller joins, the
+// caller takes it back and runs it itself, so a slow wake-up never costs more than serial execution. Fork() and Join()
+// take no lock and don't allocate; Join() blocks on a semaphore only while a worker is running the task.
+//
+// One fork at a time, from one thread at a time.
+class ForkJoinExecutor
+{
+public:
+  using Task = ForkJoinPool::Task;
+
+  ForkJoinExecutor() = default;
+  ~ForkJoinExecutor() { Stop(); }
+
+  ForkJoinExecutor(const ForkJoinExecutor&) = delete;
+  ForkJoinExecutor& operator=(const ForkJoinExecutor&) = delete;
+
+  // Not on the audio thread.
+  void Start()
+  {
+    if (mPool != nullptr)
+      return;
+    mPool = &ForkJoinPool::Get();
+    mPool->AddUser();
+  }
+
+  // Not on the audio thread, and not between Fork() and Join().
+  void Stop()
+  {
+    if (mPool == nullptr)
+      return;
+    mPool->RemoveUser();
+    mPool = nullptr;
+  }
+
+  bool IsRunning() const { return mPool != nullptr; }
+
+  // Hands task(context) to the pool. Every Fork() must be followed by Join() before the context goes away.
+  void Fork(const Task task, void* context)
+  {
+    mTicket.task = task;
+    mTicket.context = context;
+    mTicket.state.store(ForkJoinPool::kPending, std::memory_order_relaxed);
+    // The slot exchange in Submit() publishes the fields above to the worker that claims the ticket.
+    mSubmitted = mPool->Submit(mTicket);
+  }
+
+  void Join()
+  {
+    if (!mSubmitted)
+    {
+      mTicket.task(mTicket.context);
+      return;
+    }
+    int expected = ForkJoinPool::kPending;
+    const bool takenBack =
+      mTicket.state.compare_exchange_strong(expected, ForkJoinPool::kTakenBack, std::memory_order_acquire);
+    const bool unlinked = mPool->Unlink(mTicket);
+    if (takenBack)
+      mTicket.task(mTicket.context);
+    // A worker that took the ticket out of its slot posts once it is done with it, ran it or not.
+    if (!unlinked)
+      mTicket.done.Wait();
+  }
+
+private:
+  ForkJoinPool* mPool = nullptr;
+  ForkJoinPool::Ticket mTicket;
+  bool mSubmitted = false;
+};
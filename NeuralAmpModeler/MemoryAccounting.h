@@ -0,0 +1,80 @@
+#pragma once
+
+// Per-instance memory report: one entry per model, IR and large DSP buffer an instance holds.
+//
+// Model sizes are computed from the model the loader built: its weights as floats (exact) plus its layer and resampler
+// buffers, estimated from the architecture config for the block size it was prepared for. IR sizes are estimated from
+// the raw and resampled tap counts. FX buffers are exact vector capacities.
+
+#include <array>
+#include <cstddef>
+
+enum class MemoryCategory : size_t
+{
+  AmpModel = 0, // live, cached and pending-handoff amp slot models
+  StompModel,
+  StagedModel, // models waiting for the audio thread to pick them up
+  IR,
+  StagedIR,
+  PreviousIR, // outgoing cab IRs kept for the switch crossfade
+  FXBuffer, // delay, reverb and doubler lines
+  Tuner,
+  Count
+};
+
+constexpr size_t kMemoryCategoryCount = static_cast<size_t>(MemoryCategory::Count);
+
+inline const char* GetMemoryCategoryName(const MemoryCategory category)
+{
+  constexpr std::array<const char*, kMemoryCategoryCount> kNames = {
+    "amp-models", "stomp-models", "staged-models", "irs", "staged-irs", "previous-irs", "fx-buffers", "tuner"};
+  const size_t index = static_cast<size_t>(category);
+  return index < kNames.size() ? kNames[index] : "?";
+}
+
+struct MemoryReportEntry
+{
+  MemoryCategory category = MemoryCategory::AmpModel;
+  const char* name = ""; // string literal
+  int index = -1; // slot/storage index where the name alone is ambiguous, -1 otherwise
+  size_t bytes = 0;
+};
+
+// Fixed capacity so the audio thread can fill one without allocating.
+struct MemoryReport
+{
+  static constexpr size_t kMaxEntries = 80;
+
+  void Clear() { numEntries = 0; }
+
+  void Add(const MemoryCategory category, const char* name, const int index, const size_t bytes)
+  {
+    if (bytes == 0 || numEntries >= kMaxEntries)
+      return;
+    entries[numEntries++] = {category, name, index, bytes};
+  }
+
+  size_t GetTotalBytes(const MemoryCategory category) const
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < numEntries; ++i)
+      if (entries[i].category == category)
+        total += entries[i].bytes;
+    return total;
+  }
+
+  size_t GetTotalBytes() const
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < numEntries; ++i)
+      total += entries[i].bytes;
+    return total;
+  }
+
+  std::array<MemoryReportEntry, kMaxEntries> entries = {};
+  size_t numEntries = 0;
+};
+
+// Bytes the process currently has allocated from the heap, or 0 where that isn't available. Only meaningful as a
+// difference between two calls; other threads' allocations in between are counted too. (NeuralAmpModeler.cpp)
+size_t GetHeapBytesInUse();
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Process-wide model loader threads shared by every plug-in instance, so a session with many instances loads with a
+// few workers instead of a few per instance. Jobs are queued per (owner, key): a new job replaces the owner's queued
+// job for the same key, and a job waits while another one for its key is running, so loads for one slot never
+// overlap or publish out of order. Lower priority values run first, oldest first among equals, across all owners.
+class ModelLoadPool
+{
+public:
+  static constexpr int kMaxWorkers = 3;
+
+  static ModelLoadPool& Get()
+  {
+    static ModelLoadPool pool;
+    return pool;
+  }
+
+  ~ModelLoadPool() { _StopWorkers(); }
+
+  ModelLoadPool(const ModelLoadPool&) = delete;
+  ModelLoadPool& operator=(const ModelLoadPool&) = delete;
+
+  // The workers run while at least one owner holds the pool.
+  void AddUser()
+  {
+    std::lock_guard<std::mutex> lock(mUsersMutex);
+    if (mNumUsers++ == 0)
+      _StartWorkers();
+  }
+
+  void RemoveUser()
+  {
+    std::lock_guard<std::mutex> lock(mUsersMutex);
+    if (mNumUsers > 0 && --mNumUsers == 0)
+      _StopWorkers();
+  }
+
+  void Submit(const void* owner, const int key, const int priority, std::function<void()> run)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+                                 [owner, key](const Job& job) { return job.owner == owner && job.key == key; }),
+                  mJobs.end());
+      mJobs.push_back({owner, key, priority, std::move(run)});
+    }
+    mCV.notify_one();
+  }
+
+  // getPriority(key) -> int, called under the queue lock for each of the owner's queued jobs.
+  template <typename GetPriority>
+  void UpdatePriorities(const void* owner, GetPriority&& getPriority)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& job : mJobs)
+      if (job.owner == owner)
+        job.priority = getPriority(job.key);
+  }
+
+  // Drops the owner's queued jobs and waits for its running ones, after which no job of the owner's runs again.
+  void Cancel(const void* owner)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(), [owner](const Job& job) { return job.owner == owner; }),
+                mJobs.end());
+    mCV.wait(lock, [this, owner]() {
+      return std::none_of(
+        mRunning.begin(), mRunning.end(), [owner](const std::pair<const void*, int>& r) { return r.first == owner; });
+    });
+  }
+
+private:
+  struct Job
+  {
+    const void* owner = nullptr;
+    int key = 0;
+    int priority = 0;
+    std::function<void()> run;
+  };
+
+  ModelLoadPool() = default;
+
+  void _StartWorkers()
+  {
+    // Leave a core each for the audio and UI threads. Three workers cover the active slot's two variants plus a
+    // background slot, so a recall is playable after roughly one model's load time.
+    const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    const int numWorkers = std::clamp(hardwareThreads - 2, 1, kMaxWorkers);
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mExit = false;
+    }
+    for (int i = 0; i < numWorkers; ++i)
+      mWorkers.emplace_back([this]() { _Run(); });
+  }
+
+  void _StopWorkers()
+  {
+    if (mWorkers.empty())
+      return;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mExit = true;
+      mJobs.clear();
+    }
+    mCV.notify_all();
+    for (auto& worker : mWorkers)
+      worker.join();
+    mWorkers.clear();
+  }
+
+  bool _IsRunning(const void* owner, const int key) const
+  {
+    return std::find(mRunning.begin(), mRunning.end(), std::make_pair(owner, key)) != mRunning.end();
+  }
+
+  void _Run()
+  {
+    while (true)
+    {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto next = mJobs.end();
+        mCV.wait(lock, [this, &next]() {
+          if (mExit)
+            return true;
+          next = mJobs.end();
+          for (auto it = mJobs.begin(); it != mJobs.end(); ++it)
+            if (!_IsRunning(it->owner, it->key) && (next == mJobs.end() || it->priority < next->priority))
+              next = it;
+          return next != mJobs.end();
+        });
+        if (mExit)
+          return;
+        job = std::move(*next);
+        mJobs.erase(next);
+        mRunning.emplace_back(job.owner, job.key);
+      }
+
+      job.run();
+
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning.erase(std::find(mRunning.begin(), mRunning.end(), std::make_pair(job.owner, job.key)));
+      }
+      // Another worker may be waiting for this key, or Cancel() for this owner.
+      mCV.notify_all();
+    }
+  }
+
+  std::mutex mMutex;
+  std::condition_variable mCV;
+  std::deque<Job> mJobs;
+  std::vector<std::pair<const void*, int>> mRunning;
+  bool mExit = false;
+  std::vector<std::thread> mWorkers;
+  std::mutex mUsersMutex;
+  int mNumUsers = 0;
+};
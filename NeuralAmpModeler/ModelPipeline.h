@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "RTSemaphore.h"
+#include "RTThreadPriority.h"
+
+// Runs one processing stage a fixed maxBlockSize frames behind the audio callback, on a worker thread. Each
+// Exchange() hands the block to the worker and returns the stage output that is due now, so the stage runs while the
+// audio thread finishes the rest of the chain and while the host is between callbacks. At the top of the next
+// callback, WaitIdle() takes the chunk back and runs it on the audio thread if the worker hasn't started it yet, and
+// only blocks if the worker is in the middle of it. The worker runs in the real-time class (RTThreadPriority.h) and
+// sleeps on a semaphore between chunks.
+//
+// Whatever the process function reads or writes belongs to the worker from Exchange() until the next WaitIdle()
+// returns.
+template <typename SampleType>
+class ModelPipeline
+{
+public:
+  using ProcessFunction = void (*)(void* context, SampleType** inputs, SampleType** outputs, int numFrames);
+
+  ModelPipeline(ProcessFunction process, void* context)
+  : mProcess(process)
+  , mContext(context)
+  {
+  }
+
+  ~ModelPipeline() { Stop(); }
+
+  ModelPipeline(const ModelPipeline&) = delete;
+  ModelPipeline& operator=(const ModelPipeline&) = delete;
+
+  // Not on the audio thread: allocates and starts the worker.
+  void Prepare(const size_t numChannels, const int maxBlockSize, const double sampleRate)
+  {
+    Stop();
+    mMaxBlockSize = std::max(1, maxBlockSize);
+    const size_t blockSize = static_cast<size_t>(mMaxBlockSize);
+    mInput.assign(numChannels, std::vector<SampleType>(blockSize));
+    mOutput.assign(numChannels, std::vector<SampleType>(blockSize));
+    mRing.assign(numChannels, std::vector<SampleType>(2 * blockSize));
+    mInputPointers.assign(numChannels, nullptr);
+    mOutputPointers.assign(numChannels, nullptr);
+    mChunkInputPointers.assign(numChannels, nullptr);
+    mChunkOutputPointers.assign(numChannels, nullptr);
+    for (size_t c = 0; c < numChannels; ++c)
+    {
+      mInputPointers[c] = mInput[c].data();
+      mOutputPointers[c] = mOutput[c].data();
+    }
+    Clear();
+    mState.store(kIdle, std::memory_order_relaxed);
+    mStop.store(false, std::memory_order_relaxed);
+    const double periodSeconds = (sampleRate > 0.0) ? static_cast<double>(mMaxBlockSize) / sampleRate : 0.0;
+    mThread = std::thread([this, periodSeconds]() {
+      PromoteCurrentThreadToRealtime(periodSeconds);
+      _Run();
+    });
+  }
+
+  // Not on the audio thread, with the stream stopped: finishes the chunk in flight and joins the worker.
+  void Stop()
+  {
+    if (!mThread.joinable())
+      return;
+    WaitIdle();
+    mStop.store(true, std::memory_order_release);
+    mWork.Post();
+    mThread.join();
+  }
+
+  bool IsRunning() const { return mThread.joinable(); }
+  int GetLatency() const { return mMaxBlockSize; }
+
+  // Audio thread: completes the chunk handed over by the previous Exchange(), on this thread if the worker hasn't
+  // claimed it yet.
+  void WaitIdle()
+  {
+    if (!mChunkInFlight)
+      return;
+    mChunkInFlight = false;
+    int expected = kPending;
+    if (mState.compare_exchange_strong(expected, kIdle, std::memory_order_acquire))
+    {
+      // The worker still gets the semaphore post and finds nothing pending.
+      _ProcessChunk();
+      return;
+    }
+    mDone.Wait();
+    mState.store(kIdle, std::memory_order_relaxed);
+  }
+
+  // Not while a chunk is in flight: drops the queued output; the next GetLatency() frames out are silence.
+  void Clear()
+  {
+    for (auto& ring : mRing)
+      std::fill(ring.begin(), ring.end(), SampleType(0));
+    mReadPos = 0;
+    mWritePos = static_cast<size_t>(mMaxBlockSize);
+  }
+
+  // Audio thread, after WaitIdle(): writes the stage output from GetLatency() frames ago to outputs and hands inputs
+  // to the worker. The channel count may change between calls (the stereo core collapsing to mono and back) without a
+  // gap in the output. A block larger than the prepared size (a host exceeding its announced maximum) goes through
+  // the ring in prepared-size chunks, all but the last completed on the spot, so the latency never changes.
+  void Exchange(SampleType** inputs, SampleType** outputs, size_t numChannels, const int numFrames)
+  {
+    numChannels = std::min(numChannels, mRing.size());
+    if (numChannels == 0 || numFrames <= 0)
+      return;
+
+    for (int offset = 0; offset < numFrames; offset += mMaxBlockSize)
+    {
+      const int chunkFrames = std::min(mMaxBlockSize, numFrames - offset);
+      for (size_t c = 0; c < numChannels; ++c)
+      {
+        mChunkInputPointers[c] = inputs[c] + offset;
+        mChunkOutputPointers[c] = outputs[c] + offset;
+      }
+      WaitIdle();
+      _Exchange(mChunkInputPointers.data(), mChunkOutputPointers.data(), numChannels, chunkFrames);
+    }
+  }
+
+private:
+  enum : int
+  {
+    kIdle = 0,
+    kPending,
+    kRunning,
+  };
+
+  void _Exchange(SampleType** inputs, SampleType** outputs, const size_t numChannels, const int numFrames)
+  {
+    const size_t frames = static_cast<size_t>(numFrames);
+    const size_t ringSize = mRing.front().size();
+    for (size_t c = 0; c < numChannels; ++c)
+    {
+      const SampleType* ring = mRing[c].data();
+      size_t pos = mReadPos;
+      for (size_t s = 0; s < frames; ++s)
+      {
+        outputs[c][s] = ring[pos];
+        if (++pos == ringSize)
+          pos = 0;
+      }
+      std::copy_n(inputs[c], frames, mInput[c].data());
+    }
+    mReadPos = (mReadPos + frames) % ringSize;
+
+    mPendingFrames = numFrames;
+    mPendingChannels = numChannels;
+    mChunkInFlight = true;
+    mState.store(kPending, std::memory_order_release);
+    mWork.Post();
+  }
+
+  // On whichever thread claimed the chunk.
+  void _ProcessChunk()
+  {
+    const int numFrames = mPendingFrames;
+    mProcess(mContext, mInputPointers.data(), mOutputPointers.data(), numFrames);
+    const size_t frames = static_cast<size_t>(std::max(numFrames, 0));
+    const size_t ringSize = mRing.front().size();
+    // Every ring channel is written: channels this chunk didn't carry get channel 0 (the mono core), so a later
+    // stereo block reads valid audio instead of a stale or silent stretch.
+    for (size_t c = 0; c < mRing.size(); ++c)
+    {
+      const SampleType* output = mOutput[c < mPendingChannels ? c : 0].data();
+      SampleType* ring = mRing[c].data();
+      size_t pos = mWritePos;
+      for (size_t s = 0; s < frames; ++s)
+      {
+        ring[pos] = output[s];
+        if (++pos == ringSize)
+          pos = 0;
+      }
+    }
+    mWritePos = (mWritePos + frames) % ringSize;
+  }
+
+  void _Run()
+  {
+    while (true)
+    {
+      mWork.Wait();
+      if (mStop.load(std::memory_order_acquire))
+        return;
+      int expected = kPending;
+      if (!mState.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+        continue; // Taken back by WaitIdle().
+      _ProcessChunk();
+      mDone.Post();
+    }
+  }
+
+  ProcessFunction mProcess = nullptr;
+  void* mContext = nullptr;
+  int mMaxBlockSize = 0;
+  std::vector<std::vector<SampleType>> mInput;
+  std::vector<std::vector<SampleType>> mOutput;
+  // Stage output, GetLatency() frames ahead of the read position once the chunk in flight is done.
+  std::vector<std::vector<SampleType>> mRing;
+  std::vector<SampleType*> mInputPointers;
+  std::vector<SampleType*> mOutputPointers;
+  // Exchange(): the caller's buffers at the current chunk offset.
+  std::vector<SampleType*> mChunkInputPointers;
+  std::vector<SampleType*> mChunkOutputPointers;
+  size_t mReadPos = 0;
+  size_t mWritePos = 0;
+  int mPendingFrames = 0;
+  size_t mPendingChannels = 0;
+  // Audio thread only: an Exchange() whose chunk WaitIdle() hasn't completed yet.
+  bool mChunkInFlight = false;
+  // kPending from Exchange() until the worker (kRunning) or WaitIdle() (kIdle) claims the chunk.
+  std::atomic<int> mState{kIdle};
+
+  std::atomic<bool> mStop{false};
+  RTSemaphore mWork;
+  RTSemaphore mDone;
+  std::thread mThread;
+};
+
+// Audio thread: replays events a fixed number of frames after they are pushed, so output-side state that belongs to a
+// model swap (output gain, de-click) reaches the output together with the first pipelined samples of that model.
+template <typename T, size_t Capacity = 16>
+class PipelineEventDelay
+{
+public:
+  void Clear()
+  {
+    mCount = 0;
+    mNow = 0;
+  }
+
+  // When full, the newest queued event takes the value instead of queuing another one.
+  void Push(const T& value, const int delayFrames)
+  {
+    const uint64_t due = mNow + static_cast<uint64_t>(std::max(delayFrames, 0));
+    if (mCount == Capacity)
+    {
+      mEvents[(mFirst + mCount - 1) % Capacity].value = value;
+      return;
+    }
+    mEvents[(mFirst + mCount) % Capacity] = {due, value};
+    ++mCount;
+  }
+
+  // Calls onEvent(offset, value) for each event due within the next numFrames frames, in push order, with its offset
+  // into the block; then moves on by numFrames.
+  template <typename OnEvent>
+  void Advance(const int numFrames, OnEvent&& onEvent)
+  {
+    const uint64_t end = mNow + static_cast<uint64_t>(std::max(numFrames, 0));
+    while (mCount > 0 && mEvents[mFirst].due < end)
+    {
+      const Event& event = mEvents[mFirst];
+      onEvent(static_cast<int>(event.due > mNow ? event.due - mNow : 0), event.value);
+      mFirst = (mFirst + 1) % Capacity;
+      --mCount;
+    }
+    mNow = end;
+  }
+
+private:
+  struct Event
+  {
+    uint64_t due = 0;
+    T value{};
+  };
+
+  std::array<Event, Capacity> mEvents{};
+  size_t mFirst = 0;
+  size_t mCount = 0;
+  uint64_t mNow = 0;
+};
@@ -0,0 +1,258 @@
+#include "NAMTrace.h"
+
+#if NAM_TRACE
+  #include <array>
+  #include <atomic>
+  #include <chrono>
+  #include <cstdio>
+  #include <mutex>
+  #include <thread>
+
+namespace NAMTrace
+{
+namespace
+{
+// ~1.8 MB of static storage; at 48 kHz / 64 frames that is over 40 s of ProcessBlock spans, while the writer drains
+// every few milliseconds.
+constexpr size_t kRingCapacity = size_t{1} << 15;
+constexpr size_t kRingMask = kRingCapacity - 1;
+constexpr auto kWriterPeriod = std::chrono::milliseconds(10);
+
+enum class Phase : char
+{
+  Complete = 'X',
+  Instant = 'i',
+  ThreadName = 'M'
+};
+
+struct Event
+{
+  const char* name;
+  const char* category;
+  const char* argName;
+  int64_t argValue;
+  uint64_t tsNs;
+  uint64_t durNs;
+  uint32_t tid;
+  Phase phase;
+};
+
+// Bounded multi-producer queue (Vyukov): each cell's sequence says whether it is free for the producer at that
+// position or holds an event for the consumer. Producers claim a position with one CAS; the writer thread is the
+// only consumer.
+struct Cell
+{
+  std::atomic<uint64_t> sequence;
+  Event event;
+};
+
+class EventRing
+{
+public:
+  EventRing()
+  {
+    for (size_t i = 0; i < kRingCapacity; ++i)
+      mCells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool TryPush(const Event& event) noexcept
+  {
+    uint64_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell& cell = mCells[position & kRingMask];
+      const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<int64_t>(sequence - position);
+      if (diff == 0)
+      {
+        if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          cell.event = event;
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+        return false; // Full.
+      else
+        position = mEnqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Writer thread only.
+  bool TryPop(Event& event) noexcept
+  {
+    Cell& cell = mCells[mDequeuePosition & kRingMask];
+    const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != mDequeuePosition + 1)
+      return false;
+    event = cell.event;
+    cell.sequence.store(mDequeuePosition + kRingCapacity, std::memory_order_release);
+    ++mDequeuePosition;
+    return true;
+  }
+
+private:
+  std::array<Cell, kRingCapacity> mCells;
+  alignas(64) std::atomic<uint64_t> mEnqueuePosition{0};
+  alignas(64) uint64_t mDequeuePosition = 0;
+};
+
+// Namespace-scope so the ring is built at load time, never lazily on the audio thread.
+EventRing gRing;
+std::atomic<bool> gRunning{false};
+std::atomic<uint32_t> gGeneration{0};
+std::atomic<uint32_t> gNextThreadId{1};
+std::atomic<uint64_t> gDroppedEvents{0};
+
+std::mutex gControlMutex; // Start()/Stop() only.
+std::thread gWriter;
+std::FILE* gFile = nullptr;
+uint64_t gOriginNs = 0;
+
+uint32_t GetThreadId() noexcept
+{
+  thread_local const uint32_t tid = gNextThreadId.fetch_add(1, std::memory_order_relaxed);
+  return tid;
+}
+
+void Push(const Event& event) noexcept
+{
+  if (!gRing.TryPush(event))
+    gDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+double ToTraceMicroseconds(const uint64_t ns)
+{
+  return static_cast<double>(ns) * 1.0e-3;
+}
+
+void WriteEvent(const Event& event)
+{
+  // Events left in the ring by a previous session (or recorded while it was stopping) are discarded.
+  if (event.tsNs < gOriginNs)
+    return;
+
+  const double ts = ToTraceMicroseconds(event.tsNs - gOriginNs);
+  switch (event.phase)
+  {
+    case Phase::ThreadName:
+      std::fprintf(gFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                   event.tid, event.name);
+      return;
+    case Phase::Instant:
+      std::fprintf(gFile, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                   "\"pid\":1,\"tid\":%u",
+                   event.name, event.category, ts, event.tid);
+      break;
+    case Phase::Complete:
+      std::fprintf(gFile, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                   "\"pid\":1,\"tid\":%u",
+                   event.name, event.category, ts, ToTraceMicroseconds(event.durNs), event.tid);
+      break;
+  }
+  if (event.argName != nullptr)
+    std::fprintf(gFile, ",\"args\":{\"%s\":%lld}", event.argName, static_cast<long long>(event.argValue));
+  std::fputc('}', gFile);
+}
+
+void DrainRing()
+{
+  Event event;
+  while (gRing.TryPop(event))
+    WriteEvent(event);
+}
+
+void WriterLoop()
+{
+  while (gRunning.load(std::memory_order_acquire))
+  {
+    DrainRing();
+    std::fflush(gFile);
+    std::this_thread::sleep_for(kWriterPeriod);
+  }
+  DrainRing();
+}
+} // namespace
+
+bool Start(const char* path)
+{
+  std::lock_guard<std::mutex> lock(gControlMutex);
+  if (gRunning.load(std::memory_order_relaxed) || path == nullptr || path[0] == '\0')
+    return false;
+
+  gFile = std::fopen(path, "wb");
+  if (gFile == nullptr)
+    return false;
+
+  // The array is left open until Stop(); Perfetto and chrome://tracing also load it unterminated after a crash.
+  std::fputs("{\"traceEvents\":[\n"
+             "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"NeuralAmpModeler\"}}",
+             gFile);
+  gOriginNs = NowNs();
+  gDroppedEvents.store(0, std::memory_order_relaxed);
+  gGeneration.fetch_add(1, std::memory_order_relaxed);
+  gRunning.store(true, std::memory_order_release);
+  gWriter = std::thread(WriterLoop);
+  return true;
+}
+
+void Stop()
+{
+  std::lock_guard<std::mutex> lock(gControlMutex);
+  if (!gRunning.exchange(false, std::memory_order_acq_rel))
+    return;
+
+  if (gWriter.joinable())
+    gWriter.join();
+  std::fprintf(gFile, "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\"droppedEvents\":%llu}}\n",
+               static_cast<unsigned long long>(gDroppedEvents.load(std::memory_order_relaxed)));
+  std::fclose(gFile);
+  gFile = nullptr;
+}
+
+bool IsRunning() noexcept
+{
+  return gRunning.load(std::memory_order_relaxed);
+}
+
+uint64_t GetDroppedEventCount() noexcept
+{
+  return gDroppedEvents.load(std::memory_order_relaxed);
+}
+
+uint64_t NowNs() noexcept
+{
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void SetThreadName(const char* name) noexcept
+{
+  thread_local uint32_t namedGeneration = 0;
+  if (!IsRunning())
+    return;
+  const uint32_t generation = gGeneration.load(std::memory_order_relaxed);
+  if (namedGeneration == generation)
+    return;
+  namedGeneration = generation;
+  Push({name, nullptr, nullptr, 0, NowNs(), 0, GetThreadId(), Phase::ThreadName});
+}
+
+void RecordSpan(const char* name, const char* category, const uint64_t beginNs, const uint64_t endNs,
+                const char* argName, const int64_t argValue) noexcept
+{
+  if (!IsRunning())
+    return;
+  const uint64_t durNs = (endNs > beginNs) ? (endNs - beginNs) : 0;
+  Push({name, category, argName, argValue, beginNs, durNs, GetThreadId(), Phase::Complete});
+}
+
+void RecordInstant(const char* name, const char* category, const char* argName, const int64_t argValue) noexcept
+{
+  if (!IsRunning())
+    return;
+  Push({name, category, argName, argValue, NowNs(), 0, GetThreadId(), Phase::Instant});
+}
+} // namespace NAMTrace
+#endif
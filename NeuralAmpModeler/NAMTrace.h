@@ -0,0 +1,86 @@
+#pragma once
+
+// Timeline tracing (NAM_TRACE=1 builds only).
+//
+// Spans are pushed into a fixed-size lock-free ring by any thread (audio, model loader, UI) and drained by a writer
+// thread into a Chrome trace JSON file; open it in ui.perfetto.dev or chrome://tracing. Recording never allocates,
+// locks or touches the file, so it is safe on the audio thread. If the writer falls behind, new events are dropped and
+// counted rather than blocking the producer.
+//
+// Names, categories and argument names must be string literals (only the pointer is stored). In normal builds all
+// macros compile to nothing.
+
+#include <cstdint>
+
+#include "config.h"
+
+#if NAM_TRACE
+namespace NAMTrace
+{
+// Opens path and starts the writer thread. Returns false if tracing is already running or the file can't be opened.
+bool Start(const char* path);
+// Flushes what is left in the ring, closes the JSON array and joins the writer.
+void Stop();
+bool IsRunning() noexcept;
+uint64_t GetDroppedEventCount() noexcept;
+
+uint64_t NowNs() noexcept;
+// Labels the calling thread's track on the timeline. Cheap to call repeatedly; only the first call per thread records.
+void SetThreadName(const char* name) noexcept;
+// A complete span ("ph":"X"). argName == nullptr records no argument.
+void RecordSpan(const char* name, const char* category, uint64_t beginNs, uint64_t endNs,
+                const char* argName = nullptr, int64_t argValue = 0) noexcept;
+// A zero-length marker ("ph":"i") on the calling thread's track.
+void RecordInstant(const char* name, const char* category, const char* argName = nullptr,
+                   int64_t argValue = 0) noexcept;
+
+class ScopedSpan
+{
+public:
+  ScopedSpan(const char* name, const char* category, const char* argName = nullptr, const int64_t argValue = 0) noexcept
+  : mName(name)
+  , mCategory(category)
+  , mArgName(argName)
+  , mArgValue(argValue)
+  , mBeginNs(IsRunning() ? NowNs() : 0)
+  {
+  }
+  ~ScopedSpan() noexcept
+  {
+    if (mBeginNs != 0)
+      RecordSpan(mName, mCategory, mBeginNs, NowNs(), mArgName, mArgValue);
+  }
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+  // For arguments that are only known once the work is done (e.g. success).
+  void SetArg(const char* argName, const int64_t argValue) noexcept
+  {
+    mArgName = argName;
+    mArgValue = argValue;
+  }
+
+private:
+  const char* mName;
+  const char* mCategory;
+  const char* mArgName;
+  int64_t mArgValue;
+  uint64_t mBeginNs;
+};
+} // namespace NAMTrace
+
+  #define NAM_TRACE_CONCAT_INNER(a, b) a##b
+  #define NAM_TRACE_CONCAT(a, b) NAM_TRACE_CONCAT_INNER(a, b)
+  #define NAM_TRACE_SCOPE(name, category) \
+    NAMTrace::ScopedSpan NAM_TRACE_CONCAT(namTraceSpan, __LINE__)(name, category)
+  #define NAM_TRACE_SCOPE_ARG(name, category, argName, argValue)                                           \
+    NAMTrace::ScopedSpan NAM_TRACE_CONCAT(namTraceSpan, __LINE__)(                                          \
+      name, category, argName, static_cast<int64_t>(argValue))
+  #define NAM_TRACE_INSTANT(name, category) NAMTrace::RecordInstant(name, category)
+  #define NAM_TRACE_THREAD_NAME(name) NAMTrace::SetThreadName(name)
+#else
+  #define NAM_TRACE_SCOPE(name, category) ((void)0)
+  #define NAM_TRACE_SCOPE_ARG(name, category, argName, argValue) ((void)0)
+  #define NAM_TRACE_INSTANT(name, category) ((void)0)
+  #define NAM_TRACE_THREAD_NAME(name) ((void)0)
+#endif
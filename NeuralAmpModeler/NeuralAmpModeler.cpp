@@ -3,41 +3,75 @@
 #include <cctype>
 #include <cmath> // pow
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring> // strcmp
+#include <ctime>
 #include <filesystem>
 #include <functional>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <random>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 
+#if IPLUG_EDITOR
 #include "Colors.h"
+#endif
 #include "../NeuralAmpModelerCore/NAM/activations.h"
 #include "../NeuralAmpModelerCore/NAM/get_dsp.h"
 #include "../NeuralAmpModelerCore/NAM/slimmable.h"
+#if __has_include("../NeuralAmpModelerCore/NAM/version.h")
+#include "../NeuralAmpModelerCore/NAM/version.h"
+#endif
 // clang-format off
 // These includes need to happen in this order or else the latter won't know
 // a bunch of stuff.
 #include "NeuralAmpModeler.h"
+#if defined(HEADLESS_API)
+#include "headless/IPlugHeadless_include_in_plug_src.h"
+#else
 #include "IPlug_include_in_plug_src.h"
+#endif
 #include "IPlugPaths.h"
 // clang-format on
 #include "architecture.hpp"
 
 #include "EmbeddedCabIRAssets.h"
 #include "EmbeddedModelAssets.h"
+#include "EmbeddedModelConfig.h"
+#include "NAMTrace.h"
+#include "NpyWeights.h"
+#include "RTSanitizer.h"
+#include "StartupProfile.h"
+#if IPLUG_EDITOR
 #include "NeuralAmpModelerControls.h"
 #include "IPopupMenuControl.h"
+#endif
 #if defined(APP_API) && defined(OS_WIN)
 #include "resources/resource.h"
 #include <windows.h>
 #endif
-#if NAM_DEV_DIAGNOSTICS && defined(APP_API) && defined(_WIN32)
+#if defined(_WIN32)
+// Process memory counters: dev diagnostics overlay and the headless model zoo (GetHeapBytesInUse()).
+#include <windows.h>
 #include <psapi.h>
 #pragma comment(lib, "Psapi.lib")
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if !defined(_WIN32)
+// MappedFile: read-only mappings of model weights and compiled model cache files.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #if __has_include("third_party/rubberband/single/RubberBandSingle.cpp")
@@ -46,11 +80,37 @@
 #endif
 
 using namespace iplug;
+#if IPLUG_EDITOR
 using namespace igraphics;
+#endif
 
 const double kDCBlockerFrequency = 5.0;
 constexpr double kPi = 3.14159265358979323846;
 
+size_t GetHeapBytesInUse()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS_EX memoryCounters = {};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memoryCounters),
+                           sizeof(memoryCounters)))
+    return static_cast<size_t>(memoryCounters.PrivateUsage);
+  return 0;
+#elif defined(__APPLE__)
+  malloc_statistics_t stats = {};
+  malloc_zone_statistics(nullptr, &stats);
+  return stats.size_in_use;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+  const struct mallinfo info = mallinfo();
+  return static_cast<size_t>(static_cast<unsigned int>(info.uordblks))
+         + static_cast<size_t>(static_cast<unsigned int>(info.hblkhd));
+#else
+  return 0;
+#endif
+}
+
 namespace
 {
 constexpr int kAmpSlotSwitchDeClickSamples = 512;
@@ -91,6 +151,9 @@ constexpr std::streamoff kMaxStandaloneStateBytes = 16 * 1024 * 1024;
 constexpr const char* kStandaloneStateFileHeader = "###NAMStandaloneState###";
 constexpr int32_t kStandaloneStateFileVersion = 1;
 #endif
+constexpr const char* kMachineSettingsFileName = "machine-settings.bin";
+constexpr const char* kMachineSettingsFileHeader = "###NAMMachineSettings###";
+constexpr int32_t kMachineSettingsFileVersion = 1;
 constexpr double kEffectiveMonoMaxPeakDiff = 3.0e-5;
 constexpr double kEffectiveMonoMaxRelativeDiff = 1.0e-7;
 constexpr double kEffectiveMonoSilenceMidEnergy = 1.0e-14;
@@ -101,6 +164,8 @@ constexpr double kStereoSideBypassSilenceEnergy = 1.0e-14;
 constexpr double kStereoSideBypassEngageSeconds = 0.08;
 constexpr double kStereoSideBypassReleaseSeconds = 0.03;
 constexpr int kStereoSideBypassResumeDeClickSamples = 64;
+// Below this the fork-join hand-off costs about what running the right model on a pool worker saves.
+constexpr int kStereoForkJoinMinFrames = 32;
 constexpr int kMeterChannelCount = 2;
 constexpr size_t kMinInternalPreparedFrames = 16384;
 constexpr std::array<const char*, 6> kReleaseAmpAssetTokens = {"Amp1A", "Amp1B", "Amp2A", "Amp2B", "Amp3A", "Amp3B"};
@@ -215,6 +280,35 @@ uint64_t FileTimeToUInt64(const FILETIME& fileTime)
 #endif
 #endif
 
+#if NAM_DEV_DIAGNOSTICS
+  // Closes the current ProcessBlock() section; see DevDiagnosticsStage.
+  #define NAM_DEV_DIAGNOSTICS_MARK_STAGE(stage) \
+    devDiagnosticsStageLaps.Mark(DevDiagnosticsStage::stage, GetSteadyClockNowNs())
+#else
+  #define NAM_DEV_DIAGNOSTICS_MARK_STAGE(stage) ((void)0)
+#endif
+
+#if NAM_DEV_DIAGNOSTICS || NAM_TRACE
+// "<desktop>/<prefix>-YYYYmmdd-HHMMSS<extension>", or empty if there is no desktop folder.
+std::string MakeTimestampedDesktopPath(const char* prefix, const char* extension)
+{
+  WDL_String directory;
+  DesktopPath(directory);
+  if (directory.GetLength() == 0)
+    return {};
+  const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm localTime = {};
+#if defined(_WIN32)
+  localtime_s(&localTime, &now);
+#else
+  localtime_r(&now, &localTime);
+#endif
+  std::ostringstream fileName;
+  fileName << prefix << "-" << std::put_time(&localTime, "%Y%m%d-%H%M%S") << extension;
+  return (std::filesystem::u8path(directory.Get()) / fileName.str()).string();
+}
+#endif
+
 int GetCabSlotFileBrowserCtrlTag(const int slotIndex)
 {
   return (slotIndex == 0) ? kCtrlTagIRFileBrowserLeft : kCtrlTagIRFileBrowserRight;
@@ -343,60 +437,701 @@ const embedded_model::EmbeddedModelAsset* GetEmbeddedModelAssetForPath(const WDL
   return nullptr;
 }
 
-std::unique_ptr<nam::DSP> LoadNAMDSPForPath(const WDL_String& modelPath)
+// Process-wide table of model sources (NAMModelSource), shared by every plug-in instance: 20 instances loading the same
+// amp, together or one after another, parse it once. Keyed by model identity: the path for embedded models, path +
+// content hash for files so an edited file is parsed again. Concurrent loads of the same model wait for a single
+// parse. The table holds each source, and every model built from it holds a reference too (ResamplingNAM::
+// SetModelSource()); once the table's is the only one left, the next Acquire() frees the source on its loader thread,
+// so the audio thread dropping a model never frees a source. Each instance still builds its own nam::DSP: the core
+// copies the weights into its layers and has no constructor that borrows them.
+class NAMModelRegistry
 {
-  auto applyConfiguredSlimmableSize = [](std::unique_ptr<nam::DSP>& model) {
-    if (auto* slimmable = dynamic_cast<nam::SlimmableModel*>(model.get()))
-      slimmable->SetSlimmableSize(std::clamp(NAMConfig::SlimmableSize, 0.0, 1.0));
+public:
+  static NAMModelRegistry& Get()
+  {
+    static NAMModelRegistry registry;
+    return registry;
+  }
+
+  template <typename ParseFunc>
+  SharedNAMModelSource Acquire(const std::string& key, ParseFunc&& parse)
+  {
+    std::promise<SharedNAMModelSource> promise;
+    std::shared_future<SharedNAMModelSource> inFlight;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      _PruneUnused(key);
+      Entry& entry = mEntries[key];
+      if (SharedNAMModelSource source = entry.source)
+      {
+        NAM_TRACE_INSTANT("model-config-shared", "loader");
+        return source;
+      }
+      if (entry.inFlight.valid())
+        inFlight = entry.inFlight;
+      else
+        entry.inFlight = promise.get_future().share();
+    }
+    if (inFlight.valid())
+      return inFlight.get(); // Rethrows if the other parse failed.
+
+    try
+    {
+      SharedNAMModelSource source = std::make_shared<const NAMModelSource>(parse());
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Entry& entry = mEntries[key];
+        entry.source = source;
+        entry.inFlight = {};
+      }
+      promise.set_value(source);
+      return source;
+    }
+    catch (...)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.erase(key);
+      }
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+private:
+  struct Entry
+  {
+    SharedNAMModelSource source;
+    std::shared_future<SharedNAMModelSource> inFlight;
   };
 
+  // Under mMutex, so a use count of 1 is the table's own reference: no other one can be taken without the lock.
+  void _PruneUnused(const std::string& keepKey)
+  {
+    for (auto it = mEntries.begin(); it != mEntries.end();)
+    {
+      if (it->first != keepKey && !it->second.inFlight.valid()
+          && (it->second.source == nullptr || it->second.source.use_count() == 1))
+        it = mEntries.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, Entry> mEntries;
+};
+
+constexpr uint64_t kModelHashSeed = 14695981039346656037ull;
+
+uint64_t HashModelFileContents(const char* data, const size_t size, uint64_t hash = kModelHashSeed)
+{
+  // FNV-1a; only has to tell edited files apart.
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string ReadModelFile(const std::filesystem::path& path)
+{
+  NAM_TRACE_SCOPE("read-model-file", "loader");
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("Failed to open model file " + path.u8string());
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Read-only mapping of a whole file, so weights can be read from the page cache without a heap copy of the file.
+// Invalid (GetData() == nullptr) if the file can't be opened or is empty.
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::filesystem::path& path)
+  {
+#if defined(_WIN32)
+    mFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+      return;
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart <= 0)
+      return;
+    mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr)
+      return;
+    mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData != nullptr)
+      mSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+      void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+      {
+        mData = static_cast<const char*>(data);
+        mSize = static_cast<size_t>(fileStat.st_size);
+      }
+    }
+    close(fd); // The mapping keeps the file referenced.
+#endif
+  }
+
+  ~MappedFile()
+  {
+#if defined(_WIN32)
+    if (mData != nullptr)
+      UnmapViewOfFile(mData);
+    if (mMapping != nullptr)
+      CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE)
+      CloseHandle(mFile);
+#else
+    if (mData != nullptr)
+      munmap(const_cast<char*>(mData), mSize);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* GetData() const { return mData; }
+  size_t GetSize() const { return mSize; }
+
+private:
+#if defined(_WIN32)
+  HANDLE mFile = INVALID_HANDLE_VALUE;
+  HANDLE mMapping = nullptr;
+#endif
+  const char* mData = nullptr;
+  size_t mSize = 0;
+};
+
+// weights.npy as floats, read straight from the mapping: the only heap copy of the weights is the one the model source
+// keeps.
+std::vector<float> ReadNpyWeights(const MappedFile& npyFile, const std::string& name)
+{
+  const npy::WeightsView view = npy::ParseWeights(npyFile.GetData(), npyFile.GetSize(), name);
+  NAM_TRACE_SCOPE("npy-weights", "loader");
+  std::vector<float> weights(view.count);
+  for (size_t i = 0; i < view.count; ++i)
+    weights[i] = view[i];
+  return weights;
+}
+
+nlohmann::json ParseNAMConfig(const char* jsonBegin, const char* jsonEnd)
+{
+  NAM_TRACE_SCOPE_ARG("json-parse", "loader", "bytes", static_cast<size_t>(jsonEnd - jsonBegin));
+  NAM_STARTUP_PROFILE_SCOPE(JsonParse);
+  return nlohmann::json::parse(jsonBegin, jsonEnd);
+}
+
+// Splits a parsed .nam config into a NAMModelSource: the top-level weights leave the json as floats.
+NAMModelSource MakeNAMModelSource(nlohmann::json model)
+{
+  NAMModelSource source;
+  const auto weights = model.find("weights");
+  if (weights != model.end())
+  {
+    source.weights = weights->get<std::vector<float>>();
+    model.erase(weights);
+  }
+  source.model = std::move(model);
+  return source;
+}
+
+// Embedded models store their weight arrays as float32 next to a config with those arrays emptied (see
+// tools/generate_embedded_model_assets.py), so only the few KB of config go through the JSON parser, and the model's
+// own weights go straight from the asset into the source.
+NAMModelSource BuildEmbeddedNAMModelSource(const embedded_model::EmbeddedModelAsset& asset)
+{
+  NAMModelSource source;
+  source.model = ParseNAMConfig(asset.json, asset.json + asset.jsonSize);
+  NAM_TRACE_SCOPE("embedded-weights", "loader");
+  embedded_model::InsertWeightArrays(asset, source.model, &source.weights);
+  return source;
+}
+
+#if NAM_MODEL_CACHE
+// Compiled model cache: user .nam files, stored as the config with its weight arrays split out as float32 (the same
+// split as the embedded models), so a cache hit parses a few KB of JSON instead of ~300 KB of float text. Files are
+// named after the source content hash, the loader key and the cache format version, and are validated against all
+// three on every read; anything unreadable is ignored and rewritten. Layout (native byte order, checked with
+// kModelCacheByteOrderMark):
+//   ModelCacheHeader | config JSON | numArrays x (offset u64, count u64, pointer length u32, pointer) | pad | floats
+// The float block starts 16-byte aligned so the file can be mapped as-is.
+constexpr char kModelCacheMagic[4] = {'N', 'A', 'M', 'C'};
+constexpr uint32_t kModelCacheFormatVersion = 2;
+constexpr uint32_t kModelCacheByteOrderMark = 0x01020304u;
+// Bump when the plug-in changes how it turns a .nam file into the config it builds from.
+constexpr uint32_t kModelCacheLoaderVersion = 1;
+
+struct ModelCacheHeader
+{
+  char magic[4];
+  uint32_t formatVersion;
+  uint32_t byteOrderMark;
+  uint32_t numArrays;
+  uint64_t sourceHash;
+  uint64_t sourceSize;
+  uint64_t loaderKey;
+  uint64_t configSize;
+  uint64_t weightsOffset;
+  uint64_t numWeights;
+};
+
+struct ModelCacheWeightArray
+{
+  std::string jsonPointer;
+  uint64_t offset = 0;
+  uint64_t count = 0;
+};
+
+// $NAM_MODEL_CACHE_DIR if set (empty disables the cache), else the per-user cache directory.
+std::filesystem::path GetModelCacheDirectoryPath()
+{
+  if (const char* overrideDir = std::getenv("NAM_MODEL_CACHE_DIR"))
+    return std::filesystem::u8path(overrideDir);
+#if defined(_WIN32)
+  const char* localAppData = std::getenv("LOCALAPPDATA");
+  if (localAppData == nullptr || localAppData[0] == '\0')
+    return {};
+  return std::filesystem::path(localAppData) / BUNDLE_NAME / "ModelCache";
+#else
+  const char* home = std::getenv("HOME");
+  if (home == nullptr || home[0] == '\0')
+    return {};
+  #if defined(OS_MAC)
+  return std::filesystem::path(home) / "Library" / "Caches" / BUNDLE_NAME / "ModelCache";
+  #else
+  const char* xdgCache = std::getenv("XDG_CACHE_HOME");
+  if (xdgCache != nullptr && xdgCache[0] != '\0')
+    return std::filesystem::path(xdgCache) / BUNDLE_NAME / "model-cache";
+  return std::filesystem::path(home) / ".cache" / BUNDLE_NAME / "model-cache";
+  #endif
+#endif
+}
+
+// Identifies the code that built a cache entry: the plug-in's loader version and release, and the NAM core release.
+// Entries from any other build are never read, so a loader or core update can't serve stale compiled models.
+uint64_t GetModelCacheLoaderKey()
+{
+  std::string key = std::to_string(kModelCacheLoaderVersion) + "/" PLUG_VERSION_STR;
+#if defined(NEURAL_AMP_MODELER_DSP_VERSION_MAJOR)
+  key += "/core-" + std::to_string(NEURAL_AMP_MODELER_DSP_VERSION_MAJOR) + "."
+         + std::to_string(NEURAL_AMP_MODELER_DSP_VERSION_MINOR) + "."
+         + std::to_string(NEURAL_AMP_MODELER_DSP_VERSION_PATCH);
+#endif
+  return HashModelFileContents(key.data(), key.size());
+}
+
+std::filesystem::path GetModelCacheFilePath(const uint64_t sourceHash)
+{
+  const std::filesystem::path cacheDir = GetModelCacheDirectoryPath();
+  if (cacheDir.empty())
+    return {};
+  char fileName[64];
+  std::snprintf(fileName, sizeof(fileName), "%016llx-%016llx-v%u.namc", static_cast<unsigned long long>(sourceHash),
+                static_cast<unsigned long long>(GetModelCacheLoaderKey()), kModelCacheFormatVersion);
+  return cacheDir / fileName;
+}
+
+// Moves every non-empty numeric "weights" array out of config, leaving an empty array in its place.
+void SplitNAMConfigWeights(nlohmann::json& config, const nlohmann::json::json_pointer& pointer,
+                           std::vector<ModelCacheWeightArray>& arrays, std::vector<float>& weights)
+{
+  if (config.is_object())
+  {
+    for (auto it = config.begin(); it != config.end(); ++it)
+    {
+      nlohmann::json& value = it.value();
+      if (it.key() == "weights" && value.is_array() && !value.empty()
+          && std::all_of(value.begin(), value.end(), [](const nlohmann::json& v) { return v.is_number(); }))
+      {
+        weights.resize((weights.size() + 3) & ~size_t(3), 0.0f); // 16-byte aligned arrays
+        arrays.push_back({(pointer / it.key()).to_string(), weights.size(), value.size()});
+        for (const auto& v : value)
+          weights.push_back(v.get<float>());
+        value = nlohmann::json::array();
+      }
+      else
+        SplitNAMConfigWeights(value, pointer / it.key(), arrays, weights);
+    }
+  }
+  else if (config.is_array())
+  {
+    for (size_t i = 0; i < config.size(); ++i)
+      SplitNAMConfigWeights(config[i], pointer / i, arrays, weights);
+  }
+}
+
+// The top-level "/weights" array goes into source.weights; any others (container submodels) back into the json.
+bool ReadModelCache(const std::filesystem::path& cachePath, const uint64_t sourceHash, const uint64_t sourceSize,
+                    NAMModelSource& source)
+{
+  NAM_TRACE_SCOPE("model-cache-read", "loader");
+  const MappedFile mappedFile(cachePath);
+  const char* data = mappedFile.GetData();
+  const size_t size = mappedFile.GetSize();
+
+  ModelCacheHeader header;
+  if (data == nullptr || size < sizeof(header))
+    return false;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, kModelCacheMagic, sizeof(header.magic)) != 0
+      || header.formatVersion != kModelCacheFormatVersion || header.byteOrderMark != kModelCacheByteOrderMark
+      || header.sourceHash != sourceHash || header.sourceSize != sourceSize
+      || header.loaderKey != GetModelCacheLoaderKey() || header.weightsOffset > size || header.weightsOffset % 16 != 0
+      || header.numWeights > (size - header.weightsOffset) / sizeof(float))
+    return false;
+
+  // Config and array table must end at or before the float block; the checks below only ever add to pos, so nothing
+  // can wrap around and read past the mapping.
+  size_t pos = sizeof(header);
+  if (header.configSize > header.weightsOffset || pos + header.configSize > header.weightsOffset)
+    return false;
+  nlohmann::json& config = source.model;
+  config = ParseNAMConfig(data + pos, data + pos + header.configSize);
+  pos += header.configSize;
+
+  const char* weights = data + header.weightsOffset;
+  for (uint32_t i = 0; i < header.numArrays; ++i)
+  {
+    uint64_t offset = 0;
+    uint64_t count = 0;
+    uint32_t pointerLength = 0;
+    if (pos + sizeof(offset) + sizeof(count) + sizeof(pointerLength) > header.weightsOffset)
+      return false;
+    std::memcpy(&offset, data + pos, sizeof(offset));
+    std::memcpy(&count, data + pos + sizeof(offset), sizeof(count));
+    std::memcpy(&pointerLength, data + pos + sizeof(offset) + sizeof(count), sizeof(pointerLength));
+    pos += sizeof(offset) + sizeof(count) + sizeof(pointerLength);
+    if (pos + pointerLength > header.weightsOffset || offset > header.numWeights || count > header.numWeights - offset)
+      return false;
+    const std::string pointer(data + pos, pointerLength);
+    pos += pointerLength;
+    std::vector<float> values(static_cast<size_t>(count));
+    std::memcpy(values.data(), weights + offset * sizeof(float), values.size() * sizeof(float));
+    if (pointer == "/weights")
+      source.weights = std::move(values);
+    else
+      config.at(nlohmann::json::json_pointer(pointer)) = std::move(values);
+  }
+  config.erase("weights");
+  return true;
+}
+
+// <cache file>.tmp-<pid>-<random>: unique across the threads and processes (other plug-in hosts) sharing the cache
+// directory.
+std::filesystem::path GetModelCacheTempPath(const std::filesystem::path& cachePath)
+{
+#if defined(_WIN32)
+  const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+  const auto pid = static_cast<unsigned long>(getpid());
+#endif
+  std::random_device random;
+  char suffix[48];
+  std::snprintf(suffix, sizeof(suffix), ".tmp-%lu-%08x%08x", pid, random(), random());
+  std::filesystem::path tempPath = cachePath;
+  tempPath += suffix;
+  return tempPath;
+}
+
+// Best effort: a cache that can't be written just means the next load parses the file again.
+void WriteModelCache(const std::filesystem::path& cachePath, const uint64_t sourceHash, const uint64_t sourceSize,
+                     nlohmann::json config)
+{
+  NAM_TRACE_SCOPE("model-cache-write", "loader");
+  std::vector<ModelCacheWeightArray> arrays;
+  std::vector<float> weights;
+  SplitNAMConfigWeights(config, nlohmann::json::json_pointer(), arrays, weights);
+  const std::string configText = config.dump();
+
+  std::string table;
+  for (const auto& array : arrays)
+  {
+    const auto pointerLength = static_cast<uint32_t>(array.jsonPointer.size());
+    table.append(reinterpret_cast<const char*>(&array.offset), sizeof(array.offset));
+    table.append(reinterpret_cast<const char*>(&array.count), sizeof(array.count));
+    table.append(reinterpret_cast<const char*>(&pointerLength), sizeof(pointerLength));
+    table.append(array.jsonPointer);
+  }
+
+  ModelCacheHeader header;
+  std::memcpy(header.magic, kModelCacheMagic, sizeof(header.magic));
+  header.formatVersion = kModelCacheFormatVersion;
+  header.byteOrderMark = kModelCacheByteOrderMark;
+  header.numArrays = static_cast<uint32_t>(arrays.size());
+  header.sourceHash = sourceHash;
+  header.sourceSize = sourceSize;
+  header.loaderKey = GetModelCacheLoaderKey();
+  header.configSize = configText.size();
+  header.weightsOffset = (sizeof(header) + configText.size() + table.size() + 15) & ~uint64_t(15);
+  header.numWeights = weights.size();
+
+  std::error_code error;
+  std::filesystem::create_directories(cachePath.parent_path(), error);
+  // Written under a unique name and renamed into place, so concurrent loads never see a partial file.
+  const std::filesystem::path tempPath = GetModelCacheTempPath(cachePath);
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return;
+    const std::string padding(
+      static_cast<size_t>(header.weightsOffset - (sizeof(header) + configText.size() + table.size())), '\0');
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(configText.data(), static_cast<std::streamsize>(configText.size()));
+    file.write(table.data(), static_cast<std::streamsize>(table.size()));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(reinterpret_cast<const char*>(weights.data()),
+               static_cast<std::streamsize>(weights.size() * sizeof(float)));
+    if (!file)
+    {
+      file.close();
+      std::filesystem::remove(tempPath, error);
+      return;
+    }
+  }
+  std::filesystem::rename(tempPath, cachePath, error);
+  if (error)
+    std::filesystem::remove(tempPath, error);
+}
+#endif
+
+// A user .nam file's model source: from the compiled model cache when it holds this exact file, else parsed (and
+// cached).
+NAMModelSource LoadNAMFileModelSource(const std::string& fileContents, const uint64_t sourceHash)
+{
+#if NAM_MODEL_CACHE
+  const std::filesystem::path cachePath = GetModelCacheFilePath(sourceHash);
+  if (!cachePath.empty())
+  {
+    try
+    {
+      NAMModelSource source;
+      if (ReadModelCache(cachePath, sourceHash, fileContents.size(), source))
+        return source;
+    }
+    catch (const std::exception&)
+    {
+      // Corrupt cache entry; fall through and overwrite it.
+    }
+    nlohmann::json config = ParseNAMConfig(fileContents.data(), fileContents.data() + fileContents.size());
+    try
+    {
+      WriteModelCache(cachePath, sourceHash, fileContents.size(), config);
+    }
+    catch (const std::exception&)
+    {
+    }
+    return MakeNAMModelSource(std::move(config));
+  }
+#endif
+  (void) sourceHash;
+  return MakeNAMModelSource(ParseNAMConfig(fileContents.data(), fileContents.data() + fileContents.size()));
+}
+
+// Legacy export directory: config.json plus the weights in weights.npy, which is mapped rather than read into a heap
+// buffer. The config keeps its own version, so exports older than get_dsp() accepts fail to load like any other
+// unsupported model.
+SharedNAMModelSource LoadLegacyNAMDirectoryModelSource(const WDL_String& modelPath,
+                                                       const std::filesystem::path& directory)
+{
+  const std::string configText = ReadModelFile(directory / "config.json");
+  const MappedFile weightsFile(directory / "weights.npy");
+  if (weightsFile.GetData() == nullptr)
+    throw std::runtime_error("Failed to map " + (directory / "weights.npy").u8string());
+  const uint64_t sourceHash = HashModelFileContents(
+    weightsFile.GetData(), weightsFile.GetSize(), HashModelFileContents(configText.data(), configText.size()));
+  const std::string key = std::string(modelPath.Get()) + "#" + std::to_string(sourceHash);
+  return NAMModelRegistry::Get().Acquire(key, [&]() {
+    NAMModelSource source =
+      MakeNAMModelSource(ParseNAMConfig(configText.data(), configText.data() + configText.size()));
+    source.weights = ReadNpyWeights(weightsFile, (directory / "weights.npy").u8string());
+    return source;
+  });
+}
+
+// Model source for a path, from NAMModelRegistry. The stereo core builds its left and right instances from it, and
+// other plug-in instances loading the same model at the same time reuse it.
+SharedNAMModelSource LoadNAMModelSourceForPath(const WDL_String& modelPath)
+{
   if (const auto* embeddedAsset = GetEmbeddedModelAssetForPath(modelPath))
   {
-    const char* jsonBegin = embeddedAsset->json;
-    const char* jsonEnd = embeddedAsset->json + embeddedAsset->jsonSize;
-    const nlohmann::json config = nlohmann::json::parse(jsonBegin, jsonEnd);
-    auto model = nam::get_dsp(config);
-    applyConfiguredSlimmableSize(model);
-    return model;
+    return NAMModelRegistry::Get().Acquire(modelPath.Get(),
+                                           [embeddedAsset]() { return BuildEmbeddedNAMModelSource(*embeddedAsset); });
+  }
+
+  const std::filesystem::path filePath = std::filesystem::u8path(modelPath.Get());
+  std::error_code error;
+  if (std::filesystem::is_directory(filePath, error))
+    return LoadLegacyNAMDirectoryModelSource(modelPath, filePath);
+
+  const std::string fileContents = ReadModelFile(filePath);
+  const uint64_t sourceHash = HashModelFileContents(fileContents.data(), fileContents.size());
+  const std::string key = std::string(modelPath.Get()) + "#" + std::to_string(sourceHash);
+  return NAMModelRegistry::Get().Acquire(
+    key, [&fileContents, sourceHash]() { return LoadNAMFileModelSource(fileContents, sourceHash); });
+}
+
+// Frames a (sub)model looks back over, from its config; 0 where the architecture keeps no input history.
+size_t GetNAMConfigHistoryFrames(const nlohmann::json& config, const std::string& architecture)
+{
+  if (architecture == "Linear")
+    return config.value("receptive_field", size_t(0));
+  if (architecture == "ConvNet")
+  {
+    size_t frames = 0;
+    if (config.contains("dilations"))
+      for (const auto& dilation : config.at("dilations"))
+        frames += dilation.get<size_t>();
+    return frames;
+  }
+  return 0;
+}
+
+// Floats a WaveNet layer array keeps per layer: the dilated conv's input history plus the block-sized conv, activation,
+// 1x1 and head outputs.
+size_t EstimateWaveNetBufferFloats(const nlohmann::json& config, const size_t blockFrames)
+{
+  size_t floats = 0;
+  if (!config.contains("layers"))
+    return floats;
+  for (const auto& layer : config.at("layers"))
+  {
+    const size_t channels = layer.value("channels", size_t(0));
+    if (!layer.contains("dilations"))
+      continue;
+    const auto& dilations = layer.at("dilations");
+    for (size_t d = 0; d < dilations.size(); ++d)
+    {
+      size_t kernelSize = layer.value("kernel_size", size_t(0));
+      if (layer.contains("kernel_sizes") && d < layer.at("kernel_sizes").size())
+        kernelSize = layer.at("kernel_sizes").at(d).get<size_t>();
+      const size_t history = dilations.at(d).get<size_t>() * (kernelSize > 0 ? kernelSize - 1 : 0);
+      floats += channels * (history + blockFrames) + 4 * channels * blockFrames;
+    }
   }
+  return floats;
+}
 
-  auto model = nam::get_dsp(std::filesystem::u8path(modelPath.Get()));
-  applyConfiguredSlimmableSize(model);
-  return model;
+// Weights and buffers of a model (and, for containers, all its submodels) built from model: every weight as a float,
+// plus the layer buffers the core sizes for blockFrames at the model's own rate. The buffer part is an estimate from
+// the architecture config; the core doesn't report its allocations. Weights moved out into a NAMModelSource are
+// counted by the caller.
+size_t EstimateNAMModelBytes(const nlohmann::json& model, const size_t blockFrames)
+{
+  size_t floats = model.contains("weights") ? model.at("weights").size() : 0;
+  const std::string architecture = model.value("architecture", std::string());
+  if (model.contains("config"))
+  {
+    const auto& config = model.at("config");
+    if (config.contains("submodels"))
+    {
+      size_t bytes = floats * sizeof(float);
+      for (const auto& submodel : config.at("submodels"))
+        if (submodel.contains("model"))
+          bytes += EstimateNAMModelBytes(submodel.at("model"), blockFrames);
+      return bytes;
+    }
+    if (architecture == "WaveNet")
+      floats += EstimateWaveNetBufferFloats(config, blockFrames);
+    else if (architecture == "LSTM")
+      floats += config.value("num_layers", size_t(1)) * 8 * config.value("hidden_size", size_t(0)) + blockFrames;
+    else
+      floats += GetNAMConfigHistoryFrames(config, architecture) + 2 * blockFrames;
+  }
+  return floats * sizeof(float);
+}
+
+// nam::get_dsp() through nam::dspData, with the source's float weights: the same fields get_dsp() reads from a .nam
+// json, without putting the weights through a json array.
+std::unique_ptr<nam::DSP> GetNAMDSP(const NAMModelSource& source)
+{
+  const nlohmann::json& model = source.model;
+  nam::dspData data;
+  data.version = model.at("version").get<std::string>();
+  data.architecture = model.at("architecture").get<std::string>();
+  data.config = model.at("config");
+  data.metadata = model.contains("metadata") ? model.at("metadata") : nlohmann::json();
+  data.weights = source.weights; // get_dsp() takes the data by non-const reference.
+  data.expected_sample_rate = model.contains("sample_rate") ? model.at("sample_rate").get<double>() : -1.0;
+  return nam::get_dsp(data);
 }
 
-std::unique_ptr<ResamplingNAM> LoadResampledNAMForPath(const WDL_String& modelPath, const double sampleRate, const int blockSize)
+std::unique_ptr<ResamplingNAM> BuildResampledNAM(const NAMModelSource& source, const double sampleRate,
+                                                 const int blockSize, const double slimmableSize)
 {
-  std::unique_ptr<nam::DSP> model = LoadNAMDSPForPath(modelPath);
+  std::unique_ptr<nam::DSP> model;
+  {
+    NAM_TRACE_SCOPE("get_dsp", "loader");
+    NAM_STARTUP_PROFILE_SCOPE(GetDsp);
+    model = GetNAMDSP(source);
+  }
   if (model->NumInputChannels() != 1)
     throw std::runtime_error("Model must have 1 input channel, but has " + std::to_string(model->NumInputChannels()));
   if (model->NumOutputChannels() != 1)
     throw std::runtime_error("Model must have 1 output channel, but has " + std::to_string(model->NumOutputChannels()));
 
-  std::unique_ptr<ResamplingNAM> temp = std::make_unique<ResamplingNAM>(std::move(model), sampleRate);
-  temp->Reset(sampleRate, blockSize);
+  std::unique_ptr<ResamplingNAM> temp;
+  {
+    NAM_TRACE_SCOPE_ARG("ResetAndPrewarm", "loader", "blockSize", blockSize);
+    temp = std::make_unique<ResamplingNAM>(std::move(model), sampleRate, blockSize, slimmableSize);
+  }
+  // The resampler keeps about two blocks of history each way at the host rate.
+  const double modelRate = temp->GetEncapsulatedSampleRate();
+  const bool resampling = modelRate > 0.0 && modelRate != sampleRate;
+  const auto modelBlockFrames = static_cast<size_t>(
+    std::ceil(static_cast<double>(std::max(blockSize, 1)) * (resampling ? modelRate / sampleRate : 1.0)));
+  const size_t resamplerBytes = resampling ? 4 * static_cast<size_t>(std::max(blockSize, 1)) * sizeof(float) : 0;
+  temp->SetMemoryFootprintBytes(sizeof(ResamplingNAM) + source.weights.size() * sizeof(float)
+                                + EstimateNAMModelBytes(source.model, modelBlockFrames) + resamplerBytes);
   return temp;
 }
 
+// Left and right stereo-core instances of one model, built from one shared source; each instance still gets its own
+// layer buffers, resampler history and prewarmed state. Both hold the source, which keeps it in NAMModelRegistry. The
+// built weights are still one copy per instance: see "Blocked on the NAM core" in FUTURE_PLAN.md.
+void LoadResampledNAMPairForPath(const WDL_String& modelPath, const double sampleRate, const int blockSize,
+                                 const double slimmableSize, std::unique_ptr<ResamplingNAM>& model,
+                                 std::unique_ptr<ResamplingNAM>& modelRight)
+{
+  const SharedNAMModelSource source = LoadNAMModelSourceForPath(modelPath);
+  model = BuildResampledNAM(*source, sampleRate, blockSize, slimmableSize);
+  modelRight = BuildResampledNAM(*source, sampleRate, blockSize, slimmableSize);
+  model->SetModelSource(source);
+  modelRight->SetModelSource(source);
+}
+
 bool StageEmbeddedCuratedCabIR(const WDL_String& irPath, const double sampleRate,
-                               std::unique_ptr<dsp::ImpulseResponse>& stagedIR,
-                               std::unique_ptr<dsp::ImpulseResponse>& stagedIRChannel2,
+                               std::unique_ptr<AccountedImpulseResponse>& stagedIR,
+                               std::unique_ptr<AccountedImpulseResponse>& stagedIRChannel2,
                                dsp::wav::LoadReturnCode& wavState)
 {
   const auto* asset = GetEmbeddedCuratedCabIRAssetForPath(irPath);
   if (asset == nullptr)
     return false;
 
+  NAM_STARTUP_PROFILE_SCOPE(IRLoad);
   dsp::ImpulseResponse::IRData irData;
   irData.mRawAudio.assign(asset->samples, asset->samples + asset->numSamples);
   irData.mRawAudioSampleRate = asset->sampleRate;
 
-  auto primaryIR = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+  auto primaryIR = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
   wavState = primaryIR->GetWavState();
   if (wavState != dsp::wav::LoadReturnCode::SUCCESS)
     return true;
 
-  auto channel2IR = std::make_unique<dsp::ImpulseResponse>(primaryIR->GetData(), sampleRate);
+  auto channel2IR = std::make_unique<AccountedImpulseResponse>(primaryIR->GetData(), sampleRate);
   stagedIRChannel2 = std::move(channel2IR);
   stagedIR = std::move(primaryIR);
   return true;
@@ -447,6 +1182,7 @@ AmpFaceLayout GetAmpFaceLayout(const int slotIndex)
   return kAmpFaceLayouts[static_cast<size_t>(std::clamp(slotIndex, 0, static_cast<int>(kAmpFaceLayouts.size()) - 1))];
 }
 
+#if IPLUG_EDITOR
 IRECT MakeAmpFaceKnobArea(const IRECT& ampFaceArea, const AmpFaceLayout& layout, const float columnOffset)
 {
   const float centerX = ampFaceArea.MW() + layout.knobCenterOffsetX + columnOffset * layout.knobSpacing;
@@ -496,6 +1232,7 @@ IRECT MakeAmpFaceVariantSwitchLabelArea(const IRECT& switchArea, const bool uppe
                centerX + 0.5f * kLabelWidth,
                centerY + extraYOffset + 0.5f * kLabelHeight);
 }
+#endif
 
 constexpr float kAmpVariantSwitchScale = 0.5f;
 constexpr float kFXModuleSwitchScale = 0.20f;
@@ -582,6 +1319,7 @@ double GetStandardMasterGainDB(const double value)
   return (value <= 5.0) ? (-40.0 + (value / 5.0) * 40.0) : (((value - 5.0) / 5.0) * 12.0);
 }
 
+#if IPLUG_EDITOR
 IRECT MakeAmpFaceSwitchControlArea(const IRECT& ampFaceArea,
                                    const AmpFaceLayout& layout,
                                    const IBitmap& switchBitmap)
@@ -591,6 +1329,7 @@ IRECT MakeAmpFaceSwitchControlArea(const IRECT& ampFaceArea,
                                switchBitmap.W() * layout.switchScale,
                                switchBitmap.H() * layout.switchScale);
 }
+#endif
 
 const char* GetAmpBackgroundResourceName(const int ampIndex, const bool switchOn)
 {
@@ -839,6 +1578,7 @@ StereoSideSilenceAnalysis AnalyzeStereoSideSilenceBlock(const sample* inputLeft,
   return result;
 }
 
+#if IPLUG_EDITOR
 class StandalonePresetNameEntryControl : public ITextControl
 {
 public:
@@ -865,6 +1605,7 @@ public:
 private:
   std::function<void(const char*)> mCompletionHandler;
 };
+#endif
 
 std::filesystem::path GetStandaloneStateFilePath()
 {
@@ -969,6 +1710,7 @@ std::string SanitizeStandalonePresetName(std::string rawName)
   return rawName;
 }
 
+#if IPLUG_EDITOR
 IText MakePresetNameEntryText(const IText& sourceText)
 {
   IText text = sourceText;
@@ -976,6 +1718,7 @@ IText MakePresetNameEntryText(const IText& sourceText)
   text.mVAlign = EVAlign::Middle;
   return text;
 }
+#endif
 
 bool LoadChunkFromFile(const std::filesystem::path& filePath, IByteChunk& chunk)
 {
@@ -1097,6 +1840,66 @@ void SaveStandaloneStateChunk(const IByteChunk& chunk, const StandaloneStateMeta
 }
 #endif
 
+#ifndef HEADLESS_API
+// Settings that depend on the machine rather than the sound (CPU headroom), shared by every instance and build on it
+// and kept out of presets and host sessions. Stored next to the standalone state.
+struct MachineSettings
+{
+  double slimmableSize = NAMConfig::SlimmableSize;
+  bool slimmableGovernorEnabled = false;
+};
+
+std::filesystem::path GetMachineSettingsFilePath()
+{
+  const auto statePath = GetStandaloneStateFilePath();
+  if (statePath.empty())
+    return {};
+  return statePath.parent_path() / kMachineSettingsFileName;
+}
+
+bool LoadMachineSettings(MachineSettings& settings)
+{
+  IByteChunk fileChunk;
+  if (!LoadChunkFromFile(GetMachineSettingsFilePath(), fileChunk))
+    return false;
+
+  WDL_String header;
+  int pos = fileChunk.GetStr(header, 0);
+  if (pos < 0 || std::strcmp(header.Get(), kMachineSettingsFileHeader) != 0)
+    return false;
+  int32_t version = 0;
+  pos = fileChunk.Get(&version, pos);
+  if (pos < 0 || version != kMachineSettingsFileVersion)
+    return false;
+
+  double slimmableSize = settings.slimmableSize;
+  int32_t slimmableGovernorEnabled = 0;
+  pos = fileChunk.Get(&slimmableSize, pos);
+  if (pos < 0)
+    return false;
+  pos = fileChunk.Get(&slimmableGovernorEnabled, pos);
+  if (pos < 0)
+    return false;
+
+  settings.slimmableSize = std::clamp(slimmableSize, 0.0, 1.0);
+  settings.slimmableGovernorEnabled = (slimmableGovernorEnabled != 0);
+  return true;
+}
+
+void SaveMachineSettings(const MachineSettings& settings)
+{
+  IByteChunk fileChunk;
+  fileChunk.PutStr(kMachineSettingsFileHeader);
+  fileChunk.Put(&kMachineSettingsFileVersion);
+  const double slimmableSize = std::clamp(settings.slimmableSize, 0.0, 1.0);
+  const int32_t slimmableGovernorEnabled = settings.slimmableGovernorEnabled ? 1 : 0;
+  fileChunk.Put(&slimmableSize);
+  fileChunk.Put(&slimmableGovernorEnabled);
+
+  SaveChunkToFile(GetMachineSettingsFilePath(), fileChunk);
+}
+#endif
+
 struct AsymmetricPreGainShape : public IParam::Shape
 {
   IParam::Shape* Clone() const override { return new AsymmetricPreGainShape(*this); }
@@ -1148,6 +1951,7 @@ struct AsymmetricPreGainShape : public IParam::Shape
 };
 } // namespace
 
+#if IPLUG_EDITOR
 // Styles
 const IVColorSpec colorSpec{
   DEFAULT_BGCOLOR, // Background
@@ -1211,6 +2015,7 @@ EMsgBoxResult _ShowMessageBox(iplug::igraphics::IGraphics* pGraphics, const char
   return pGraphics->ShowMessageBox(str, caption, type);
 #endif
 }
+#endif
 
 const std::string kCalibrateInputParamName = "CalibrateInput";
 const bool kDefaultCalibrateInput = false;
@@ -1221,6 +2026,17 @@ const double kDefaultInputCalibrationLevel = 12.0;
 NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
 : Plugin(info, MakeConfig(kNumParams, kNumPresets))
 {
+#if NAM_TRACE
+  // First instance to start owns the trace; NAM_TRACE_FILE overrides the desktop default.
+  if (!NAMTrace::IsRunning())
+  {
+    const char* traceFile = std::getenv("NAM_TRACE_FILE");
+    const std::string tracePath = (traceFile != nullptr && traceFile[0] != '\0')
+                                    ? std::string(traceFile)
+                                    : MakeTimestampedDesktopPath("NAM-trace", ".json");
+    mOwnsTrace = NAMTrace::Start(tracePath.c_str());
+  }
+#endif
   for (auto& path : mAmpNAMPathsByVariant)
     path.Set("");
   for (auto& pendingModel : mPendingLoadedSlotModel)
@@ -1246,6 +2062,16 @@ NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
   mPendingAmpModelSelection.store(-1, std::memory_order_relaxed);
   mCurrentModelSlot = mAmpSelectorIndex;
   mCurrentModelVariant = mAmpSlotSelectedVariant[static_cast<size_t>(mAmpSelectorIndex)];
+#ifndef HEADLESS_API
+  // Before any load is queued, so models are built at this machine's size. The headless tools set their own.
+  MachineSettings machineSettings;
+  if (LoadMachineSettings(machineSettings))
+  {
+    mSlimmableSizeSetting.store(machineSettings.slimmableSize, std::memory_order_relaxed);
+    mSlimmableGovernorEnabled.store(machineSettings.slimmableGovernorEnabled, std::memory_order_relaxed);
+    mSlimmableSizeApplied.store(machineSettings.slimmableSize, std::memory_order_relaxed);
+  }
+#endif
 
   _InitToneStack();
   nam::activations::Activation::enable_fast_tanh();
@@ -1398,6 +2224,7 @@ NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
   for (auto& path : mReleaseStompAssetPaths)
     path.Set("");
 
+#if IPLUG_EDITOR
   mMakeGraphicsFunc = [&]() {
 
 #ifdef OS_IOS
@@ -2264,9 +3091,9 @@ NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
       IRECT(contentArea.L + 18.0f, bottomBarArea.T + 5.0f, footerAmpRowLeft + 190.0f, bottomBarArea.B - 4.0f);
     const IText devDiagnosticsText(9.75f, COLOR_WHITE.WithOpacity(0.82f), "Roboto-Regular", EAlign::Near, EVAlign::Middle);
     if (devDiagnosticsArea.W() > 80.0f)
-      pGraphics->AttachControl(
-                 new ITextControl(devDiagnosticsArea, "", devDiagnosticsText, COLOR_TRANSPARENT), kCtrlTagDevDiagnostics)
-        ->SetIgnoreMouse(true);
+      pGraphics->AttachControl(new NAMClickableTextControl(devDiagnosticsArea, devDiagnosticsText,
+                                                           [this]() { _DumpDevDiagnosticsStageTimingCSV(); }),
+                               kCtrlTagDevDiagnostics);
 #endif
     _UpdatePresetLabel();
     pGraphics->AttachControl(
@@ -3070,6 +3897,7 @@ NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
     // pGraphics->GetControlWithTag(kCtrlTagOutNorm)->SetMouseEventsWhenDisabled(false);
     // pGraphics->GetControlWithTag(kCtrlTagCalibrateInput)->SetMouseEventsWhenDisabled(false);
   };
+#endif
 
   IByteChunk initialDefaultPresetChunk;
   if (SerializeState(initialDefaultPresetChunk))
@@ -3079,12 +3907,14 @@ NeuralAmpModeler::NeuralAmpModeler(const InstanceInfo& info)
     mHasDefaultPresetState = true;
   }
 
-  _StartModelLoadWorker();
+  _StartModelLoadWorkers();
 }
 
 NeuralAmpModeler::~NeuralAmpModeler()
 {
-  _StopModelLoadWorker();
+  mModelPipeline.Stop();
+  mStereoForkJoin.Stop();
+  _StopModelLoadWorkers();
 
   for (auto& pendingModel : mPendingLoadedSlotModel)
   {
@@ -3108,24 +3938,51 @@ NeuralAmpModeler::~NeuralAmpModeler()
     stateMetadata.hasStoredPresetContext = true;
     SaveStandaloneStateChunk(stateChunk, stateMetadata);
   }
+#endif
+#ifndef HEADLESS_API
+  if (mMachineSettingsChanged.load(std::memory_order_relaxed))
+  {
+    MachineSettings machineSettings;
+    machineSettings.slimmableSize = mSlimmableSizeSetting.load(std::memory_order_relaxed);
+    machineSettings.slimmableGovernorEnabled = mSlimmableGovernorEnabled.load(std::memory_order_relaxed);
+    SaveMachineSettings(machineSettings);
+  }
 #endif
   _DeallocateIOPointers();
+#if NAM_TRACE
+  if (mOwnsTrace)
+    NAMTrace::Stop();
+#endif
 }
 
 void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outputs, int nFrames)
 {
+  NAM_RT_SCOPE();
   const size_t numChannelsExternalIn = (size_t)NInChansConnected();
   const size_t numChannelsExternalOut = (size_t)NOutChansConnected();
   const size_t numFrames = (size_t)nFrames;
+  NAM_TRACE_THREAD_NAME("audio");
+  NAM_TRACE_SCOPE_ARG("ProcessBlock", "audio", "frames", nFrames);
+  // Timed from the top, so a wait on the pipeline below counts against the callback like any other stage.
+  const bool slimmableGovernorEnabled = mSlimmableGovernorEnabled.load(std::memory_order_relaxed);
+  const auto blockStartTime =
+    slimmableGovernorEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
 #if NAM_DEV_DIAGNOSTICS
   const uint64_t devDiagnosticsStartNs = GetSteadyClockNowNs();
-  const auto publishDevDiagnosticsTiming = [this, devDiagnosticsStartNs, numFrames]() {
+  DevDiagnosticsStageLaps devDiagnosticsStageLaps(devDiagnosticsStartNs);
+  const auto publishDevDiagnosticsTiming = [this, devDiagnosticsStartNs, numFrames, &devDiagnosticsStageLaps]() {
     const uint64_t endNs = GetSteadyClockNowNs();
     const double elapsedSeconds =
       (endNs > devDiagnosticsStartNs) ? (static_cast<double>(endNs - devDiagnosticsStartNs) * 1.0e-9) : 0.0;
-    _PublishDevDiagnosticsDSPTiming(numFrames, elapsedSeconds);
+    _PublishDevDiagnosticsDSPTiming(numFrames, elapsedSeconds, devDiagnosticsStageLaps);
   };
 #endif
+  // The pipelined amp model stage may still be running the previous block with the models staging swaps below.
+  if (mModelPipelineActive)
+  {
+    mModelPipeline.WaitIdle();
+    _ApplyPendingToneStackRefresh();
+  }
   const double sampleRate = GetSampleRate();
   const double hostTempoBPM = GetTempo();
   const bool hostTempoValid = std::isfinite(hostTempoBPM) && hostTempoBPM >= kDelayHostTempoMinBPM
@@ -3274,7 +4131,19 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   // Input enters the amp core as mono (standalone) or dual-mono (plugin stereo input).
   _ProcessInput(processInputs, numFrames, processNumChannelsExternalIn, numChannelsMonoCore);
   _UpdateMeters(mInputPointers, nullptr, numFrames, numChannelsMonoCore, 0);
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Input);
   _ApplyDSPStaging();
+  // A block that resized a network says nothing about the new size's cost, so the governor skips it.
+  const bool slimmableSizeChanged = _ApplySlimmableSize();
+#if NAM_DEV_DIAGNOSTICS
+  if (mDevDiagnosticsMemoryReportRequested.load(std::memory_order_acquire))
+  {
+    _CollectMemoryReport(mDevDiagnosticsMemoryReport);
+    mDevDiagnosticsMemoryReportRequested.store(false, std::memory_order_relaxed);
+    mDevDiagnosticsMemoryReportReady.store(true, std::memory_order_release);
+  }
+#endif
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Staging);
   const int selectedSlot = std::clamp(mAmpSelectorIndex, 0, static_cast<int>(mToneStacks.size()) - 1);
   const int activeSlot = std::clamp(mCurrentModelSlot, 0, static_cast<int>(mToneStacks.size()) - 1);
   if (activeSlot == selectedSlot)
@@ -3301,6 +4170,8 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
     mActiveStompBoostEnabled = requestedStompBoostEnabled;
     mPathToggleTransitionState = kPathToggleTransitionStateFadeIn;
     mPathToggleTransitionSamplesRemaining = kPathToggleTransitionSamples;
+    if (mModelPipelineActive)
+      mTransitionFadeInHoldSamples = mModelPipeline.GetLatency();
   }
   else if (mPathToggleTransitionState == kPathToggleTransitionStateFadeIn
            && mPathToggleTransitionSamplesRemaining <= 0)
@@ -3374,6 +4245,11 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   const bool ampSectionActive = modelActive && haveModelForCore;
   const bool toneStackActive = requestedAmpToneStackEnabled && ampSectionActive;
   mOutputGain = _GetOutputGainForModel(ampSectionActive ? mModel.get() : nullptr);
+  if (mModelPipelineActive && mOutputGain != mLastPipelinedOutputGainPushed)
+  {
+    mPipelinedOutputGainEvents.Push(mOutputGain, mModelPipeline.GetLatency());
+    mLastPipelinedOutputGainPushed = mOutputGain;
+  }
   const bool tunerActive = GetParam(kTunerActive)->Bool();
   const int transposeSemitones = static_cast<int>(std::lround(GetParam(kTransposeSemitones)->Value()));
   const NoiseGateMacroParams gateMacro = GetNoiseGateMacroParams(GetParam(kNoiseGateThreshold)->Value());
@@ -3427,6 +4303,7 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   mTransposeShifter.ProcessBlock(mInputPointers[0], numFrames, transposeSemitones);
   if (numChannelsMonoCore > 1)
     mTransposeShifterRight.ProcessBlock(mInputPointers[1], numFrames, transposeSemitones);
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Transpose);
 
   // Noise gate trigger
   sample** triggerOutput = mInputPointers;
@@ -3502,6 +4379,7 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
       mStereoSideResumeDeClickSamplesRemaining[c] = 0;
     }
   }
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Gate);
 
   if (compressorEnabled)
   {
@@ -3509,6 +4387,7 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
     _ProcessBuiltInCompressor(modelInputPointers, compressorOutPointers, numChannelsMonoCore, nFrames);
     modelInputPointers = compressorOutPointers;
   }
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Compressor);
 
   if (tsBoostEnabled)
   {
@@ -3522,6 +4401,7 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
     _ProcessBuiltInPrecisionBoost(modelInputPointers, boostOutPointers, numChannelsMonoCore, nFrames);
     modelInputPointers = boostOutPointers;
   }
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Boost);
 
   const int ampModelCrossfadeTargetSelection = mAmpModelCrossfadeTargetSelection;
   ResamplingNAM* crossfadeTargetModel = nullptr;
@@ -3553,6 +4433,9 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
       ? ((std::abs(mOutputGain) > 1.0e-9) ? (_GetOutputGainForModel(crossfadeTargetModel) / mOutputGain) : 1.0)
       : 1.0;
 
+  AmpModelStageJob ampModelStageJob;
+  ampModelStageJob.numChannels = numChannelsMonoCore;
+  ampModelStageJob.bypassSide = bypassHeavySide;
   sample** ampOutPointers = modelInputPointers;
   if (ampSectionActive)
   {
@@ -3562,141 +4445,53 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
         for (size_t s = 0; s < numFrames; ++s)
           modelInputPointers[c][s] *= preModelGain;
     }
-    sample** modelOutPointers = (modelInputPointers == mInputPointers) ? mOutputPointers : mInputPointers;
-    if (numChannelsMonoCore == 1)
+    ampModelStageJob.model = mModel.get();
+    ampModelStageJob.modelRight = mModelRight.get();
+    ampModelStageJob.toneStack = toneStackActive ? activeToneStack : nullptr;
+    ampModelStageJob.masterActive = true;
+    ampModelStageJob.master = _GetAmpMasterStageParams();
+    if (haveAmpModelCrossfadeTarget)
     {
-      mModel->process(modelInputPointers, modelOutPointers, nFrames);
+      ampModelStageJob.crossfadeTarget = crossfadeTargetModel;
+      ampModelStageJob.crossfadeTargetRight = crossfadeTargetModelRight;
+      ampModelStageJob.crossfadeTargetOutputGainScale = ampModelCrossfadeTargetOutputGainScale;
     }
-    else
-    {
-      if (!bypassHeavySide[0])
-      {
-        sample* leftIn[1] = {modelInputPointers[0]};
-        sample* leftOut[1] = {modelOutPointers[0]};
-        mModel->process(leftIn, leftOut, nFrames);
-      }
-      else
-      {
-        std::copy_n(modelInputPointers[0], numFrames, modelOutPointers[0]);
-      }
-
-      if (!bypassHeavySide[1])
-      {
-        sample* rightIn[1] = {modelInputPointers[1]};
-        sample* rightOut[1] = {modelOutPointers[1]};
-        mModelRight->process(rightIn, rightOut, nFrames);
-      }
-      else
-      {
-        std::copy_n(modelInputPointers[1], numFrames, modelOutPointers[1]);
-      }
-
-      if (numFrames > 0)
-      {
-        for (size_t c = 0; c < 2; ++c)
-        {
-          if (bypassHeavySide[c])
-          {
-            mStereoSideResumePrevSample[c] = static_cast<double>(modelOutPointers[c][numFrames - 1]);
-            mStereoSideResumeDeClickSamplesRemaining[c] = 0;
-            continue;
-          }
-
-          int declickRemaining = mStereoSideResumeDeClickSamplesRemaining[c];
-          if (declickRemaining > 0)
-          {
-            const int framesToSmooth = static_cast<int>(std::min(numFrames, static_cast<size_t>(declickRemaining)));
-            double prev = mStereoSideResumePrevSample[c];
-            int channelRemaining = declickRemaining;
-            for (int s = 0; s < framesToSmooth; ++s)
-            {
-              const double t = 1.0 - static_cast<double>(channelRemaining - 1)
-                                         / static_cast<double>(kStereoSideBypassResumeDeClickSamples);
-              const double blended = (1.0 - t) * prev + t * static_cast<double>(modelOutPointers[c][s]);
-              modelOutPointers[c][s] = static_cast<sample>(blended);
-              prev = blended;
-              --channelRemaining;
-            }
-            if (numFrames > static_cast<size_t>(framesToSmooth))
-              prev = static_cast<double>(modelOutPointers[c][numFrames - 1]);
-            mStereoSideResumePrevSample[c] = prev;
-            declickRemaining -= framesToSmooth;
-            mStereoSideResumeDeClickSamplesRemaining[c] = std::max(0, declickRemaining);
-          }
-          else
-          {
-            mStereoSideResumePrevSample[c] = static_cast<double>(modelOutPointers[c][numFrames - 1]);
-          }
-        }
-      }
-    }
-
-    if (haveAmpModelCrossfadeTarget)
+  }
+  sample** postAmpPointers = nullptr;
+  if (mModelPipelineActive)
+  {
+    // Bypassed amps go through the pipeline as well (copied), so the reported latency holds for the whole chain.
+    // Tone stack and master run in the stage, so nothing per-slot is left for this thread.
+    sample** modelOutPointers = (modelInputPointers == mInputPointers) ? mOutputPointers : mInputPointers;
+    mPipelinedAmpModelStageJob = ampModelStageJob;
+    mModelPipeline.Exchange(modelInputPointers, modelOutPointers, numChannelsMonoCore, nFrames);
+    postAmpPointers = modelOutPointers;
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(Model);
+  }
+  else if (ampSectionActive)
+  {
+    sample** modelOutPointers = (modelInputPointers == mInputPointers) ? mOutputPointers : mInputPointers;
+    _ProcessAmpModelStage(ampModelStageJob, modelInputPointers, modelOutPointers, nFrames);
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(Model);
+    if (ampModelStageJob.crossfadeTarget != nullptr)
     {
-      sample* crossfadeTargetPointers[kNumChannelsInternal] = {
-        mAmpModelCrossfadeArray[0].data(),
-        mAmpModelCrossfadeArray[1].data()
-      };
-      if (numChannelsMonoCore == 1)
-      {
-        sample* monoTargetOut[1] = {crossfadeTargetPointers[0]};
-        crossfadeTargetModel->process(modelInputPointers, monoTargetOut, nFrames);
-      }
-      else
-      {
-        if (!bypassHeavySide[0])
-        {
-          sample* leftIn[1] = {modelInputPointers[0]};
-          sample* leftOut[1] = {crossfadeTargetPointers[0]};
-          crossfadeTargetModel->process(leftIn, leftOut, nFrames);
-        }
-        else
-        {
-          std::copy_n(modelInputPointers[0], numFrames, crossfadeTargetPointers[0]);
-        }
-
-        if (!bypassHeavySide[1])
-        {
-          sample* rightIn[1] = {modelInputPointers[1]};
-          sample* rightOut[1] = {crossfadeTargetPointers[1]};
-          crossfadeTargetModelRight->process(rightIn, rightOut, nFrames);
-        }
-        else
-        {
-          std::copy_n(modelInputPointers[1], numFrames, crossfadeTargetPointers[1]);
-        }
-      }
-
-      int crossfadeRemaining = mAmpModelCrossfadeSamplesRemaining;
-      for (size_t s = 0; s < numFrames; ++s)
-      {
-        const double mix =
-          (crossfadeRemaining > 0)
-            ? std::clamp(1.0 - static_cast<double>(crossfadeRemaining - 1)
-                                   / static_cast<double>(kAmpModelVariantCrossfadeSamples),
-                         0.0,
-                         1.0)
-            : 1.0;
-        for (size_t c = 0; c < numChannelsMonoCore; ++c)
-        {
-          const double currentSample = static_cast<double>(modelOutPointers[c][s]);
-          const double targetSample =
-            static_cast<double>(crossfadeTargetPointers[c][s]) * ampModelCrossfadeTargetOutputGainScale;
-          modelOutPointers[c][s] = static_cast<sample>((1.0 - mix) * currentSample + mix * targetSample);
-        }
-        if (crossfadeRemaining > 0)
-          --crossfadeRemaining;
-      }
-      mAmpModelCrossfadeSamplesRemaining = std::max(0, crossfadeRemaining);
+      _ProcessAmpModelCrossfade(ampModelStageJob, modelInputPointers, modelOutPointers, nFrames);
+      NAM_DEV_DIAGNOSTICS_MARK_STAGE(ModelCrossfade);
     }
-
     ampOutPointers = modelOutPointers;
   }
-  sample** postAmpPointers = (toneStackActive && activeToneStack != nullptr)
-                               ? activeToneStack->Process(ampOutPointers, numChannelsMonoCore, nFrames)
-                               : ampOutPointers;
-  if (ampSectionActive)
-    _ProcessAmpMasterStage(postAmpPointers, numChannelsMonoCore, nFrames);
+  if (!mModelPipelineActive)
+  {
+    postAmpPointers = (ampModelStageJob.toneStack != nullptr)
+                        ? ampModelStageJob.toneStack->Process(ampOutPointers, numChannelsMonoCore, nFrames)
+                        : ampOutPointers;
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(ToneStack);
+    if (ampModelStageJob.masterActive)
+    {
+      _ProcessAmpMasterStage(ampModelStageJob.master, postAmpPointers, numChannelsMonoCore, nFrames);
+      NAM_DEV_DIAGNOSTICS_MARK_STAGE(Master);
+    }
+  }
 
   auto copyMonoToStereo = [this, numFrames](sample** monoPointers) {
     if (monoPointers == nullptr || monoPointers[0] == nullptr)
@@ -3904,13 +4699,23 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
       if (activeCabSlots == 1)
       {
         mixCabSlot(cabAEnabled ? 0 : 1, false);
+        if (cabAEnabled)
+          NAM_DEV_DIAGNOSTICS_MARK_STAGE(CabA);
+        else
+          NAM_DEV_DIAGNOSTICS_MARK_STAGE(CabB);
       }
       else
       {
         if (cabAEnabled)
+        {
           mixCabSlot(0, true);
+          NAM_DEV_DIAGNOSTICS_MARK_STAGE(CabA);
+        }
         if (cabBEnabled)
+        {
           mixCabSlot(1, true);
+          NAM_DEV_DIAGNOSTICS_MARK_STAGE(CabB);
+        }
       }
       irPointers = mOutputPointers;
     }
@@ -3942,20 +4747,30 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   mUserLowPass2.SetParams(userLowPassParams);
   sample** userLowPassPointers1 = mUserLowPass1.Process(userHighPassPointers2, numChannelsInternal, numFrames);
   sample** userLowPassPointers2 = mUserLowPass2.Process(userLowPassPointers1, numChannelsInternal, numFrames);
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(PostFilters);
 
   sample** fxStagePointers = userLowPassPointers2;
   const bool eqBypassed = mTopNavBypassed[static_cast<size_t>(TopNavSection::Eq)];
   const bool fxBypassed = mTopNavBypassed[static_cast<size_t>(TopNavSection::Fx)];
 
   if (GetParam(kFXEQActive)->Bool() && !eqBypassed && sampleRate > 0.0)
+  {
     _ProcessPostCabEQStage(fxStagePointers, numChannelsInternal, numFrames, sampleRate);
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(EQ);
+  }
 
   if (mVirtualDoubleBufferSamples > 2 && sampleRate > 0.0)
+  {
     _ProcessVirtualDoubleStage(fxStagePointers, numChannelsInternal, numChannelsMonoCore, numFrames, sampleRate);
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(Doubler);
+  }
 
   const bool fxDelayActive = GetParam(kFXDelayActive)->Bool() && !fxBypassed;
   if (mFXDelayBufferSamples > 2 && sampleRate > 0.0)
+  {
     _ProcessFXDelayStage(fxStagePointers, numChannelsInternal, numChannelsMonoCore, numFrames, sampleRate, fxDelayActive);
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(Delay);
+  }
 
   const bool fxReverbActive = GetParam(kFXReverbActive)->Bool() && !fxBypassed;
   if (fxReverbActive && !mFXReverbWasActive)
@@ -3963,7 +4778,10 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   mFXReverbWasActive = fxReverbActive;
 
   if (fxReverbActive && sampleRate > 0.0 && mFXReverbPreDelayBufferSamples > 2)
+  {
     _ProcessFXReverbStage(fxStagePointers, numChannelsInternal, numChannelsMonoCore, numFrames, sampleRate);
+    NAM_DEV_DIAGNOSTICS_MARK_STAGE(Reverb);
+  }
 
   // And the HPF for DC offset (Issue 271)
   const double highPassCutoffFreq = kDCBlockerFrequency;
@@ -3980,6 +4798,24 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
     for (size_t c = 0; c < numChannelsInternal; ++c)
       std::fill_n(hpfPointers[c], numFrames, 0.0f);
   }
+  else if (mPresetRecallMuteHoldSamples > 0)
+  {
+    // Pipelined: the recalled scene's first output is still GetLatency() frames away.
+    const size_t heldFrames = std::min(numFrames, static_cast<size_t>(mPresetRecallMuteHoldSamples));
+    for (size_t c = 0; c < numChannelsInternal; ++c)
+      std::fill_n(hpfPointers[c], heldFrames, 0.0f);
+    mPresetRecallMuteHoldSamples -= static_cast<int>(heldFrames);
+  }
+
+  // Pipelined swap de-clicks fall due GetLatency() frames after the swap, possibly mid-block.
+  int pipelinedDeClickOffset = -1;
+  if (mModelPipelineActive)
+  {
+    mPipelinedDeClickEvents.Advance(nFrames, [&pipelinedDeClickOffset](const int offset, bool) {
+      if (pipelinedDeClickOffset < 0)
+        pipelinedDeClickOffset = offset;
+    });
+  }
 
   if (numFrames > 0)
   {
@@ -3992,9 +4828,23 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
       int& transitionRemainingRef =
         slotTransitionActive ? mAmpSlotTransitionSamplesRemaining : mPathToggleTransitionSamplesRemaining;
       int transitionRemaining = transitionRemainingRef;
-      const int framesToFade = static_cast<int>(std::min(numFrames, static_cast<size_t>(transitionRemaining)));
       const bool fadingOut = slotTransitionActive ? (mAmpSlotTransitionState == kAmpSlotTransitionStateFadeOut)
                                                   : (mPathToggleTransitionState == kPathToggleTransitionStateFadeOut);
+      // Pipelined: the fade-in waits at silence until the output of the committed state comes out of the stage.
+      size_t fadeStart = 0;
+      if (fadingOut)
+      {
+        mTransitionFadeInHoldSamples = 0;
+      }
+      else if (mTransitionFadeInHoldSamples > 0)
+      {
+        fadeStart = std::min(numFrames, static_cast<size_t>(mTransitionFadeInHoldSamples));
+        for (size_t c = 0; c < numChannelsInternal; ++c)
+          std::fill_n(hpfPointers[c], fadeStart, 0.0f);
+        mTransitionFadeInHoldSamples -= static_cast<int>(fadeStart);
+      }
+      const int framesToFade =
+        static_cast<int>(std::min(numFrames - fadeStart, static_cast<size_t>(transitionRemaining)));
       const int totalTransitionSamples =
         slotTransitionActive ? kAmpSlotTransitionSamples : kPathToggleTransitionSamples;
       for (int s = 0; s < framesToFade; ++s)
@@ -4002,8 +4852,10 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
         const double progress =
           1.0 - static_cast<double>(transitionRemaining) / static_cast<double>(totalTransitionSamples);
         const double gain = fadingOut ? (1.0 - progress) : progress;
+        const size_t frame = fadeStart + static_cast<size_t>(s);
         for (size_t c = 0; c < numChannelsInternal; ++c)
-          hpfPointers[c][s] = static_cast<sample>(static_cast<double>(hpfPointers[c][s]) * std::clamp(gain, 0.0, 1.0));
+          hpfPointers[c][frame] =
+            static_cast<sample>(static_cast<double>(hpfPointers[c][frame]) * std::clamp(gain, 0.0, 1.0));
         --transitionRemaining;
       }
       if (fadingOut && numFrames > static_cast<size_t>(framesToFade))
@@ -4012,40 +4864,49 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
           std::fill_n(hpfPointers[c] + framesToFade, numFrames - static_cast<size_t>(framesToFade), 0.0f);
       }
       transitionRemainingRef = std::max(0, transitionRemaining);
+      if (pipelinedDeClickOffset >= 0)
+        mAmpSwitchDeClickSamplesRemaining.store(kAmpSlotSwitchDeClickSamples, std::memory_order_relaxed);
       for (size_t c = 0; c < numChannelsInternal; ++c)
         mAmpSwitchDeClickPrevSample[c] = static_cast<double>(hpfPointers[c][numFrames - 1]);
     }
     else
     {
       int declickRemaining = mAmpSwitchDeClickSamplesRemaining.load(std::memory_order_relaxed);
-      if (declickRemaining > 0)
-      {
-        const int framesToSmooth = static_cast<int>(std::min(numFrames, static_cast<size_t>(declickRemaining)));
+      // Smooths [begin, end) into the sample before it, for what is left of the current de-click.
+      auto smoothDeClick = [&](const size_t begin, const size_t end) {
+        const int framesToSmooth = static_cast<int>(std::min(end - begin, static_cast<size_t>(declickRemaining)));
+        if (framesToSmooth <= 0)
+          return;
         for (size_t c = 0; c < numChannelsInternal; ++c)
         {
-          double prev = mAmpSwitchDeClickPrevSample[c];
+          double prev = (begin == 0) ? mAmpSwitchDeClickPrevSample[c] : static_cast<double>(hpfPointers[c][begin - 1]);
           int channelRemaining = declickRemaining;
           for (int s = 0; s < framesToSmooth; ++s)
           {
             const double t = 1.0 - static_cast<double>(channelRemaining - 1)
                                        / static_cast<double>(kAmpSlotSwitchDeClickSamples);
-            const double blended = (1.0 - t) * prev + t * static_cast<double>(hpfPointers[c][s]);
-            hpfPointers[c][s] = static_cast<sample>(blended);
+            const size_t frame = begin + static_cast<size_t>(s);
+            const double blended = (1.0 - t) * prev + t * static_cast<double>(hpfPointers[c][frame]);
+            hpfPointers[c][frame] = static_cast<sample>(blended);
             prev = blended;
             --channelRemaining;
           }
-          if (numFrames > static_cast<size_t>(framesToSmooth))
-            prev = static_cast<double>(hpfPointers[c][numFrames - 1]);
-          mAmpSwitchDeClickPrevSample[c] = prev;
         }
         declickRemaining -= framesToSmooth;
-        mAmpSwitchDeClickSamplesRemaining.store(std::max(0, declickRemaining), std::memory_order_relaxed);
+      };
+      if (pipelinedDeClickOffset >= 0)
+      {
+        smoothDeClick(0, static_cast<size_t>(pipelinedDeClickOffset));
+        declickRemaining = kAmpSlotSwitchDeClickSamples;
+        smoothDeClick(static_cast<size_t>(pipelinedDeClickOffset), numFrames);
       }
       else
       {
-        for (size_t c = 0; c < numChannelsInternal; ++c)
-          mAmpSwitchDeClickPrevSample[c] = static_cast<double>(hpfPointers[c][numFrames - 1]);
+        smoothDeClick(0, numFrames);
       }
+      mAmpSwitchDeClickSamplesRemaining.store(std::max(0, declickRemaining), std::memory_order_relaxed);
+      for (size_t c = 0; c < numChannelsInternal; ++c)
+        mAmpSwitchDeClickPrevSample[c] = static_cast<double>(hpfPointers[c][numFrames - 1]);
     }
   }
 
@@ -4056,9 +4917,20 @@ void NeuralAmpModeler::ProcessBlock(iplug::sample** inputs, iplug::sample** outp
   // This is where we exit mono for whatever the output requires.
   _ProcessOutput(hpfPointers, outputs, numFrames, numChannelsInternal, numChannelsExternalOut);
   // _ProcessOutput(lpfPointers, outputs, numFrames, numChannelsInternal, numChannelsExternalOut);
+  // A pipelined output gain change takes effect from the block after the one it falls due in; the gain is smoothed
+  // anyway, so starting up to a block late only shifts the ramp.
+  if (mModelPipelineActive)
+    mPipelinedOutputGainEvents.Advance(nFrames, [this](int, const double gain) { mPipelinedOutputGain = gain; });
   // * Output of input leveling (inputs -> mInputPointers),
   // * Output of output leveling (mOutputPointers -> outputs)
   _UpdateMeters(nullptr, outputs, numFrames, 0, numChannelsExternalOut);
+  NAM_DEV_DIAGNOSTICS_MARK_STAGE(Output);
+  if (slimmableGovernorEnabled && !slimmableSizeChanged && sampleRate > 0.0)
+  {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - blockStartTime;
+    mSlimmableGovernor.Update(elapsed.count(), static_cast<double>(numFrames) / sampleRate,
+                              std::clamp(mSlimmableSizeSetting.load(std::memory_order_relaxed), 0.0, 1.0));
+  }
 #if NAM_DEV_DIAGNOSTICS
   publishDevDiagnosticsTiming();
 #endif
@@ -4068,6 +4940,20 @@ void NeuralAmpModeler::OnReset()
 {
   const auto sampleRate = GetSampleRate();
   const int maxBlockSize = GetBlockSize();
+  // The stream is stopped, but the pipeline worker may still be on the last block; nothing below may race it.
+  mModelPipeline.Stop();
+  mModelPipelineActive = false;
+  _ApplyPendingToneStackRefresh();
+  // Input stereo mode can change mid-stream, so the instance stays registered with the shared fork-join pool whenever
+  // there is a spare core for it; the pool's workers sleep while nothing forks.
+  if (std::thread::hardware_concurrency() > 2)
+    mStereoForkJoin.Start();
+#if NAM_DEV_DIAGNOSTICS
+  // Stage timings from another sample rate or block size do not compare.
+  mDevDiagnosticsStageTiming.RequestReset();
+#endif
+  // The governor's load history is just as specific to them.
+  mSlimmableGovernor.Reset();
   constexpr double kFXDelayMaxSeconds = 2.0;
   constexpr double kFXReverbMaxPreDelaySeconds = 0.30;
   constexpr double kVirtualDoubleMaxSeconds = 0.05;
@@ -4458,17 +5344,30 @@ void NeuralAmpModeler::OnReset()
   mStereoSideActiveCandidateSamples.fill(0);
   mStereoSideResumeDeClickSamplesRemaining.fill(0);
   mStereoSideResumePrevSample.fill(0.0);
+  mPipelinedOutputGainEvents.Clear();
+  mPipelinedDeClickEvents.Clear();
+  mPipelinedOutputGain = mLastPipelinedOutputGainPushed = mOutputGain;
+  mTransitionFadeInHoldSamples = 0;
+  mPresetRecallMuteHoldSamples = 0;
+  if (mPipelinedModelRequested.load(std::memory_order_relaxed))
+  {
+    mModelPipeline.Prepare(kNumChannelsInternal, maxBlockSize, sampleRate);
+    mModelPipelineActive = true;
+  }
   _UpdateLatency();
 }
 
 void NeuralAmpModeler::OnIdle()
 {
+  NAM_TRACE_THREAD_NAME("ui");
   _ApplyInputStereoAutoDefaultIfNeeded();
   _RefreshModelCapabilityIndicators();
+  _RequestSlimmableResize();
 #if NAM_DEV_DIAGNOSTICS
   _RefreshDevDiagnostics();
 #endif
 
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     if (auto* pTempoControl = pGraphics->GetControlWithParamIdx(kDelayManualTempoBPM))
@@ -4523,6 +5422,7 @@ void NeuralAmpModeler::OnIdle()
       mStandalonePresetNameEntryPendingText.Set("");
     }
   }
+#endif
 
   if (mDefaultPresetPostLoadSyncPending && mDefaultPresetActive)
   {
@@ -4595,6 +5495,7 @@ void NeuralAmpModeler::OnIdle()
     mDefaultPresetPostLoadSyncPending = keepSyncPending;
   }
 
+#if IPLUG_EDITOR
   if (GetUI() != nullptr)
   {
     auto syncIRPicker = [this](const int ctrlTag, const int loadedMsgTag, const int clearMsgTag, const WDL_String& currentPath,
@@ -4613,6 +5514,7 @@ void NeuralAmpModeler::OnIdle()
     syncIRPicker(kCtrlTagIRFileBrowserLeft, kMsgTagLoadedIRLeft, kMsgTagClearIRLeft, mCabCustomIRPaths[0], mLastSentIRPath);
     syncIRPicker(kCtrlTagIRFileBrowserRight, kMsgTagLoadedIRRight, kMsgTagClearIRRight, mCabCustomIRPaths[1], mLastSentIRPathRight);
   }
+#endif
 
   mInputSender.TransmitData(*this);
   mOutputSender.TransmitData(*this);
@@ -4660,6 +5562,7 @@ void NeuralAmpModeler::OnIdle()
   if (refreshModelCapabilityIndicators)
     _RefreshModelCapabilityIndicators();
 
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     const bool tunerActive = GetParam(kTunerActive)->Bool();
@@ -4722,6 +5625,7 @@ void NeuralAmpModeler::OnIdle()
       mModelCleared = false;
     }
   }
+#endif
 }
 
 void NeuralAmpModeler::_ApplyInputStereoAutoDefaultIfNeeded()
@@ -4749,7 +5653,7 @@ void NeuralAmpModeler::_ApplyInputStereoAutoDefaultIfNeeded()
 
 bool NeuralAmpModeler::SerializeState(IByteChunk& chunk) const
 {
-  constexpr int32_t kStateSchemaVersion = 8;
+  constexpr int32_t kStateSchemaVersion = 10;
 
   // If this isn't here when unserializing, then we know we're dealing with something before v0.8.0.
   WDL_String header("###NeuralAmpModeler###"); // Don't change this!
@@ -4822,7 +5726,10 @@ bool NeuralAmpModeler::SerializeState(IByteChunk& chunk) const
 
 int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
 {
-  constexpr int32_t kStateSchemaVersion = 8;
+  NAM_STARTUP_PROFILE_SCOPE(PresetRestore);
+  constexpr int32_t kStateSchemaVersion = 10;
+  constexpr int32_t kSlimmableStateSchemaVersion = 9;
+  constexpr int32_t kAuxButtonStateSchemaVersion = 8;
   constexpr int32_t kAmpSlotVariantStateSchemaVersion = 7;
   constexpr int32_t kPreviousStateSchemaVersion = 6;
   constexpr int32_t kLegacyStateSchemaVersion = 5;
@@ -4876,6 +5783,7 @@ int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
     _UpdatePresetLabel();
   };
   auto syncAllParamControls = [this]() {
+#if IPLUG_EDITOR
     if (GetUI() == nullptr)
       return;
     for (int paramIdx = 0; paramIdx < kNumParams; ++paramIdx)
@@ -4883,6 +5791,7 @@ int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
       if (auto* pParam = GetParam(paramIdx))
         SendParameterValueFromDelegate(paramIdx, pParam->GetNormalized(), true);
     }
+#endif
   };
 
   // Look for the expected header. If it's there, then we'll know what to do.
@@ -4911,7 +5820,8 @@ int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
   int32_t schemaVersion = 0;
   const int schemaPos = chunk.Get(&schemaVersion, versionPos);
   if (schemaPos >= 0
-      && (schemaVersion == kStateSchemaVersion || schemaVersion == kAmpSlotVariantStateSchemaVersion
+      && (schemaVersion == kStateSchemaVersion || schemaVersion == kSlimmableStateSchemaVersion
+          || schemaVersion == kAuxButtonStateSchemaVersion || schemaVersion == kAmpSlotVariantStateSchemaVersion
           || schemaVersion == kPreviousStateSchemaVersion
           || schemaVersion == kLegacyStateSchemaVersion || schemaVersion == kOlderLegacyStateSchemaVersion
           || schemaVersion == kOldestLegacyStateSchemaVersion))
@@ -5036,7 +5946,7 @@ int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
       statePos = chunk.Get(&slotState.master, statePos);
       if (statePos < 0)
         return startPos;
-      if (schemaVersion >= kStateSchemaVersion)
+      if (schemaVersion >= kAuxButtonStateSchemaVersion)
       {
         statePos = chunk.Get(&slotState.auxButton1, statePos);
         if (statePos < 0)
@@ -5079,6 +5989,18 @@ int NeuralAmpModeler::UnserializeState(const IByteChunk& chunk, int startPos)
       presetContext.defaultPresetActive = (defaultPresetActive != 0);
       presetContext.hasStoredPresetContext = true;
     }
+    // Schema 9 stored the slimmable settings with the state; they are per-machine settings now, so skip them.
+    if (schemaVersion == kSlimmableStateSchemaVersion)
+    {
+      double slimmableSize = 0.0;
+      int32_t slimmableGovernorEnabled = 0;
+      restoredPos = chunk.Get(&slimmableSize, restoredPos);
+      if (restoredPos < 0)
+        return startPos;
+      restoredPos = chunk.Get(&slimmableGovernorEnabled, restoredPos);
+      if (restoredPos < 0)
+        return startPos;
+    }
 
     if (presetContext.hasStoredPresetContext && presetContext.presetFilePath.GetLength() > 0)
     {
@@ -5397,6 +6319,7 @@ void NeuralAmpModeler::OnUIOpen()
   _RefreshStandalonePresetList();
   _UpdatePresetLabel();
 
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     if (auto* pDoubleControl = pGraphics->GetControlWithParamIdx(kVirtualDoubleAmount))
@@ -5427,6 +6350,7 @@ void NeuralAmpModeler::OnUIOpen()
       pStompPickerB->SetDisabled(!canEditExternalAssets);
     _RefreshCabControls();
   }
+#endif
 }
 
 void NeuralAmpModeler::OnParamChange(int paramIdx)
@@ -5465,6 +6389,7 @@ void NeuralAmpModeler::OnParamChangeUI(int paramIdx, EParamSource source)
   if (source == kUI && paramIdx != kInputStereoMode)
     _MarkStandalonePresetDirty();
 
+#if IPLUG_EDITOR
   if (auto pGraphics = GetUI())
   {
     bool active = GetParam(paramIdx)->Bool();
@@ -5649,6 +6574,7 @@ void NeuralAmpModeler::OnParamChangeUI(int paramIdx, EParamSource source)
       default: break;
     }
   }
+#endif
 }
 
 bool NeuralAmpModeler::OnMessage(int msgTag, int ctrlTag, int dataSize, const void* pData)
@@ -5723,6 +6649,7 @@ bool NeuralAmpModeler::OnMessage(int msgTag, int ctrlTag, int dataSize, const vo
     {
       mHighLightColor.Set((const char*)pData);
 
+#if IPLUG_EDITOR
       if (GetUI())
       {
         GetUI()->ForStandardControlsFunc([&](IControl* pControl) {
@@ -5738,6 +6665,7 @@ bool NeuralAmpModeler::OnMessage(int msgTag, int ctrlTag, int dataSize, const vo
           pControl->GetUI()->SetAllControlsDirty();
         });
       }
+#endif
 
       return true;
     }
@@ -5747,6 +6675,7 @@ bool NeuralAmpModeler::OnMessage(int msgTag, int ctrlTag, int dataSize, const vo
 
 void NeuralAmpModeler::_UpdatePresetLabel()
 {
+#if IPLUG_EDITOR
   auto* pGraphics = GetUI();
   if (pGraphics == nullptr)
     return;
@@ -5788,6 +6717,7 @@ void NeuralAmpModeler::_UpdatePresetLabel()
     pLabelButton->SetLabelStr(label.Get());
     pLabelButton->SetDirty(false);
   }
+#endif
 }
 
 void NeuralAmpModeler::_RefreshStandalonePresetList()
@@ -6117,6 +7047,7 @@ bool NeuralAmpModeler::_SaveStandalonePresetToFile(const WDL_String& filePath)
   return true;
 }
 
+#if IPLUG_EDITOR
 void NeuralAmpModeler::_PromptStandalonePresetSaveAs()
 {
   auto* pGraphics = GetUI();
@@ -6323,6 +7254,7 @@ void NeuralAmpModeler::_PromptStandalonePresetDelete()
     _UpdatePresetLabel();
   }
 }
+#endif
 
 void NeuralAmpModeler::_SelectStandalonePresetRelative(const int delta)
 {
@@ -6342,6 +7274,7 @@ void NeuralAmpModeler::_SelectStandalonePresetRelative(const int delta)
   _LoadStandalonePresetFromFile(mStandalonePresetPaths[nextIndex]);
 }
 
+#if IPLUG_EDITOR
 void NeuralAmpModeler::_ShowStandalonePresetMenu(const IRECT& anchorArea)
 {
   auto* pGraphics = GetUI();
@@ -6466,6 +7399,7 @@ void NeuralAmpModeler::_ShowStandalonePresetMenu(const IRECT& anchorArea)
     pPopupMenuControl->SetText(IText(18.0f, COLOR_WHITE.WithOpacity(0.92f), "ArialNarrow-Bold", EAlign::Near, EVAlign::Middle));
   pGraphics->CreatePopupMenu(*pPresetControl, mStandalonePresetMenu, anchorArea);
 }
+#endif
 
 bool NeuralAmpModeler::_IsStandaloneFactoryPresetPath(const WDL_String& filePath) const
 {
@@ -6602,24 +7536,34 @@ void NeuralAmpModeler::_SetAmpSlotSelectedVariant(int slotIndex, int variantInde
     mNAMPath = mAmpNAMPaths[clampedSlot];
 }
 
-void NeuralAmpModeler::_StartModelLoadWorker()
+void NeuralAmpModeler::_StartModelLoadWorkers()
 {
-  if (mModelLoadWorker.joinable())
-    return;
-  mModelLoadWorkerExit = false;
-  mModelLoadWorker = std::thread([this]() { _ModelLoadWorkerLoop(); });
+  ModelLoadPool::Get().AddUser();
 }
 
-void NeuralAmpModeler::_StopModelLoadWorker()
+// Drops this instance's queued loads and waits out its running ones before the pool can lose its last user.
+void NeuralAmpModeler::_StopModelLoadWorkers()
 {
-  {
-    std::lock_guard<std::mutex> lock(mModelLoadMutex);
-    mModelLoadWorkerExit = true;
-    mModelLoadJobs.clear();
-  }
-  mModelLoadCV.notify_all();
-  if (mModelLoadWorker.joinable())
-    mModelLoadWorker.join();
+  ModelLoadPool::Get().Cancel(this);
+  ModelLoadPool::Get().RemoveUser();
+}
+
+// 0: the active slot's selected variant (what's about to play); 1: the active slot's other variant; 2: the selected
+// variants of the other slots; 3: the rest.
+int NeuralAmpModeler::_GetModelLoadPriority(const int slotIndex, const int variantIndex) const
+{
+  const bool selectedVariant = (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)]);
+  if (slotIndex == mAmpSelectorIndex)
+    return selectedVariant ? 0 : 1;
+  return selectedVariant ? 2 : 3;
+}
+
+// Called on the main thread whenever the active slot or a selected variant changes, so queued jobs follow it.
+void NeuralAmpModeler::_RefreshModelLoadPriorities()
+{
+  ModelLoadPool::Get().UpdatePriorities(this, [this](const int storageIndex) {
+    return _GetModelLoadPriority(storageIndex / kAmpModelVariantCount, storageIndex % kAmpModelVariantCount);
+  });
 }
 
 void NeuralAmpModeler::_BeginPresetRecallTransition(int previousActiveSlot, int targetActiveSlot)
@@ -6659,34 +7603,35 @@ void NeuralAmpModeler::_RequestModelLoadForSlot(const WDL_String& modelPath, int
 
   mAmpSlotModelState[storageIndex].store(kAmpSlotModelStateLoading, std::memory_order_release);
   mSlotLoadUIEvent[storageIndex].store(kSlotLoadUIEventNone, std::memory_order_relaxed);
-  const uint64_t requestId = mSlotLoadRequestId[storageIndex].fetch_add(1, std::memory_order_relaxed) + 1;
   if (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)])
     _ClearAmpSlotCapabilityState(slotIndex);
-
-  {
-    std::lock_guard<std::mutex> lock(mModelLoadMutex);
-    for (auto it = mModelLoadJobs.begin(); it != mModelLoadJobs.end();)
-    {
-      if (it->slotIndex == slotIndex && it->variantIndex == variantIndex)
-        it = mModelLoadJobs.erase(it);
-      else
-        ++it;
-    }
-    ModelLoadJob job;
-    job.slotIndex = slotIndex;
-    job.variantIndex = variantIndex;
-    job.requestId = requestId;
-    job.modelPath = effectiveModelPath;
-    const double sampleRate = GetSampleRate();
-    job.sampleRate = (sampleRate > 0.0) ? sampleRate : 48000.0;
-    job.blockSize = std::max(1, GetBlockSize());
-    mModelLoadJobs.push_back(std::move(job));
-  }
-  mModelLoadCV.notify_one();
+  _SubmitModelLoadJob(slotIndex, variantIndex, effectiveModelPath);
 
   SendControlMsgFromDelegate(slotCtrlTag, kMsgTagLoadedModel, effectiveModelPath.GetLength(), effectiveModelPath.Get());
 }
 
+// Supersedes any load in flight for the slot/variant.
+void NeuralAmpModeler::_SubmitModelLoadJob(const int slotIndex, const int variantIndex, const WDL_String& modelPath)
+{
+  const int storageIndex = _GetAmpSlotModelStorageIndex(slotIndex, variantIndex);
+  ModelLoadJob job;
+  job.slotIndex = slotIndex;
+  job.variantIndex = variantIndex;
+  job.storageIndex = storageIndex;
+  job.requestId = mSlotLoadRequestId[storageIndex].fetch_add(1, std::memory_order_relaxed) + 1;
+  job.modelPath = modelPath;
+  const double sampleRate = GetSampleRate();
+  job.sampleRate = (sampleRate > 0.0) ? sampleRate : 48000.0;
+  job.blockSize = std::max(1, GetBlockSize());
+  // The active slot may have changed since the other jobs were queued (preset recall).
+  _RefreshModelLoadPriorities();
+  ModelLoadPool::Get().Submit(this, storageIndex, _GetModelLoadPriority(slotIndex, variantIndex),
+                              [this, job = std::move(job)]() {
+                                NAM_TRACE_THREAD_NAME("model-loader");
+                                _RunModelLoadJob(job);
+                              });
+}
+
 bool NeuralAmpModeler::_CanEditAmpSlotModel(int slotIndex) const
 {
   slotIndex = std::clamp(slotIndex, 0, static_cast<int>(mAmpSlotModelEditLocked.size()) - 1);
@@ -6742,7 +7687,11 @@ void NeuralAmpModeler::_ApplyReleaseAssetManifestToState()
 
   mStompNAMPath = _ResolveReleaseStompAssetPath(mReleaseAssetManifest.stomp);
   mStompNAMPathB = _ResolveReleaseStompAssetPath(ReleaseStompAssetId::BoostB);
+#if IPLUG_EDITOR
   (void) _ApplyDefaultCuratedCabState(GetUI() != nullptr);
+#else
+  (void) _ApplyDefaultCuratedCabState(false);
+#endif
 }
 
 WDL_String NeuralAmpModeler::_ResolveReleaseAmpAssetPath(const ReleaseAmpAssetId assetId) const
@@ -6837,8 +7786,12 @@ bool NeuralAmpModeler::_ApplyDefaultCuratedCabState(const bool notifyUI)
   auto applyParam = [this, notifyUI](const int paramIdx, const double value) {
     auto* param = GetParam(paramIdx);
     param->Set(value);
+#if IPLUG_EDITOR
     if (notifyUI && GetUI() != nullptr)
       SendParameterValueFromDelegate(paramIdx, param->GetNormalized(), true);
+#else
+    (void) notifyUI;
+#endif
   };
 
   applyParam(kCabAEnabled, 1.0);
@@ -6965,6 +7918,7 @@ void NeuralAmpModeler::_ApplyCabSlotSource(const int slotIndex, const bool force
 
 void NeuralAmpModeler::_RefreshCabControls()
 {
+#if IPLUG_EDITOR
   auto* pGraphics = GetUI();
   if (pGraphics == nullptr)
     return;
@@ -6972,10 +7926,12 @@ void NeuralAmpModeler::_RefreshCabControls()
   const bool showCabSection = (mTopNavActiveSection == TopNavSection::Cab);
   for (int slotIndex = 0; slotIndex < kCabSlotCount; ++slotIndex)
     _RefreshCabSlotControls(slotIndex);
+#endif
 }
 
 void NeuralAmpModeler::_RefreshCabSlotControls(const int slotIndex)
 {
+#if IPLUG_EDITOR
   auto* pGraphics = GetUI();
   if (pGraphics == nullptr)
     return;
@@ -7034,8 +7990,12 @@ void NeuralAmpModeler::_RefreshCabSlotControls(const int slotIndex)
     pPan->SetDisabled(!controlsEnabled);
     pPan->Hide(!showCabSection);
   }
+#else
+  (void) slotIndex;
+#endif
 }
 
+#if IPLUG_EDITOR
 void NeuralAmpModeler::_ShowCabSourceMenu(const int slotIndex, const IRECT& anchorArea)
 {
   auto* pGraphics = GetUI();
@@ -7075,6 +8035,7 @@ void NeuralAmpModeler::_ShowCabSourceMenu(const int slotIndex, const IRECT& anch
     pGraphics->CreatePopupMenu(*pSourceControl, menu, anchorArea);
   }
 }
+#endif
 
 void NeuralAmpModeler::_SetAmpSlotReleaseAsset(const int slotIndex, const ReleaseAmpAssetId assetId, int variantIndex)
 {
@@ -7164,70 +8125,61 @@ void NeuralAmpModeler::_SetAmpSlotModelPath(int slotIndex, const WDL_String& mod
     _SetAmpSlotSelectedVariant(slotIndex, variantIndex);
 }
 
-void NeuralAmpModeler::_ModelLoadWorkerLoop()
+void NeuralAmpModeler::_RunModelLoadJob(const ModelLoadJob& job)
 {
-  while (true)
+  const int slotIndex = std::clamp(job.slotIndex, 0, static_cast<int>(mAmpNAMPaths.size()) - 1);
+  const int variantIndex = _ResolveAmpSlotModelVariant(slotIndex, job.variantIndex);
+  const int storageIndex = _GetAmpSlotModelStorageIndex(slotIndex, variantIndex);
+  if (job.requestId != mSlotLoadRequestId[storageIndex].load(std::memory_order_relaxed))
   {
-    ModelLoadJob job;
-    {
-      std::unique_lock<std::mutex> lock(mModelLoadMutex);
-      mModelLoadCV.wait(lock, [this]() { return mModelLoadWorkerExit || !mModelLoadJobs.empty(); });
-      if (mModelLoadWorkerExit && mModelLoadJobs.empty())
-        return;
-      job = std::move(mModelLoadJobs.front());
-      mModelLoadJobs.pop_front();
-    }
-
-    const int slotIndex = std::clamp(job.slotIndex, 0, static_cast<int>(mAmpNAMPaths.size()) - 1);
-    const int variantIndex = _ResolveAmpSlotModelVariant(slotIndex, job.variantIndex);
-    const int storageIndex = _GetAmpSlotModelStorageIndex(slotIndex, variantIndex);
-    if (job.requestId != mSlotLoadRequestId[storageIndex].load(std::memory_order_relaxed))
-      continue;
+    NAM_TRACE_INSTANT("model-load-superseded", "loader");
+    return;
+  }
+  NAM_TRACE_SCOPE_ARG("model-load-job", "loader", "storageIndex", storageIndex);
 
-    bool success = false;
-    bool hasLoudness = false;
-    bool hasCalibration = false;
-    std::unique_ptr<ResamplingNAM> loadedModel;
-    std::unique_ptr<ResamplingNAM> loadedModelRight;
-    try
-    {
-      const double sampleRate = (job.sampleRate > 0.0) ? job.sampleRate : 48000.0;
-      const int blockSize = std::max(1, job.blockSize);
-      loadedModel = LoadResampledNAMForPath(job.modelPath, sampleRate, blockSize);
-      loadedModelRight = LoadResampledNAMForPath(job.modelPath, sampleRate, blockSize);
-      success = (loadedModel != nullptr) && (loadedModelRight != nullptr);
-      if (success)
-      {
-        hasLoudness = loadedModel->HasLoudness();
-        hasCalibration = loadedModel->HasOutputLevel();
-      }
-    }
-    catch (...)
+  bool success = false;
+  bool hasLoudness = false;
+  bool hasCalibration = false;
+  std::unique_ptr<ResamplingNAM> loadedModel;
+  std::unique_ptr<ResamplingNAM> loadedModelRight;
+  try
+  {
+    const double sampleRate = (job.sampleRate > 0.0) ? job.sampleRate : 48000.0;
+    const int blockSize = std::max(1, job.blockSize);
+    LoadResampledNAMPairForPath(
+      job.modelPath, sampleRate, blockSize, GetSlimmableSize(), loadedModel, loadedModelRight);
+    success = (loadedModel != nullptr) && (loadedModelRight != nullptr);
+    if (success)
     {
-      success = false;
+      hasLoudness = loadedModel->HasLoudness();
+      hasCalibration = loadedModel->HasOutputLevel();
     }
+  }
+  catch (...)
+  {
+    success = false;
+  }
 
-    if (job.requestId != mSlotLoadRequestId[storageIndex].load(std::memory_order_relaxed))
-      continue;
+  if (job.requestId != mSlotLoadRequestId[storageIndex].load(std::memory_order_relaxed))
+    return;
 
-    if (success)
-    {
-      if (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)])
-        _SetAmpSlotCapabilityState(slotIndex, hasLoudness, hasCalibration);
-      mPendingLoadedSlotRequestId[storageIndex].store(job.requestId, std::memory_order_release);
-      if (auto* oldPtr =
-            mPendingLoadedSlotModelRight[storageIndex].exchange(loadedModelRight.release(), std::memory_order_acq_rel))
-        delete oldPtr;
-      if (auto* oldPtr = mPendingLoadedSlotModel[storageIndex].exchange(loadedModel.release(), std::memory_order_acq_rel))
-        delete oldPtr;
-      mSlotLoadUIEvent[storageIndex].store(kSlotLoadUIEventLoaded, std::memory_order_relaxed);
-    }
-    else
-    {
-      if (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)])
-        _ClearAmpSlotCapabilityState(slotIndex);
-      mSlotLoadUIEvent[storageIndex].store(kSlotLoadUIEventFailed, std::memory_order_relaxed);
-    }
+  if (success)
+  {
+    if (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)])
+      _SetAmpSlotCapabilityState(slotIndex, hasLoudness, hasCalibration);
+    mPendingLoadedSlotRequestId[storageIndex].store(job.requestId, std::memory_order_release);
+    if (auto* oldPtr =
+          mPendingLoadedSlotModelRight[storageIndex].exchange(loadedModelRight.release(), std::memory_order_acq_rel))
+      delete oldPtr;
+    if (auto* oldPtr = mPendingLoadedSlotModel[storageIndex].exchange(loadedModel.release(), std::memory_order_acq_rel))
+      delete oldPtr;
+    mSlotLoadUIEvent[storageIndex].store(kSlotLoadUIEventLoaded, std::memory_order_relaxed);
+  }
+  else
+  {
+    if (variantIndex == mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)])
+      _ClearAmpSlotCapabilityState(slotIndex);
+    mSlotLoadUIEvent[storageIndex].store(kSlotLoadUIEventFailed, std::memory_order_relaxed);
   }
 }
 
@@ -7241,6 +8193,7 @@ void NeuralAmpModeler::_SelectAmpSlotModelVariant(int slotIndex, int variantInde
 
   mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)] = variantIndex;
   _SetAmpSlotSelectedVariant(slotIndex, variantIndex);
+  _RefreshModelLoadPriorities();
 
   if (slotIndex != mAmpSelectorIndex)
     return;
@@ -7280,6 +8233,7 @@ void NeuralAmpModeler::_SelectAmpSlot(int slotIndex)
 
   _CaptureAmpSlotState(mAmpSelectorIndex);
   mAmpSelectorIndex = slotIndex;
+  _RefreshModelLoadPriorities();
   _MarkStandalonePresetDirty();
   _SetAmpSlotSelectedVariant(slotIndex, mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)]);
   mPendingAmpModelSelection.store(_GetSelectedAmpSlotModelStorageIndex(slotIndex), std::memory_order_release);
@@ -7318,6 +8272,7 @@ void NeuralAmpModeler::_SelectAmpSlot(int slotIndex)
 
 void NeuralAmpModeler::_RefreshTopNavControls()
 {
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     const int ampSwitchBitmapTargetScale = std::max(2, pGraphics->GetRoundedScreenScale());
@@ -7720,6 +8675,7 @@ void NeuralAmpModeler::_RefreshTopNavControls()
     updateAmpSlot(kCtrlTagAmpSlot3, 2);
     _RefreshCabControls();
   }
+#endif
 }
 
 void NeuralAmpModeler::_SyncTunerParamToTopNav()
@@ -7947,6 +8903,41 @@ void NeuralAmpModeler::_CaptureAmpSlotState(int slotIndex)
 }
 
 void NeuralAmpModeler::_ApplyAmpSlotStateToToneStack(int slotIndex)
+{
+  slotIndex = std::clamp(slotIndex, 0, static_cast<int>(mToneStacks.size()) - 1);
+  if (mModelPipelineActive)
+  {
+    mPendingToneStackRefresh.fetch_or(1u << slotIndex, std::memory_order_release);
+    return;
+  }
+  _WriteAmpSlotStateToToneStack(slotIndex);
+}
+
+void NeuralAmpModeler::_ApplyCurrentAmpParamsToActiveToneStack()
+{
+  if (mModelPipelineActive)
+  {
+    mPendingToneStackRefresh.fetch_or(kPendingToneStackRefreshCurrentParams, std::memory_order_release);
+    return;
+  }
+  _WriteCurrentAmpParamsToActiveToneStack();
+}
+
+void NeuralAmpModeler::_ApplyPendingToneStackRefresh()
+{
+  const uint32_t pending = mPendingToneStackRefresh.exchange(0, std::memory_order_acquire);
+  if (pending == 0)
+    return;
+  // Rare (a tone control moved): the coefficient update is accepted on the audio thread here.
+  NAM_RT_ALLOW_UNSAFE();
+  for (int slotIndex = 0; slotIndex < static_cast<int>(mToneStacks.size()); ++slotIndex)
+    if ((pending & (1u << slotIndex)) != 0)
+      _WriteAmpSlotStateToToneStack(slotIndex);
+  if ((pending & kPendingToneStackRefreshCurrentParams) != 0)
+    _WriteCurrentAmpParamsToActiveToneStack();
+}
+
+void NeuralAmpModeler::_WriteAmpSlotStateToToneStack(int slotIndex)
 {
   slotIndex = std::clamp(slotIndex, 0, static_cast<int>(mToneStacks.size()) - 1);
   auto* toneStack = mToneStacks[slotIndex].get();
@@ -7974,7 +8965,7 @@ void NeuralAmpModeler::_ApplyAmpSlotStateToToneStack(int slotIndex)
                       _AmpSlotSpecSupportsControl(slotSpec, AmpControlId::AuxButton2) ? state.auxButton2 : 0.0);
 }
 
-void NeuralAmpModeler::_ApplyCurrentAmpParamsToActiveToneStack()
+void NeuralAmpModeler::_WriteCurrentAmpParamsToActiveToneStack()
 {
   const int activeSlot = std::clamp(mAmpSelectorIndex, 0, static_cast<int>(mToneStacks.size()) - 1);
   auto* toneStack = mToneStacks[activeSlot].get();
@@ -8066,6 +9057,7 @@ void NeuralAmpModeler::_AllocateIOPointers(const size_t nChans)
 
 void NeuralAmpModeler::_ApplyDSPStaging()
 {
+  NAM_TRACE_SCOPE("ApplyDSPStaging", "staging");
   const bool inputStereoMode = GetParam(kInputStereoMode)->Bool();
   bool triggerOutputDeClick = false;
   auto updateActiveModelGainsAndLatency = [this]() {
@@ -8133,6 +9125,7 @@ void NeuralAmpModeler::_ApplyDSPStaging()
       mAmpSlotModelState[previousSelection].store(prevState, std::memory_order_relaxed);
     }
 
+    NAM_TRACE_INSTANT("commit-amp-selection", "staging");
     mCurrentModelSlot = targetSlot;
     mCurrentModelVariant = targetVariant;
     if (haveReadyTargetModel)
@@ -8163,14 +9156,14 @@ void NeuralAmpModeler::_ApplyDSPStaging()
   };
   struct CabSlotIRRefs
   {
-    std::unique_ptr<dsp::ImpulseResponse>& livePrimary;
-    std::unique_ptr<dsp::ImpulseResponse>& livePrimaryChannel2;
-    std::unique_ptr<dsp::ImpulseResponse>& liveSecondary;
-    std::unique_ptr<dsp::ImpulseResponse>& liveSecondaryChannel2;
-    std::unique_ptr<dsp::ImpulseResponse>& stagedPrimary;
-    std::unique_ptr<dsp::ImpulseResponse>& stagedPrimaryChannel2;
-    std::unique_ptr<dsp::ImpulseResponse>& stagedSecondary;
-    std::unique_ptr<dsp::ImpulseResponse>& stagedSecondaryChannel2;
+    std::unique_ptr<AccountedImpulseResponse>& livePrimary;
+    std::unique_ptr<AccountedImpulseResponse>& livePrimaryChannel2;
+    std::unique_ptr<AccountedImpulseResponse>& liveSecondary;
+    std::unique_ptr<AccountedImpulseResponse>& liveSecondaryChannel2;
+    std::unique_ptr<AccountedImpulseResponse>& stagedPrimary;
+    std::unique_ptr<AccountedImpulseResponse>& stagedPrimaryChannel2;
+    std::unique_ptr<AccountedImpulseResponse>& stagedSecondary;
+    std::unique_ptr<AccountedImpulseResponse>& stagedSecondaryChannel2;
     std::atomic<bool>& removePrimary;
     std::atomic<bool>& removeSecondary;
     WDL_String& livePrimaryPath;
@@ -8251,6 +9244,7 @@ void NeuralAmpModeler::_ApplyDSPStaging()
     if (!stagePrimaryReady && !stageSecondaryReady && !removePrimary && !removeSecondary)
       return false;
 
+    NAM_TRACE_INSTANT("commit-cab-ir", "staging");
     const size_t slotArrayIndex = static_cast<size_t>(slotIndex);
     mPreviousCabSlotSourceChoice[slotArrayIndex] = mActiveCabSlotSourceChoice[slotArrayIndex];
     mPreviousCabSlotPosition[slotArrayIndex] = mActiveCabSlotPosition[slotArrayIndex];
@@ -8365,6 +9359,7 @@ void NeuralAmpModeler::_ApplyDSPStaging()
     if (pendingRequestId != activeRequestId)
       continue;
 
+    NAM_TRACE_INSTANT("commit-loaded-model", "staging");
     const int slotIndex = storageIndex / kAmpModelVariantCount;
     const int variantIndex = storageIndex % kAmpModelVariantCount;
     if (slotIndex == mCurrentModelSlot && variantIndex == mCurrentModelVariant)
@@ -8399,6 +9394,8 @@ void NeuralAmpModeler::_ApplyDSPStaging()
       mAmpSlotTransitionState = kAmpSlotTransitionStateFadeIn;
       mAmpSlotTransitionSamplesRemaining = kAmpSlotTransitionSamples;
       mAmpSlotTransitionTargetSelection = -1;
+      if (mModelPipelineActive)
+        mTransitionFadeInHoldSamples = mModelPipeline.GetLatency();
     }
     else
     {
@@ -8547,12 +9544,61 @@ void NeuralAmpModeler::_ApplyDSPStaging()
     {
       mPresetRecallMuteActive.store(false, std::memory_order_release);
       mPresetRecallTargetSlot.store(-1, std::memory_order_release);
+      if (mModelPipelineActive)
+        mPresetRecallMuteHoldSamples = mModelPipeline.GetLatency();
       triggerOutputDeClick = true;
     }
   }
 
   if (triggerOutputDeClick)
-    mAmpSwitchDeClickSamplesRemaining.store(kAmpSlotSwitchDeClickSamples, std::memory_order_relaxed);
+  {
+    if (mModelPipelineActive)
+      mPipelinedDeClickEvents.Push(true, mModelPipeline.GetLatency());
+    else
+      mAmpSwitchDeClickSamplesRemaining.store(kAmpSlotSwitchDeClickSamples, std::memory_order_relaxed);
+  }
+}
+
+bool NeuralAmpModeler::_ApplySlimmableSize()
+{
+  const double setting = std::clamp(mSlimmableSizeSetting.load(std::memory_order_relaxed), 0.0, 1.0);
+  double size = setting;
+  if (mSlimmableGovernorEnabled.load(std::memory_order_relaxed))
+    size = mSlimmableGovernor.GetSize(setting);
+  else
+    mSlimmableGovernor.Reset();
+  mSlimmableSizeApplied.store(size, std::memory_order_relaxed);
+
+  // Resizing a network can allocate, so it never happens here: the main thread sees the running size lag behind and
+  // has the loader rebuild the active model at the new size (_RequestSlimmableResize()), which then swaps in like any
+  // loaded model.
+  const double runningSize = (mModel != nullptr) ? mModel->GetSlimmableSize() : -1.0;
+  return mSlimmableSizeRunning.exchange(runningSize, std::memory_order_relaxed) != runningSize;
+}
+
+void NeuralAmpModeler::_RequestSlimmableResize()
+{
+  const double runningSize = mSlimmableSizeRunning.load(std::memory_order_relaxed);
+  const double size = GetSlimmableSize();
+  const int slotIndex = std::clamp(mAmpSelectorIndex, 0, static_cast<int>(mAmpNAMPaths.size()) - 1);
+  const int storageIndex = _GetSelectedAmpSlotModelStorageIndex(slotIndex);
+  if (runningSize < 0.0 || runningSize == size)
+  {
+    mSlimmableResizeRequestedSize = -1.0;
+    mSlimmableResizeRequestedStorageIndex = -1;
+    return;
+  }
+  // A rebuild for this size is already queued.
+  if (size == mSlimmableResizeRequestedSize && storageIndex == mSlimmableResizeRequestedStorageIndex)
+    return;
+  const WDL_String& modelPath = mAmpNAMPathsByVariant[static_cast<size_t>(storageIndex)];
+  if (modelPath.GetLength() == 0
+      || mAmpSlotModelState[storageIndex].load(std::memory_order_relaxed) != kAmpSlotModelStateReady)
+    return;
+
+  mSlimmableResizeRequestedSize = size;
+  mSlimmableResizeRequestedStorageIndex = storageIndex;
+  _SubmitModelLoadJob(slotIndex, mAmpSlotSelectedVariant[static_cast<size_t>(slotIndex)], modelPath);
 }
 
 void NeuralAmpModeler::_DeallocateIOPointers()
@@ -8633,14 +9679,15 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     mStompModelRightB->Reset(sampleRate, maxBlockSize);
   }
 
-  // IR
+  // IR (everything below re-samples; it runs to the end of the function)
+  NAM_STARTUP_PROFILE_SCOPE(IRLoad);
   if (mStagedIR != nullptr)
   {
     const double irSampleRate = mStagedIR->GetSampleRate();
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedIR->GetData();
-      mStagedIR = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIR = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mIR != nullptr)
@@ -8649,7 +9696,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mIR->GetData();
-      mStagedIR = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIR = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
       mStagedIRPath = mIRPath;
     }
   }
@@ -8659,7 +9706,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedIRChannel2->GetData();
-      mStagedIRChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mIRChannel2 != nullptr)
@@ -8668,7 +9715,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mIRChannel2->GetData();
-      mStagedIRChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   if (mStagedIRRight != nullptr)
@@ -8677,7 +9724,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedIRRight->GetData();
-      mStagedIRRight = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRRight = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mIRRight != nullptr)
@@ -8686,7 +9733,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mIRRight->GetData();
-      mStagedIRRight = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRRight = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
       mStagedIRPathRight = mIRPathRight;
     }
   }
@@ -8696,7 +9743,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedIRRightChannel2->GetData();
-      mStagedIRRightChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRRightChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mIRRightChannel2 != nullptr)
@@ -8705,7 +9752,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mIRRightChannel2->GetData();
-      mStagedIRRightChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedIRRightChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   if (mStagedCabBIR != nullptr)
@@ -8714,7 +9761,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedCabBIR->GetData();
-      mStagedCabBIR = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIR = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mCabBIR != nullptr)
@@ -8723,7 +9770,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mCabBIR->GetData();
-      mStagedCabBIR = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIR = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
       mStagedCabBIRPath = mCabBIRPath;
     }
   }
@@ -8733,7 +9780,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedCabBIRChannel2->GetData();
-      mStagedCabBIRChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mCabBIRChannel2 != nullptr)
@@ -8742,7 +9789,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mCabBIRChannel2->GetData();
-      mStagedCabBIRChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   if (mStagedCabBIRSecondary != nullptr)
@@ -8751,7 +9798,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedCabBIRSecondary->GetData();
-      mStagedCabBIRSecondary = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRSecondary = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mCabBIRSecondary != nullptr)
@@ -8760,7 +9807,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mCabBIRSecondary->GetData();
-      mStagedCabBIRSecondary = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRSecondary = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
       mStagedCabBIRSecondaryPath = mCabBIRSecondaryPath;
     }
   }
@@ -8770,7 +9817,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mStagedCabBIRSecondaryChannel2->GetData();
-      mStagedCabBIRSecondaryChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRSecondaryChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
   else if (mCabBIRSecondaryChannel2 != nullptr)
@@ -8779,7 +9826,7 @@ void NeuralAmpModeler::_ResetModelAndIR(const double sampleRate, const int maxBl
     if (irSampleRate != sampleRate)
     {
       const auto irData = mCabBIRSecondaryChannel2->GetData();
-      mStagedCabBIRSecondaryChannel2 = std::make_unique<dsp::ImpulseResponse>(irData, sampleRate);
+      mStagedCabBIRSecondaryChannel2 = std::make_unique<AccountedImpulseResponse>(irData, sampleRate);
     }
   }
 }
@@ -8794,6 +9841,90 @@ void NeuralAmpModeler::_SetInputGain()
   mInputGain = DBToAmp(inputGainDB);
 }
 
+void NeuralAmpModeler::_CollectMemoryReport(MemoryReport& report) const
+{
+  report.Clear();
+  const auto addModel = [&report](const MemoryCategory category, const char* name, const int index,
+                                  const std::unique_ptr<ResamplingNAM>& model) {
+    if (model != nullptr)
+      // The measured footprint already includes the wrapper itself; it's only 0 where heap usage can't be queried.
+      report.Add(category, name, index, std::max(sizeof(ResamplingNAM), model->GetMemoryFootprintBytes()));
+  };
+  const auto addIR = [&report](const MemoryCategory category, const char* name, const int index,
+                               const std::unique_ptr<AccountedImpulseResponse>& ir) {
+    if (ir != nullptr)
+      report.Add(category, name, index, ir->GetMemoryFootprintBytes());
+  };
+  const auto bufferBytes = [](const std::vector<iplug::sample>& buffer) {
+    return buffer.capacity() * sizeof(iplug::sample);
+  };
+
+  // Models handed over by the loader but not yet picked up (mPendingLoadedSlotModel*) are left out: the loader may
+  // replace and free them at any time. They are adopted into the slot cache within a block.
+  addModel(MemoryCategory::AmpModel, "model", -1, mModel);
+  addModel(MemoryCategory::AmpModel, "model-right", -1, mModelRight);
+  for (size_t i = 0; i < mAmpSlotModelCache.size(); ++i)
+  {
+    addModel(MemoryCategory::AmpModel, "slot-cache", static_cast<int>(i), mAmpSlotModelCache[i]);
+    addModel(MemoryCategory::AmpModel, "slot-cache-right", static_cast<int>(i), mAmpSlotModelCacheRight[i]);
+  }
+  addModel(MemoryCategory::StompModel, "stomp", -1, mStompModel);
+  addModel(MemoryCategory::StompModel, "stomp-right", -1, mStompModelRight);
+  addModel(MemoryCategory::StompModel, "stomp-b", -1, mStompModelB);
+  addModel(MemoryCategory::StompModel, "stomp-b-right", -1, mStompModelRightB);
+  addModel(MemoryCategory::StagedModel, "staged-model", -1, mStagedModel);
+  addModel(MemoryCategory::StagedModel, "staged-model-right", -1, mStagedModelRight);
+  addModel(MemoryCategory::StagedModel, "staged-stomp", -1, mStagedStompModel);
+  addModel(MemoryCategory::StagedModel, "staged-stomp-right", -1, mStagedStompModelRight);
+  addModel(MemoryCategory::StagedModel, "staged-stomp-b", -1, mStagedStompModelB);
+  addModel(MemoryCategory::StagedModel, "staged-stomp-b-right", -1, mStagedStompModelRightB);
+
+  addIR(MemoryCategory::IR, "ir", -1, mIR);
+  addIR(MemoryCategory::IR, "ir-ch2", -1, mIRChannel2);
+  addIR(MemoryCategory::IR, "ir-right", -1, mIRRight);
+  addIR(MemoryCategory::IR, "ir-right-ch2", -1, mIRRightChannel2);
+  addIR(MemoryCategory::IR, "cab-b-ir", -1, mCabBIR);
+  addIR(MemoryCategory::IR, "cab-b-ir-ch2", -1, mCabBIRChannel2);
+  addIR(MemoryCategory::IR, "cab-b-ir-secondary", -1, mCabBIRSecondary);
+  addIR(MemoryCategory::IR, "cab-b-ir-secondary-ch2", -1, mCabBIRSecondaryChannel2);
+  addIR(MemoryCategory::StagedIR, "staged-ir", -1, mStagedIR);
+  addIR(MemoryCategory::StagedIR, "staged-ir-ch2", -1, mStagedIRChannel2);
+  addIR(MemoryCategory::StagedIR, "staged-ir-right", -1, mStagedIRRight);
+  addIR(MemoryCategory::StagedIR, "staged-ir-right-ch2", -1, mStagedIRRightChannel2);
+  addIR(MemoryCategory::StagedIR, "staged-cab-b-ir", -1, mStagedCabBIR);
+  addIR(MemoryCategory::StagedIR, "staged-cab-b-ir-ch2", -1, mStagedCabBIRChannel2);
+  addIR(MemoryCategory::StagedIR, "staged-cab-b-ir-secondary", -1, mStagedCabBIRSecondary);
+  addIR(MemoryCategory::StagedIR, "staged-cab-b-ir-secondary-ch2", -1, mStagedCabBIRSecondaryChannel2);
+  for (size_t slot = 0; slot < mPreviousCabPrimaryIR.size(); ++slot)
+  {
+    const int index = static_cast<int>(slot);
+    addIR(MemoryCategory::PreviousIR, "previous-cab-primary", index, mPreviousCabPrimaryIR[slot]);
+    addIR(MemoryCategory::PreviousIR, "previous-cab-primary-ch2", index, mPreviousCabPrimaryIRChannel2[slot]);
+    addIR(MemoryCategory::PreviousIR, "previous-cab-secondary", index, mPreviousCabSecondaryIR[slot]);
+    addIR(MemoryCategory::PreviousIR, "previous-cab-secondary-ch2", index, mPreviousCabSecondaryIRChannel2[slot]);
+  }
+
+  size_t delayBytes = 0;
+  size_t reverbBytes = 0;
+  size_t doublerBytes = 0;
+  for (size_t c = 0; c < kNumChannelsInternal; ++c)
+  {
+    delayBytes += bufferBytes(mFXDelayBuffer[c]);
+    reverbBytes += bufferBytes(mFXReverbPreDelayBuffer[c]);
+    for (const auto& buffer : mFXReverbPreDiffAllpassBuffer[c])
+      reverbBytes += bufferBytes(buffer);
+    for (const auto& buffer : mFXReverbCombBuffer[c])
+      reverbBytes += bufferBytes(buffer);
+    for (const auto& buffer : mFXReverbAllpassBuffer[c])
+      reverbBytes += bufferBytes(buffer);
+    doublerBytes += bufferBytes(mVirtualDoubleBuffer[c]);
+  }
+  report.Add(MemoryCategory::FXBuffer, "delay", -1, delayBytes);
+  report.Add(MemoryCategory::FXBuffer, "reverb", -1, reverbBytes);
+  report.Add(MemoryCategory::FXBuffer, "doubler", -1, doublerBytes);
+  report.Add(MemoryCategory::Tuner, "tuner", -1, sizeof(mTunerAnalyzer));
+}
+
 double NeuralAmpModeler::_GetOutputGainForModel(ResamplingNAM* model) const
 {
   double gainDB = GetParam(kOutputLevel)->Value();
@@ -8871,20 +10002,206 @@ void NeuralAmpModeler::_UpdateActiveAmpMasterState(const int slotIndex)
   }
 }
 
+void NeuralAmpModeler::_ProcessAmpModelStage(const AmpModelStageJob& job, iplug::sample** inputs,
+                                             iplug::sample** outputs, const int nFrames)
+{
+  const size_t numFrames = static_cast<size_t>(nFrames);
+  if (job.model == nullptr)
+  {
+    for (size_t c = 0; c < job.numChannels; ++c)
+      std::copy_n(inputs[c], numFrames, outputs[c]);
+    return;
+  }
+
+  _ProcessAmpModel(*job.model, job.modelRight, inputs, outputs, job.numChannels, job.bypassSide, nFrames);
+  if (job.numChannels < 2 || numFrames == 0)
+    return;
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    if (job.bypassSide[c])
+    {
+      mStereoSideResumePrevSample[c] = static_cast<double>(outputs[c][numFrames - 1]);
+      mStereoSideResumeDeClickSamplesRemaining[c] = 0;
+      continue;
+    }
+
+    int declickRemaining = mStereoSideResumeDeClickSamplesRemaining[c];
+    if (declickRemaining > 0)
+    {
+      const int framesToSmooth = static_cast<int>(std::min(numFrames, static_cast<size_t>(declickRemaining)));
+      double prev = mStereoSideResumePrevSample[c];
+      int channelRemaining = declickRemaining;
+      for (int s = 0; s < framesToSmooth; ++s)
+      {
+        const double t =
+          1.0 - static_cast<double>(channelRemaining - 1) / static_cast<double>(kStereoSideBypassResumeDeClickSamples);
+        const double blended = (1.0 - t) * prev + t * static_cast<double>(outputs[c][s]);
+        outputs[c][s] = static_cast<iplug::sample>(blended);
+        prev = blended;
+        --channelRemaining;
+      }
+      if (numFrames > static_cast<size_t>(framesToSmooth))
+        prev = static_cast<double>(outputs[c][numFrames - 1]);
+      mStereoSideResumePrevSample[c] = prev;
+      declickRemaining -= framesToSmooth;
+      mStereoSideResumeDeClickSamplesRemaining[c] = std::max(0, declickRemaining);
+    }
+    else
+    {
+      mStereoSideResumePrevSample[c] = static_cast<double>(outputs[c][numFrames - 1]);
+    }
+  }
+}
+
+void NeuralAmpModeler::_ProcessAmpModelCrossfade(const AmpModelStageJob& job, iplug::sample** inputs,
+                                                 iplug::sample** outputs, const int nFrames)
+{
+  if (job.model == nullptr || job.crossfadeTarget == nullptr)
+    return;
+
+  const size_t numFrames = static_cast<size_t>(nFrames);
+  iplug::sample* crossfadeTargetPointers[kNumChannelsInternal] = {
+    mAmpModelCrossfadeArray[0].data(),
+    mAmpModelCrossfadeArray[1].data()
+  };
+  _ProcessAmpModel(*job.crossfadeTarget, job.crossfadeTargetRight, inputs, crossfadeTargetPointers, job.numChannels,
+                   job.bypassSide, nFrames);
+
+  int crossfadeRemaining = mAmpModelCrossfadeSamplesRemaining;
+  for (size_t s = 0; s < numFrames; ++s)
+  {
+    const double mix =
+      (crossfadeRemaining > 0)
+        ? std::clamp(1.0 - static_cast<double>(crossfadeRemaining - 1)
+                             / static_cast<double>(kAmpModelVariantCrossfadeSamples),
+                     0.0,
+                     1.0)
+        : 1.0;
+    for (size_t c = 0; c < job.numChannels; ++c)
+    {
+      const double currentSample = static_cast<double>(outputs[c][s]);
+      const double targetSample =
+        static_cast<double>(crossfadeTargetPointers[c][s]) * job.crossfadeTargetOutputGainScale;
+      outputs[c][s] = static_cast<iplug::sample>((1.0 - mix) * currentSample + mix * targetSample);
+    }
+    if (crossfadeRemaining > 0)
+      --crossfadeRemaining;
+  }
+  mAmpModelCrossfadeSamplesRemaining = std::max(0, crossfadeRemaining);
+}
+
+void NeuralAmpModeler::_RunPipelinedAmpModelStage(void* context, iplug::sample** inputs, iplug::sample** outputs,
+                                                  const int nFrames)
+{
+  // Same real-time rules as ProcessBlock(): the callback waits on this.
+  NAM_RT_SCOPE();
+  NAM_TRACE_THREAD_NAME("model-pipeline");
+  NAM_TRACE_SCOPE_ARG("AmpModelStage", "model-pipeline", "frames", nFrames);
+  auto* plug = static_cast<NeuralAmpModeler*>(context);
+  plug->_ProcessAmpModelStage(plug->mPipelinedAmpModelStageJob, inputs, outputs, nFrames);
+  plug->_ProcessAmpModelCrossfade(plug->mPipelinedAmpModelStageJob, inputs, outputs, nFrames);
+  plug->_ProcessAmpPostModelStage(plug->mPipelinedAmpModelStageJob, outputs, nFrames);
+}
+
+void NeuralAmpModeler::_ProcessAmpPostModelStage(const AmpModelStageJob& job, iplug::sample** outputs,
+                                                 const int nFrames)
+{
+  if (job.toneStack != nullptr)
+  {
+    iplug::sample** toneStackPointers = job.toneStack->Process(outputs, static_cast<int>(job.numChannels), nFrames);
+    for (size_t c = 0; c < job.numChannels; ++c)
+      if (toneStackPointers[c] != outputs[c])
+        std::copy_n(toneStackPointers[c], static_cast<size_t>(nFrames), outputs[c]);
+  }
+  if (job.masterActive)
+    _ProcessAmpMasterStage(job.master, outputs, job.numChannels, static_cast<size_t>(nFrames));
+}
+
+void NeuralAmpModeler::_ProcessAmpModel(ResamplingNAM& model, ResamplingNAM* modelRight, iplug::sample** inputs,
+                                        iplug::sample** outputs, const size_t numChannels,
+                                        const std::array<bool, 2>& bypassSide, const int nFrames)
+{
+  if (numChannels == 1)
+  {
+    model.process(inputs, outputs, nFrames);
+    return;
+  }
+
+  // The left and right instances hold separate copies of the weights and their own layer state, so the pair can't
+  // share a batched (two-column) pass; NeuralAmpModelerCore only takes one channel per model. They are independent,
+  // though, so the right one can run on the fork-join pool while this thread runs the left. Not under the pipelined
+  // model stage: that already runs the pair off the audio thread, and its worker would only wait on the pool.
+  struct SideJob
+  {
+    ResamplingNAM* model;
+    iplug::sample* input;
+    iplug::sample* output;
+    int nFrames;
+    bool bypass;
+
+    void Run() const
+    {
+      if (bypass)
+      {
+        std::copy_n(input, static_cast<size_t>(nFrames), output);
+        return;
+      }
+      iplug::sample* sideIn[1] = {input};
+      iplug::sample* sideOut[1] = {output};
+      model->process(sideIn, sideOut, nFrames);
+    }
+  };
+  const SideJob left{&model, inputs[0], outputs[0], nFrames, bypassSide[0]};
+  SideJob right{modelRight, inputs[1], outputs[1], nFrames, bypassSide[1]};
+  const bool fork = mStereoForkJoin.IsRunning() && !mModelPipelineActive && nFrames >= kStereoForkJoinMinFrames
+                    && !left.bypass && !right.bypass;
+  if (!fork)
+  {
+    left.Run();
+    right.Run();
+    return;
+  }
+  mStereoForkJoin.Fork(
+    [](void* context) {
+      NAM_RT_SCOPE();
+      static_cast<SideJob*>(context)->Run();
+    },
+    &right);
+  left.Run();
+  mStereoForkJoin.Join();
+}
+
+NeuralAmpModeler::AmpMasterStageParams NeuralAmpModeler::_GetAmpMasterStageParams() const
+{
+  AmpMasterStageParams params;
+  params.behavior = mActiveAmpMasterBehavior;
+  params.gain = mActiveAmpMasterGain;
+  params.saturationDrive = mActiveAmpMasterSaturationDrive;
+  params.saturationMix = mActiveAmpMasterSaturationMix;
+  params.saturationMakeupGain = mActiveAmpMasterSaturationMakeupGain;
+  return params;
+}
+
 void NeuralAmpModeler::_ProcessAmpMasterStage(iplug::sample** inputs, const size_t numChannels, const size_t numFrames)
+{
+  _ProcessAmpMasterStage(_GetAmpMasterStageParams(), inputs, numChannels, numFrames);
+}
+
+void NeuralAmpModeler::_ProcessAmpMasterStage(const AmpMasterStageParams& params, iplug::sample** inputs,
+                                              const size_t numChannels, const size_t numFrames)
 {
   if (inputs == nullptr)
     return;
 
-  switch (mActiveAmpMasterBehavior)
+  switch (params.behavior)
   {
     case MasterBehaviorKind::Amp2Saturating:
     {
-      const float wet = static_cast<float>(std::clamp(mActiveAmpMasterSaturationMix, 0.0, 1.0));
-      const float drive = static_cast<float>(std::max(1.0, mActiveAmpMasterSaturationDrive));
+      const float wet = static_cast<float>(std::clamp(params.saturationMix, 0.0, 1.0));
+      const float drive = static_cast<float>(std::max(1.0, params.saturationDrive));
       const float inverseDrive = 1.0f / drive;
-      const float outputGain =
-        static_cast<float>(mActiveAmpMasterGain * std::max(1.0, mActiveAmpMasterSaturationMakeupGain));
+      const float outputGain = static_cast<float>(params.gain * std::max(1.0, params.saturationMakeupGain));
       if (wet <= 0.0f && outputGain == 1.0f)
         return;
 
@@ -8905,7 +10222,7 @@ void NeuralAmpModeler::_ProcessAmpMasterStage(iplug::sample** inputs, const size
     }
     case MasterBehaviorKind::Standard:
     default:
-      if (mActiveAmpMasterGain == 1.0)
+      if (params.gain == 1.0)
         return;
 
       for (size_t c = 0; c < numChannels; ++c)
@@ -8914,18 +10231,22 @@ void NeuralAmpModeler::_ProcessAmpMasterStage(iplug::sample** inputs, const size
           continue;
 
         for (size_t s = 0; s < numFrames; ++s)
-          inputs[c][s] *= mActiveAmpMasterGain;
+          inputs[c][s] *= params.gain;
       }
       break;
   }
 }
 
 #if NAM_DEV_DIAGNOSTICS
-void NeuralAmpModeler::_PublishDevDiagnosticsDSPTiming(const size_t numFrames, const double elapsedSeconds)
+void NeuralAmpModeler::_PublishDevDiagnosticsDSPTiming(const size_t numFrames, const double elapsedSeconds,
+                                                        const DevDiagnosticsStageLaps& stageLaps)
 {
   if (numFrames == 0)
     return;
 
+  mDevDiagnosticsStageTiming.BeginBlock();
+  mDevDiagnosticsStageTiming.Record(stageLaps);
+
   const double elapsedNs = std::max(0.0, elapsedSeconds) * 1.0e9;
   constexpr double kDSPAverageAlpha = 0.10;
   constexpr double kDSPPeakHoldDecay = 0.995;
@@ -8949,8 +10270,27 @@ void NeuralAmpModeler::_PublishDevDiagnosticsDSPTiming(const size_t numFrames, c
     std::memory_order_relaxed);
 }
 
+bool NeuralAmpModeler::_WriteDevDiagnosticsStageTimingCSV(const char* path) const
+{
+  if (path == nullptr || path[0] == '\0')
+    return false;
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+    return false;
+  mDevDiagnosticsStageTiming.WriteCSV(file);
+  return file.good();
+}
+
+void NeuralAmpModeler::_DumpDevDiagnosticsStageTimingCSV()
+{
+  const std::string path = MakeTimestampedDesktopPath("NAM-stage-timing", ".csv");
+  if (!path.empty())
+    _WriteDevDiagnosticsStageTimingCSV(path.c_str());
+}
+
 void NeuralAmpModeler::_RefreshDevDiagnostics()
 {
+#if IPLUG_EDITOR
   auto* pGraphics = GetUI();
   if (pGraphics == nullptr)
     return;
@@ -9055,6 +10395,34 @@ void NeuralAmpModeler::_RefreshDevDiagnostics()
 #else
   diagnosticsText << "  DSPLat " << dspLatencyMs << " ms";
 #endif
+  // The three most expensive stages by P99 since the last reset; click the overlay for the full CSV.
+  std::array<std::pair<double, DevDiagnosticsStage>, kDevDiagnosticsStageCount> stageP99 = {};
+  for (size_t s = 0; s < kDevDiagnosticsStageCount; ++s)
+  {
+    const auto stage = static_cast<DevDiagnosticsStage>(s);
+    stageP99[s] = {mDevDiagnosticsStageTiming.GetStats(stage).p99Ns, stage};
+  }
+  std::partial_sort(stageP99.begin(), stageP99.begin() + 3, stageP99.end(),
+                    [](const auto& a, const auto& b) { return a.first > b.first; });
+  diagnosticsText << "\nStg p99";
+  for (size_t i = 0; i < 3 && stageP99[i].first > 0.0; ++i)
+    diagnosticsText << "  " << GetDevDiagnosticsStageName(stageP99[i].second) << " " << stageP99[i].first * 1.0e-3;
+  diagnosticsText << " us  [click: CSV]";
+  if (mDevDiagnosticsMemoryReportReady.load(std::memory_order_acquire))
+  {
+    for (size_t c = 0; c < kMemoryCategoryCount; ++c)
+      mDevDiagnosticsMemoryBytes[c] = mDevDiagnosticsMemoryReport.GetTotalBytes(static_cast<MemoryCategory>(c));
+    mDevDiagnosticsMemoryReportReady.store(false, std::memory_order_relaxed);
+    mDevDiagnosticsMemoryReportRequested.store(true, std::memory_order_release);
+  }
+  const auto memoryMB = [this](const MemoryCategory category) {
+    return static_cast<double>(mDevDiagnosticsMemoryBytes[static_cast<size_t>(category)]) / (1024.0 * 1024.0);
+  };
+  diagnosticsText << "\nMem amp " << memoryMB(MemoryCategory::AmpModel) << "  stomp "
+                  << memoryMB(MemoryCategory::StompModel) << "  stg " << memoryMB(MemoryCategory::StagedModel)
+                  << "  IR " << memoryMB(MemoryCategory::IR) << "/" << memoryMB(MemoryCategory::StagedIR) << "/"
+                  << memoryMB(MemoryCategory::PreviousIR) << "  FX " << memoryMB(MemoryCategory::FXBuffer) << "  Tun "
+                  << memoryMB(MemoryCategory::Tuner) << " MB";
   const auto tunerDebug = mTunerAnalyzer.DebugSnapshot();
   diagnosticsText << "\nTun raw ";
   if (tunerDebug.candidateValid)
@@ -9090,6 +10458,7 @@ void NeuralAmpModeler::_RefreshDevDiagnostics()
     mLastDevDiagnosticsText.Set(text.c_str());
     pText->SetDirty(false);
   }
+#endif
 }
 #endif
 
@@ -9436,8 +10805,10 @@ std::string NeuralAmpModeler::_StageModel(const WDL_String& modelPath, int slotI
   WDL_String previousSlotPath = mAmpNAMPaths[slotIndex];
   try
   {
-    auto stagedModel = LoadResampledNAMForPath(modelPath, GetSampleRate(), GetBlockSize());
-    auto stagedModelRight = LoadResampledNAMForPath(modelPath, GetSampleRate(), GetBlockSize());
+    std::unique_ptr<ResamplingNAM> stagedModel;
+    std::unique_ptr<ResamplingNAM> stagedModelRight;
+    LoadResampledNAMPairForPath(modelPath, GetSampleRate(), GetBlockSize(), GetSlimmableSize(), stagedModel,
+                                stagedModelRight);
     _SetAmpSlotCapabilityState(
       slotIndex, (stagedModel != nullptr) && stagedModel->HasLoudness(),
       (stagedModel != nullptr) && stagedModel->HasOutputLevel());
@@ -9490,8 +10861,10 @@ std::string NeuralAmpModeler::_StageStompModel(const WDL_String& modelPath, int
   WDL_String previousNAMPath = targetNAMPath;
   try
   {
-    auto stagedStompModel = LoadResampledNAMForPath(modelPath, GetSampleRate(), GetBlockSize());
-    auto stagedStompModelRight = LoadResampledNAMForPath(modelPath, GetSampleRate(), GetBlockSize());
+    std::unique_ptr<ResamplingNAM> stagedStompModel;
+    std::unique_ptr<ResamplingNAM> stagedStompModelRight;
+    LoadResampledNAMPairForPath(modelPath, GetSampleRate(), GetBlockSize(), GetSlimmableSize(), stagedStompModel,
+                                stagedStompModelRight);
     // Publish stereo companion first; publish primary last to avoid half-swapped stereo state.
     targetStagedModelRight = std::move(stagedStompModelRight);
     targetStagedModel = std::move(stagedStompModel);
@@ -9519,22 +10892,24 @@ std::string NeuralAmpModeler::_StageStompModel(const WDL_String& modelPath, int
 
 dsp::wav::LoadReturnCode NeuralAmpModeler::_StageIRLeft(const WDL_String& irPath, const bool notifyUI)
 {
+  NAM_TRACE_SCOPE("stage-ir-left", "ir");
   WDL_String previousIRPath = mIRPath;
   const double sampleRate = GetSampleRate();
   dsp::wav::LoadReturnCode wavState = dsp::wav::LoadReturnCode::ERROR_OTHER;
   try
   {
-    auto stagedIR = std::unique_ptr<dsp::ImpulseResponse>();
-    auto stagedIRChannel2 = std::unique_ptr<dsp::ImpulseResponse>();
+    auto stagedIR = std::unique_ptr<AccountedImpulseResponse>();
+    auto stagedIRChannel2 = std::unique_ptr<AccountedImpulseResponse>();
     const bool stagedEmbedded =
       StageEmbeddedCuratedCabIR(irPath, sampleRate, stagedIR, stagedIRChannel2, wavState);
     if (!stagedEmbedded)
     {
+      NAM_STARTUP_PROFILE_SCOPE(IRLoad);
       auto irPathU8 = std::filesystem::u8path(irPath.Get());
-      stagedIR = std::make_unique<dsp::ImpulseResponse>(irPathU8.string().c_str(), sampleRate);
+      stagedIR = std::make_unique<AccountedImpulseResponse>(irPathU8.string().c_str(), sampleRate);
       wavState = stagedIR->GetWavState();
       if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
-        stagedIRChannel2 = std::make_unique<dsp::ImpulseResponse>(stagedIR->GetData(), sampleRate);
+        stagedIRChannel2 = std::make_unique<AccountedImpulseResponse>(stagedIR->GetData(), sampleRate);
     }
     if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
     {
@@ -9578,22 +10953,24 @@ dsp::wav::LoadReturnCode NeuralAmpModeler::_StageIRLeft(const WDL_String& irPath
 
 dsp::wav::LoadReturnCode NeuralAmpModeler::_StageIRRight(const WDL_String& irPath, const bool notifyUI)
 {
+  NAM_TRACE_SCOPE("stage-ir-right", "ir");
   WDL_String previousIRPath = mIRPathRight;
   const double sampleRate = GetSampleRate();
   dsp::wav::LoadReturnCode wavState = dsp::wav::LoadReturnCode::ERROR_OTHER;
   try
   {
-    auto stagedIRRight = std::unique_ptr<dsp::ImpulseResponse>();
-    auto stagedIRRightChannel2 = std::unique_ptr<dsp::ImpulseResponse>();
+    auto stagedIRRight = std::unique_ptr<AccountedImpulseResponse>();
+    auto stagedIRRightChannel2 = std::unique_ptr<AccountedImpulseResponse>();
     const bool stagedEmbedded =
       StageEmbeddedCuratedCabIR(irPath, sampleRate, stagedIRRight, stagedIRRightChannel2, wavState);
     if (!stagedEmbedded)
     {
+      NAM_STARTUP_PROFILE_SCOPE(IRLoad);
       auto irPathU8 = std::filesystem::u8path(irPath.Get());
-      stagedIRRight = std::make_unique<dsp::ImpulseResponse>(irPathU8.string().c_str(), sampleRate);
+      stagedIRRight = std::make_unique<AccountedImpulseResponse>(irPathU8.string().c_str(), sampleRate);
       wavState = stagedIRRight->GetWavState();
       if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
-        stagedIRRightChannel2 = std::make_unique<dsp::ImpulseResponse>(stagedIRRight->GetData(), sampleRate);
+        stagedIRRightChannel2 = std::make_unique<AccountedImpulseResponse>(stagedIRRight->GetData(), sampleRate);
     }
     if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
     {
@@ -9634,22 +11011,24 @@ dsp::wav::LoadReturnCode NeuralAmpModeler::_StageIRRight(const WDL_String& irPat
 
 dsp::wav::LoadReturnCode NeuralAmpModeler::_StageCabBIRPrimary(const WDL_String& irPath)
 {
+  NAM_TRACE_SCOPE("stage-cab-b-ir-primary", "ir");
   WDL_String previousIRPath = mCabBIRPath;
   const double sampleRate = GetSampleRate();
   dsp::wav::LoadReturnCode wavState = dsp::wav::LoadReturnCode::ERROR_OTHER;
   try
   {
-    auto stagedIR = std::unique_ptr<dsp::ImpulseResponse>();
-    auto stagedIRChannel2 = std::unique_ptr<dsp::ImpulseResponse>();
+    auto stagedIR = std::unique_ptr<AccountedImpulseResponse>();
+    auto stagedIRChannel2 = std::unique_ptr<AccountedImpulseResponse>();
     const bool stagedEmbedded =
       StageEmbeddedCuratedCabIR(irPath, sampleRate, stagedIR, stagedIRChannel2, wavState);
     if (!stagedEmbedded)
     {
+      NAM_STARTUP_PROFILE_SCOPE(IRLoad);
       auto irPathU8 = std::filesystem::u8path(irPath.Get());
-      stagedIR = std::make_unique<dsp::ImpulseResponse>(irPathU8.string().c_str(), sampleRate);
+      stagedIR = std::make_unique<AccountedImpulseResponse>(irPathU8.string().c_str(), sampleRate);
       wavState = stagedIR->GetWavState();
       if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
-        stagedIRChannel2 = std::make_unique<dsp::ImpulseResponse>(stagedIR->GetData(), sampleRate);
+        stagedIRChannel2 = std::make_unique<AccountedImpulseResponse>(stagedIR->GetData(), sampleRate);
     }
     if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
     {
@@ -9677,22 +11056,24 @@ dsp::wav::LoadReturnCode NeuralAmpModeler::_StageCabBIRPrimary(const WDL_String&
 
 dsp::wav::LoadReturnCode NeuralAmpModeler::_StageCabBIRSecondary(const WDL_String& irPath)
 {
+  NAM_TRACE_SCOPE("stage-cab-b-ir-secondary", "ir");
   WDL_String previousIRPath = mCabBIRSecondaryPath;
   const double sampleRate = GetSampleRate();
   dsp::wav::LoadReturnCode wavState = dsp::wav::LoadReturnCode::ERROR_OTHER;
   try
   {
-    auto stagedIR = std::unique_ptr<dsp::ImpulseResponse>();
-    auto stagedIRChannel2 = std::unique_ptr<dsp::ImpulseResponse>();
+    auto stagedIR = std::unique_ptr<AccountedImpulseResponse>();
+    auto stagedIRChannel2 = std::unique_ptr<AccountedImpulseResponse>();
     const bool stagedEmbedded =
       StageEmbeddedCuratedCabIR(irPath, sampleRate, stagedIR, stagedIRChannel2, wavState);
     if (!stagedEmbedded)
     {
+      NAM_STARTUP_PROFILE_SCOPE(IRLoad);
       auto irPathU8 = std::filesystem::u8path(irPath.Get());
-      stagedIR = std::make_unique<dsp::ImpulseResponse>(irPathU8.string().c_str(), sampleRate);
+      stagedIR = std::make_unique<AccountedImpulseResponse>(irPathU8.string().c_str(), sampleRate);
       wavState = stagedIR->GetWavState();
       if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
-        stagedIRChannel2 = std::make_unique<dsp::ImpulseResponse>(stagedIR->GetData(), sampleRate);
+        stagedIRChannel2 = std::make_unique<AccountedImpulseResponse>(stagedIR->GetData(), sampleRate);
     }
     if (wavState == dsp::wav::LoadReturnCode::SUCCESS)
     {
@@ -9854,7 +11235,8 @@ void NeuralAmpModeler::_ProcessInput(iplug::sample** inputs, const size_t nFrame
 void NeuralAmpModeler::_ProcessOutput(iplug::sample** inputs, iplug::sample** outputs, const size_t nFrames,
                                       const size_t nChansIn, const size_t nChansOut)
 {
-  _ProcessOutputWithTargetGain(inputs, outputs, nFrames, nChansIn, nChansOut, mOutputGain);
+  _ProcessOutputWithTargetGain(
+    inputs, outputs, nFrames, nChansIn, nChansOut, mModelPipelineActive ? mPipelinedOutputGain : mOutputGain);
 }
 
 void NeuralAmpModeler::_ProcessOutputWithTargetGain(iplug::sample** inputs, iplug::sample** outputs, const size_t nFrames,
@@ -9958,6 +11340,7 @@ void NeuralAmpModeler::_UpdateControlsFromModel()
   {
     return;
   }
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     ModelInfo modelInfo;
@@ -9974,11 +11357,13 @@ void NeuralAmpModeler::_UpdateControlsFromModel()
     pGraphics->GetControlWithTag(kCtrlTagCalibrateInput)->SetDisabled(disableInputCalibrationControls);
     pGraphics->GetControlWithTag(kCtrlTagInputCalibrationLevel)->SetDisabled(disableInputCalibrationControls);
   }
+#endif
   _RefreshOutputModeControlSupport();
 }
 
 void NeuralAmpModeler::_RefreshOutputModeControlSupport()
 {
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     auto* outputModeControl = dynamic_cast<OutputModeControl*>(pGraphics->GetControlWithTag(kCtrlTagOutputMode));
@@ -9990,6 +11375,7 @@ void NeuralAmpModeler::_RefreshOutputModeControlSupport()
     outputModeControl->SetNormalizedDisable(!normalizedSupported);
     outputModeControl->SetCalibratedDisable(!calibratedSupported);
   }
+#endif
 }
 
 void NeuralAmpModeler::_SetAmpSlotCapabilityState(const int slotIndex, const bool hasLoudness, const bool hasCalibration)
@@ -10023,6 +11409,7 @@ void NeuralAmpModeler::_RefreshSelectedBoostCapabilityState()
 
 void NeuralAmpModeler::_RefreshModelCapabilityIndicators()
 {
+#if IPLUG_EDITOR
   if (auto* pGraphics = GetUI())
   {
     auto updateCheck = [pGraphics](const int ctrlTag, const bool checked) {
@@ -10040,6 +11427,7 @@ void NeuralAmpModeler::_RefreshModelCapabilityIndicators()
     updateCheck(kCtrlTagStompHasLoudness, mStompHasLoudness.load(std::memory_order_relaxed));
     updateCheck(kCtrlTagStompHasCalibration, mStompHasCalibration.load(std::memory_order_relaxed));
   }
+#endif
 }
 
 void NeuralAmpModeler::_UpdateLatency()
@@ -10062,6 +11450,8 @@ void NeuralAmpModeler::_UpdateLatency()
     }
   }
   latency += ampLatency;
+  if (mModelPipelineActive)
+    latency += mModelPipeline.GetLatency();
   // Other things that add latency here...
 
   // Feels weird to have to do this.
@@ -13,13 +13,27 @@
 #include "../AudioDSPTools/dsp/wav.h"
 #include "../AudioDSPTools/dsp/ResamplingContainer/ResamplingContainer.h"
 #include "../NeuralAmpModelerCore/NAM/dsp.h"
+#include "../NeuralAmpModelerCore/NAM/slimmable.h"
 
+#if IPLUG_EDITOR
 #include "Colors.h"
+#endif
+#include "DevDiagnosticsStageTiming.h"
+#include "ForkJoinExecutor.h"
+#include "MemoryAccounting.h"
+#include "ModelLoadPool.h"
+#include "ModelPipeline.h"
+#include "SlimmableGovernor.h"
+#include "StartupProfile.h"
 #include "TunerAnalyzer.h"
 #include "ToneStack.h"
 #include "TransposeShifter.h"
 
+#if defined(HEADLESS_API)
+#include "headless/IPlugHeadless_include_in_plug_hdr.h"
+#else
 #include "IPlug_include_in_plug_hdr.h"
+#endif
 #include "ISender.h"
 
 
@@ -243,11 +257,58 @@ inline double GetNAMSampleRate(const std::unique_ptr<nam::DSP>& model)
   return encapsulatedSampleRate;
 };
 
+// dsp::ImpulseResponse that remembers roughly how much memory it holds, so the memory report can read it without
+// touching the IR's internals (the audio thread owns those). The estimate is the raw audio plus the resampled copy and
+// the convolution kernel at the session rate.
+class AccountedImpulseResponse : public dsp::ImpulseResponse
+{
+public:
+  AccountedImpulseResponse(const char* fileName, const double sampleRate)
+  : dsp::ImpulseResponse(fileName, sampleRate)
+  {
+    if (GetWavState() == dsp::wav::LoadReturnCode::SUCCESS)
+      _EstimateMemoryFootprint(GetData(), sampleRate);
+  }
+
+  AccountedImpulseResponse(const IRData& irData, const double sampleRate)
+  : dsp::ImpulseResponse(irData, sampleRate)
+  {
+    _EstimateMemoryFootprint(irData, sampleRate);
+  }
+
+  size_t GetMemoryFootprintBytes() const { return mMemoryFootprintBytes; };
+
+private:
+  void _EstimateMemoryFootprint(const IRData& irData, const double sampleRate)
+  {
+    const size_t rawSamples = irData.mRawAudio.size();
+    const double ratio = irData.mRawAudioSampleRate > 0.0 ? sampleRate / irData.mRawAudioSampleRate : 1.0;
+    const auto resampledSamples = static_cast<size_t>(std::ceil(static_cast<double>(rawSamples) * ratio));
+    mMemoryFootprintBytes = sizeof(*this) + (rawSamples + 2 * resampledSamples) * sizeof(float);
+  }
+
+  size_t mMemoryFootprintBytes = sizeof(*this);
+};
+
+// What a model is built from: its .nam config without the top-level "weights" array, and those weights as floats, which
+// go to nam::get_dsp() through nam::dspData. Container submodels keep their weights in the json, because the core
+// builds them from their own json configs. Shared by every instance using the model (NAMModelRegistry in
+// NeuralAmpModeler.cpp).
+struct NAMModelSource
+{
+  nlohmann::json model;
+  std::vector<float> weights;
+};
+
+using SharedNAMModelSource = std::shared_ptr<const NAMModelSource>;
+
 class ResamplingNAM : public nam::DSP
 {
 public:
-  // Resampling wrapper around the NAM models
-  ResamplingNAM(std::unique_ptr<nam::DSP> encapsulated, const double expected_sample_rate)
+  // Resampling wrapper around the NAM models. Pass the host's max block size when known so the model is prewarmed
+  // once, for the block size it will run at; slimmableSize >= 0 sizes a slimmable network before that prewarm.
+  ResamplingNAM(std::unique_ptr<nam::DSP> encapsulated, const double expected_sample_rate,
+                const int maxBlockSize = 2048 /* Conservative */, const double slimmableSize = -1.0)
   : nam::DSP(encapsulated->NumInputChannels(), encapsulated->NumOutputChannels(), expected_sample_rate)
   , mEncapsulated(std::move(encapsulated))
   , mResampler(GetNAMSampleRate(mEncapsulated))
@@ -266,19 +327,25 @@ public:
     {
       SetOutputLevel(mEncapsulated->GetOutputLevel());
     }
+    mSlimmable = dynamic_cast<nam::SlimmableModel*>(mEncapsulated.get());
+    if (slimmableSize >= 0.0)
+      SetSlimmableSize(slimmableSize);
 
     // NOTE: prewarm samples doesn't mean anything--we can prewarm the encapsulated model as it likes and be good to
     // go.
     // _prewarm_samples = 0;
 
     // And be ready
-    int maxBlockSize = 2048; // Conservative
     Reset(expected_sample_rate, maxBlockSize);
   };
 
   ~ResamplingNAM() = default;
 
-  void prewarm() override { mEncapsulated->prewarm(); };
+  void prewarm() override
+  {
+    mEncapsulated->prewarm();
+    mPrewarmedStateIntact = false;
+  };
 
   void process(NAM_SAMPLE** input, NAM_SAMPLE** output, const int num_frames) override
   {
@@ -289,6 +356,7 @@ public:
         output[0][i] = input[0][i];
       return;
     }
+    mPrewarmedStateIntact = false;
 
     if (!NeedToResample())
     {
@@ -306,6 +374,12 @@ public:
 
   void Reset(const double sampleRate, const int maxBlockSize) override
   {
+    // Nothing has run since the last prewarm for this rate and block size, so the model is already in the state a
+    // reset would produce. Cached slot models and pending loads hit this on every OnReset() without a rate change.
+    // Otherwise the model is prewarmed again: the core has no state export to restore a snapshot from (FUTURE_PLAN.md).
+    if (mPrewarmedStateIntact && sampleRate == mExpectedSampleRate && maxBlockSize == mMaxExternalBlockSize)
+      return;
+
     mExpectedSampleRate = sampleRate;
     mMaxExternalBlockSize = maxBlockSize;
     mResampler.Reset(sampleRate, maxBlockSize);
@@ -314,12 +388,38 @@ public:
     // Stolen some code from the resampler; it'd be nice to have these exposed as methods? :)
     const double mUpRatio = sampleRate / GetEncapsulatedSampleRate();
     const auto maxEncapsulatedBlockSize = static_cast<int>(std::ceil(static_cast<double>(maxBlockSize) / mUpRatio));
+    NAM_STARTUP_PROFILE_SCOPE(ResetAndPrewarm);
     mEncapsulated->ResetAndPrewarm(sampleRate, maxEncapsulatedBlockSize);
+    mPrewarmedStateIntact = true;
   };
 
   // So that we can let the world know if we're resampling (useful for debugging)
   double GetEncapsulatedSampleRate() const { return GetNAMSampleRate(mEncapsulated); };
 
+  // Memory held by this model (weights, layer buffers, resampler), computed by the loader from the model it built; 0
+  // if unknown. See MemoryAccounting.h.
+  size_t GetMemoryFootprintBytes() const { return mMemoryFootprintBytes; };
+  void SetMemoryFootprintBytes(const size_t bytes) { mMemoryFootprintBytes = bytes; };
+
+  // The source this model was built from. Holding it keeps the source in NAMModelRegistry, so other instances loading
+  // the same model build from it without parsing again. Dropping the model only releases a reference: the registry
+  // frees unused sources on a loader thread.
+  void SetModelSource(SharedNAMModelSource source) { mModelSource = std::move(source); };
+
+  // Resizes a slimmable network in place (0 = smallest, 1 = full); a no-op for other models or an unchanged size.
+  // Returns whether the network was resized. May allocate, so only while the model is built, never on the audio thread.
+  bool SetSlimmableSize(const double size)
+  {
+    if (mSlimmable == nullptr || size == mSlimmableSize)
+      return false;
+    mSlimmable->SetSlimmableSize(size);
+    mSlimmableSize = size;
+    mPrewarmedStateIntact = false;
+    return true;
+  };
+  // -1 for a model that isn't slimmable.
+  double GetSlimmableSize() const { return mSlimmableSize; };
+
 private:
   bool NeedToResample() const { return GetExpectedSampleRate() != GetEncapsulatedSampleRate(); };
   // The encapsulated NAM
@@ -330,6 +430,15 @@ private:
 
   // Used to check that we don't get too large a block to process.
   int mMaxExternalBlockSize = 0;
+  // True from a ResetAndPrewarm() until the model processes audio or is resized.
+  bool mPrewarmedStateIntact = false;
+
+  size_t mMemoryFootprintBytes = 0;
+  SharedNAMModelSource mModelSource;
+
+  // Non-owning view of mEncapsulated when it is slimmable.
+  nam::SlimmableModel* mSlimmable = nullptr;
+  double mSlimmableSize = -1.0;
 };
 
 class NeuralAmpModeler final : public iplug::Plugin
@@ -351,7 +460,39 @@ public:
   void OnParamChangeUI(int paramIdx, iplug::EParamSource source) override;
   bool OnMessage(int msgTag, int ctrlTag, int dataSize, const void* pData) override;
 
+  // Slimmable model size (0 = smallest network, 1 = full), clamped to [0, 1]. The loader rebuilds the active amp model
+  // at a new size and it swaps in like a reload; cached slot models catch up when they become active, and stomp models
+  // and new loads are built at the size in use. Defaults to NAMConfig::SlimmableSize. A per-machine setting, like the
+  // governor switch below: loaded by every new instance and saved when an instance that changed it closes, never part
+  // of the plug-in state or a host parameter. Any thread.
+  void SetSlimmableSize(double size)
+  {
+    mSlimmableSizeSetting.store(size, std::memory_order_relaxed);
+    mMachineSettingsChanged.store(true, std::memory_order_relaxed);
+  }
+  // With the governor on, the setting above is an upper bound: the size drops while ProcessBlock() runs close to its
+  // deadline and recovers when there is headroom (see SlimmableGovernor.h). Any thread.
+  void SetSlimmableGovernorEnabled(bool enabled)
+  {
+    mSlimmableGovernorEnabled.store(enabled, std::memory_order_relaxed);
+    mMachineSettingsChanged.store(true, std::memory_order_relaxed);
+  }
+  // Size the setting and governor ask for now; new models are built at it.
+  double GetSlimmableSize() const { return mSlimmableSizeApplied.load(std::memory_order_relaxed); }
+  // Runs the amp model stage on a dedicated worker thread, one host block behind the rest of the chain, so the
+  // network overlaps with the next callback. Adds the max block size to the reported latency. Takes effect at the
+  // next OnReset(), where hosts also pick up the latency change. Any thread.
+  void SetPipelinedModelEnabled(bool enabled)
+  {
+    mPipelinedModelRequested.store(enabled, std::memory_order_relaxed);
+  }
+
 private:
+#if defined(HEADLESS_API)
+  // Offline tools in headless/ inspect loader/staging state and call individual DSP stages.
+  friend class NAMHeadlessProbe;
+#endif
+
   struct AmpSlotState
   {
     double modelToggle = 0.0;
@@ -568,6 +709,11 @@ private:
   // Exists so that we don't try to use a DSP module that's only
   // partially-instantiated.
   void _ApplyDSPStaging();
+  // Audio thread: updates the setting/governor size and publishes the running amp model's size. Returns whether the
+  // running size changed since the last block.
+  bool _ApplySlimmableSize();
+  // Main thread: queues a rebuild of the active amp model when its size lags behind GetSlimmableSize().
+  void _RequestSlimmableResize();
   // Deallocates mInputPointers and mOutputPointers
   void _DeallocateIOPointers();
   // Fallback that just copies inputs to outputs if mDSP doesn't hold a model.
@@ -622,14 +768,67 @@ private:
   void _ResetModelAndIR(const double sampleRate, const int maxBlockSize);
 
   double _GetOutputGainForModel(ResamplingNAM* model) const;
+  // Models, IRs and FX buffers this instance holds. Audio thread only (or between blocks): it owns those objects.
+  void _CollectMemoryReport(MemoryReport& report) const;
   void _SetInputGain();
   void _SetOutputGain();
   void _SetMasterGain();
   void _UpdateActiveAmpMasterState(int slotIndex);
+  // Master stage settings for one block, copied from the mActiveAmpMaster* state so the pipelined stage gets the values
+  // of the block it runs.
+  struct AmpMasterStageParams
+  {
+    MasterBehaviorKind behavior = MasterBehaviorKind::Standard;
+    double gain = 1.0;
+    double saturationDrive = 1.0;
+    double saturationMix = 0.0;
+    double saturationMakeupGain = 1.0;
+  };
+  AmpMasterStageParams _GetAmpMasterStageParams() const;
   void _ProcessAmpMasterStage(iplug::sample** inputs, size_t numChannels, size_t numFrames);
+  void _ProcessAmpMasterStage(const AmpMasterStageParams& params, iplug::sample** inputs, size_t numChannels,
+                              size_t numFrames);
+  // Runs one amp model over the core: mono through model, stereo core through the left/right instances with a
+  // bypassed (silent) side copied through. Every amp model pass goes through here. modelRight is only read in the
+  // stereo core, where it must be set: callers only get here with both instances loaded.
+  void _ProcessAmpModel(ResamplingNAM& model, ResamplingNAM* modelRight, iplug::sample** inputs,
+                        iplug::sample** outputs, size_t numChannels, const std::array<bool, 2>& bypassSide,
+                        int nFrames);
+  // One block of the amp model stage, as ProcessBlock() decided it. Built on the audio thread and run either inline
+  // or on the mModelPipeline worker.
+  struct AmpModelStageJob
+  {
+    // nullptr: amp section off, the stage copies its input.
+    ResamplingNAM* model = nullptr;
+    ResamplingNAM* modelRight = nullptr;
+    ResamplingNAM* crossfadeTarget = nullptr;
+    ResamplingNAM* crossfadeTargetRight = nullptr;
+    double crossfadeTargetOutputGainScale = 1.0;
+    size_t numChannels = 1;
+    std::array<bool, 2> bypassSide = {false, false};
+    // Per-slot processing right after the model. The pipelined stage runs it too, so it switches with the model
+    // instead of GetLatency() frames early; inline, ProcessBlock() runs it after the stage. nullptr: tone stack off.
+    dsp::tone_stack::AbstractToneStack* toneStack = nullptr;
+    bool masterActive = false;
+    AmpMasterStageParams master;
+  };
+  // Model pass plus the stereo-side resume de-click.
+  void _ProcessAmpModelStage(const AmpModelStageJob& job, iplug::sample** inputs, iplug::sample** outputs,
+                             int nFrames);
+  // Amp variant crossfade into the stage output; a no-op without a crossfade target.
+  void _ProcessAmpModelCrossfade(const AmpModelStageJob& job, iplug::sample** inputs, iplug::sample** outputs,
+                                 int nFrames);
+  // Tone stack and master stage over the stage output, in place.
+  void _ProcessAmpPostModelStage(const AmpModelStageJob& job, iplug::sample** outputs, int nFrames);
+  static void _RunPipelinedAmpModelStage(void* context, iplug::sample** inputs, iplug::sample** outputs,
+                                         int nFrames);
 #if NAM_DEV_DIAGNOSTICS
-  void _PublishDevDiagnosticsDSPTiming(size_t numFrames, double elapsedSeconds);
+  void _PublishDevDiagnosticsDSPTiming(size_t numFrames, double elapsedSeconds,
+                                       const DevDiagnosticsStageLaps& stageLaps);
   void _RefreshDevDiagnostics();
+  bool _WriteDevDiagnosticsStageTimingCSV(const char* path) const;
+  // UI: writes the stage histograms to a timestamped CSV on the desktop.
+  void _DumpDevDiagnosticsStageTimingCSV();
 #endif
   void _ResetBuiltInCompressor(double sampleRate);
   void _ProcessBuiltInCompressor(iplug::sample** inputs, iplug::sample** outputs, size_t numChannels, size_t numFrames);
@@ -673,8 +872,13 @@ private:
   std::unique_ptr<dsp::tone_stack::AbstractToneStack> _CreateToneStack(ToneStackKind kind) const;
   void _CaptureAmpSlotState(int slotIndex);
   void _ApplyAmpSlotState(int slotIndex);
+  // With the pipeline active these only queue the refresh (mPendingToneStackRefresh), since the worker may be
+  // running the tone stack; _ApplyPendingToneStackRefresh() writes it once the worker is idle.
   void _ApplyAmpSlotStateToToneStack(int slotIndex);
   void _ApplyCurrentAmpParamsToActiveToneStack();
+  void _WriteAmpSlotStateToToneStack(int slotIndex);
+  void _WriteCurrentAmpParamsToActiveToneStack();
+  void _ApplyPendingToneStackRefresh();
   void _BeginPresetRecallTransition(int previousActiveSlot, int targetActiveSlot);
   bool _CanEditAmpSlotModel(int slotIndex) const;
   bool _EnsureReleaseAssetManifest();
@@ -687,7 +891,9 @@ private:
   void _ApplyCabSlotSource(int slotIndex, bool forceReload = false);
   void _RefreshCabControls();
   void _RefreshCabSlotControls(int slotIndex);
+#if IPLUG_EDITOR
   void _ShowCabSourceMenu(int slotIndex, const iplug::igraphics::IRECT& anchorArea);
+#endif
   void _SetAmpSlotReleaseAsset(int slotIndex, ReleaseAmpAssetId assetId, int variantIndex = 0);
   WDL_String _ResolveAmpSlotModelSourceToPathForMode(int slotIndex,
                                                      const AmpSlotModelSource& requestedSource,
@@ -699,19 +905,27 @@ private:
   bool _IsAmpSlotManagedParam(int paramIdx) const;
   void _RequestModelLoadForSlot(const WDL_String& modelPath, int slotIndex, int slotCtrlTag,
                                 bool userInitiated = false, int variantIndex = -1);
-  void _ModelLoadWorkerLoop();
-  void _StartModelLoadWorker();
-  void _StopModelLoadWorker();
+  struct ModelLoadJob;
+  void _SubmitModelLoadJob(int slotIndex, int variantIndex, const WDL_String& modelPath);
+  void _RunModelLoadJob(const ModelLoadJob& job);
+  int _GetModelLoadPriority(int slotIndex, int variantIndex) const;
+  void _RefreshModelLoadPriorities();
+  void _StartModelLoadWorkers();
+  void _StopModelLoadWorkers();
   void _UpdatePresetLabel();
   void _RefreshStandalonePresetList();
   bool _LoadStandalonePresetFromFile(const WDL_String& filePath);
   bool _LoadDefaultPreset();
   bool _SaveStandalonePresetToFile(const WDL_String& filePath);
+#if IPLUG_EDITOR
   void _PromptStandalonePresetSaveAs();
   void _PromptStandalonePresetRename();
   void _PromptStandalonePresetDelete();
+#endif
   void _SelectStandalonePresetRelative(int delta);
+#if IPLUG_EDITOR
   void _ShowStandalonePresetMenu(const iplug::igraphics::IRECT& anchorArea);
+#endif
   bool _IsStandaloneFactoryPresetPath(const WDL_String& filePath) const;
   void _SetStandalonePresetDirty(bool isDirty);
   void _MarkStandalonePresetDirty();
@@ -774,16 +988,16 @@ private:
   std::unique_ptr<ResamplingNAM> mStompModelB;
   std::unique_ptr<ResamplingNAM> mStompModelRightB;
   // And the IR
-  std::unique_ptr<dsp::ImpulseResponse> mIR;
+  std::unique_ptr<AccountedImpulseResponse> mIR;
   // Stereo core: right-channel state for left IR.
-  std::unique_ptr<dsp::ImpulseResponse> mIRChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mIRRight;
+  std::unique_ptr<AccountedImpulseResponse> mIRChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mIRRight;
   // Stereo core: right-channel state for right IR.
-  std::unique_ptr<dsp::ImpulseResponse> mIRRightChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mCabBIR;
-  std::unique_ptr<dsp::ImpulseResponse> mCabBIRChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mCabBIRSecondary;
-  std::unique_ptr<dsp::ImpulseResponse> mCabBIRSecondaryChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mIRRightChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mCabBIR;
+  std::unique_ptr<AccountedImpulseResponse> mCabBIRChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mCabBIRSecondary;
+  std::unique_ptr<AccountedImpulseResponse> mCabBIRSecondaryChannel2;
   // Manages switching what DSP is being used.
   std::unique_ptr<ResamplingNAM> mStagedModel;
   std::unique_ptr<ResamplingNAM> mStagedModelRight;
@@ -791,14 +1005,14 @@ private:
   std::unique_ptr<ResamplingNAM> mStagedStompModelRight;
   std::unique_ptr<ResamplingNAM> mStagedStompModelB;
   std::unique_ptr<ResamplingNAM> mStagedStompModelRightB;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedIR;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedIRChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedIRRight;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedIRRightChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedCabBIR;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedCabBIRChannel2;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedCabBIRSecondary;
-  std::unique_ptr<dsp::ImpulseResponse> mStagedCabBIRSecondaryChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mStagedIR;
+  std::unique_ptr<AccountedImpulseResponse> mStagedIRChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mStagedIRRight;
+  std::unique_ptr<AccountedImpulseResponse> mStagedIRRightChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mStagedCabBIR;
+  std::unique_ptr<AccountedImpulseResponse> mStagedCabBIRChannel2;
+  std::unique_ptr<AccountedImpulseResponse> mStagedCabBIRSecondary;
+  std::unique_ptr<AccountedImpulseResponse> mStagedCabBIRSecondaryChannel2;
   WDL_String mStagedIRPath;
   WDL_String mStagedIRPathRight;
   WDL_String mStagedCabBIRPath;
@@ -867,9 +1081,11 @@ private:
   std::atomic<bool> mDelayTransportIsRunning{false};
   std::atomic<bool> mDelayHostTempoValid{false};
   std::atomic<bool> mDelayUsingManualTempo{true};
+#if IPLUG_EDITOR
   iplug::igraphics::IPopupMenu mStandalonePresetMenu;
   iplug::igraphics::IPopupMenu mCabSourceMenuA;
   iplug::igraphics::IPopupMenu mCabSourceMenuB;
+#endif
   std::array<AmpSlotState, 3> mAmpSlotStates = {};
   std::array<std::atomic<bool>, 3> mAmpSlotHasLoudness;
   std::array<std::atomic<bool>, 3> mAmpSlotHasCalibration;
@@ -885,16 +1101,16 @@ private:
   {
     int slotIndex = 0;
     int variantIndex = 0;
+    int storageIndex = 0;
     uint64_t requestId = 0;
     WDL_String modelPath;
     double sampleRate = 48000.0;
     int blockSize = 64;
   };
-  std::thread mModelLoadWorker;
-  std::mutex mModelLoadMutex;
-  std::condition_variable mModelLoadCV;
-  std::deque<ModelLoadJob> mModelLoadJobs;
-  bool mModelLoadWorkerExit = false;
+#if NAM_TRACE
+  // This instance started the process-wide trace (see NAMTrace.h) and stops it on destruction.
+  bool mOwnsTrace = false;
+#endif
   std::atomic<bool> mPresetRecallMuteActive{false};
   std::atomic<int> mPresetRecallTargetSlot{-1};
   bool mActiveAmpBypassed = false;
@@ -912,15 +1128,57 @@ private:
   double mActiveAmpMasterSaturationMakeupGain = 1.0;
   std::array<int, 2> mActiveCabSlotSourceChoice = {};
   std::array<double, 2> mActiveCabSlotPosition = {};
+  std::atomic<double> mSlimmableSizeSetting{NAMConfig::SlimmableSize};
+  std::atomic<bool> mSlimmableGovernorEnabled{false};
+  // Set by SetSlimmableSize()/SetSlimmableGovernorEnabled(); the destructor then saves them as this machine's settings.
+  std::atomic<bool> mMachineSettingsChanged{false};
+  // Written by the audio thread; loaders build new models at this size.
+  std::atomic<double> mSlimmableSizeApplied{NAMConfig::SlimmableSize};
+  // Size of the running amp model as of the last block (-1: none or not slimmable). Audio thread writes, main reads.
+  std::atomic<double> mSlimmableSizeRunning{-1.0};
+  // Main thread: the last rebuild _RequestSlimmableResize() queued, so it isn't queued again every idle tick.
+  double mSlimmableResizeRequestedSize = -1.0;
+  int mSlimmableResizeRequestedStorageIndex = -1;
+  SlimmableGovernor mSlimmableGovernor;
+  // Pipelined amp model stage (see SetPipelinedModelEnabled()). mModelPipelineActive is set in OnReset() only (and
+  // read by the tone stack setters on any thread); the job and everything it points to, tone stack included, belong
+  // to the worker from Exchange() until WaitIdle() at the next ProcessBlock().
+  std::atomic<bool> mPipelinedModelRequested{false};
+  std::atomic<bool> mModelPipelineActive{false};
+  // Tone stack writes queued while the pipeline is active: bit n for _WriteAmpSlotStateToToneStack(n), then
+  // kPendingToneStackRefreshCurrentParams for _WriteCurrentAmpParamsToActiveToneStack().
+  static constexpr uint32_t kPendingToneStackRefreshCurrentParams = 1u << 31;
+  std::atomic<uint32_t> mPendingToneStackRefresh{0};
+  AmpModelStageJob mPipelinedAmpModelStageJob;
+  ModelPipeline<iplug::sample> mModelPipeline{&NeuralAmpModeler::_RunPipelinedAmpModelStage, this};
+  // With the pipeline active, what a model swap changes after the stage is held back by GetLatency() frames so it
+  // lines up with the first output of the new model: the output gain (mPipelinedOutputGain is the one _ProcessOutput()
+  // applies), the swap de-click, and the fade-in after a slot or path transition or a preset recall mute (held at
+  // silence for mTransitionFadeInHoldSamples / mPresetRecallMuteHoldSamples first). Audio thread only.
+  PipelineEventDelay<double> mPipelinedOutputGainEvents;
+  double mPipelinedOutputGain = 1.0;
+  double mLastPipelinedOutputGainPushed = 1.0;
+  PipelineEventDelay<bool> mPipelinedDeClickEvents;
+  int mTransitionFadeInHoldSamples = 0;
+  int mPresetRecallMuteHoldSamples = 0;
+  // Runs the right-channel amp model alongside the left in the stereo core, on the process-wide ForkJoinPool (see
+  // _ProcessAmpModel()).
+  ForkJoinExecutor mStereoForkJoin;
 #if NAM_DEV_DIAGNOSTICS
   std::atomic<uint64_t> mDevDiagnosticsLastBlockDurationNs{0};
   std::atomic<uint64_t> mDevDiagnosticsAverageBlockDurationNs{0};
   std::atomic<uint64_t> mDevDiagnosticsPeakBlockDurationNs{0};
   std::atomic<uint32_t> mDevDiagnosticsLastBlockFrames{0};
+  DevDiagnosticsStageTiming mDevDiagnosticsStageTiming;
   double mDevDiagnosticsAverageBlockDurationNsWriter = 0.0;
   double mDevDiagnosticsPeakBlockDurationNsWriter = 0.0;
   WDL_String mLastDevDiagnosticsText;
   uint64_t mDevDiagnosticsLastUITextUpdateNs = 0;
+  // UI asks, the audio thread fills mDevDiagnosticsMemoryReport and hands it back; neither touches it out of turn.
+  std::atomic<bool> mDevDiagnosticsMemoryReportRequested{true};
+  std::atomic<bool> mDevDiagnosticsMemoryReportReady{false};
+  MemoryReport mDevDiagnosticsMemoryReport;
+  std::array<size_t, kMemoryCategoryCount> mDevDiagnosticsMemoryBytes = {};
 #if defined(APP_API) && defined(_WIN32)
   static constexpr size_t kDevDiagnosticsCPUWindowSampleCount = 40; // 10 seconds at 250 ms polling.
   uint64_t mDevDiagnosticsLastProcessPollNs = 0;
@@ -935,10 +1193,10 @@ private:
   size_t mDevDiagnosticsProcessCpuWindowValidCount = 0;
 #endif
 #endif
-  std::array<std::unique_ptr<dsp::ImpulseResponse>, 2> mPreviousCabPrimaryIR;
-  std::array<std::unique_ptr<dsp::ImpulseResponse>, 2> mPreviousCabPrimaryIRChannel2;
-  std::array<std::unique_ptr<dsp::ImpulseResponse>, 2> mPreviousCabSecondaryIR;
-  std::array<std::unique_ptr<dsp::ImpulseResponse>, 2> mPreviousCabSecondaryIRChannel2;
+  std::array<std::unique_ptr<AccountedImpulseResponse>, 2> mPreviousCabPrimaryIR;
+  std::array<std::unique_ptr<AccountedImpulseResponse>, 2> mPreviousCabPrimaryIRChannel2;
+  std::array<std::unique_ptr<AccountedImpulseResponse>, 2> mPreviousCabSecondaryIR;
+  std::array<std::unique_ptr<AccountedImpulseResponse>, 2> mPreviousCabSecondaryIRChannel2;
   std::array<int, 2> mPreviousCabSlotSourceChoice = {};
   std::array<double, 2> mPreviousCabSlotPosition = {};
   std::array<int, 2> mCabSlotIRCrossfadeSamplesRemaining = {};
@@ -1048,7 +1306,11 @@ private:
   WDL_String mCabBIRSecondaryPath;
   std::array<WDL_String, 2> mCabCustomIRPaths;
 
+#if IPLUG_EDITOR
   WDL_String mHighLightColor{PluginColors::NAM_THEMECOLOR.ToColorCode()};
+#else
+  WDL_String mHighLightColor;
+#endif
 
   std::unordered_map<std::string, double> mNAMParams = {{"Input", 0.0}, {"Output", 0.0}};
 
@@ -401,6 +401,28 @@ private:
   IText mOffText;
 };
 
+// Read-only text that runs an action when clicked (the dev diagnostics overlay dumps its stage timings this way).
+class NAMClickableTextControl : public ITextControl
+{
+public:
+  using Action = std::function<void()>;
+
+  NAMClickableTextControl(const IRECT& bounds, const IText& text, Action onClick)
+  : ITextControl(bounds, "", text, COLOR_TRANSPARENT)
+  , mOnClick(std::move(onClick))
+  {
+  }
+
+  void OnMouseDown(float, float, const IMouseMod&) override
+  {
+    if (mOnClick)
+      mOnClick();
+  }
+
+private:
+  Action mOnClick;
+};
+
 class NAMAmpBitmapToggleControl : public IControl
 {
 public:
@@ -0,0 +1,68 @@
+#pragma once
+
+// weights.npy of a legacy config.json + weights.npy model export: a 1-D little-endian float32 or float64 array.
+// Shared by the plug-in loader and nam-model-zoo.
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace npy
+{
+// The array inside the bytes of a .npy file; valid as long as those bytes are.
+struct WeightsView
+{
+  const char* data = nullptr;
+  size_t count = 0;
+  bool isFloat64 = false;
+
+  float operator[](const size_t i) const
+  {
+    if (isFloat64)
+    {
+      double value;
+      std::memcpy(&value, data + i * sizeof(double), sizeof(value));
+      return static_cast<float>(value);
+    }
+    float value;
+    std::memcpy(&value, data + i * sizeof(float), sizeof(value));
+    return value;
+  }
+};
+
+// Throws std::runtime_error, prefixed with name, for anything but a supported array.
+inline WeightsView ParseWeights(const char* contents, const size_t size, const std::string& name)
+{
+  if (contents == nullptr || size < 10 || std::memcmp(contents, "\x93NUMPY", 6) != 0)
+    throw std::runtime_error(name + " is not a .npy file");
+  const auto majorVersion = static_cast<unsigned char>(contents[6]);
+  size_t headerLength = 0;
+  size_t headerStart = 0;
+  if (majorVersion == 1)
+  {
+    headerLength = static_cast<unsigned char>(contents[8]) | (static_cast<unsigned char>(contents[9]) << 8);
+    headerStart = 10;
+  }
+  else
+  {
+    if (size < 12)
+      throw std::runtime_error(name + ": truncated header");
+    for (int b = 3; b >= 0; --b)
+      headerLength = (headerLength << 8) | static_cast<unsigned char>(contents[8 + static_cast<size_t>(b)]);
+    headerStart = 12;
+  }
+  if (headerStart + headerLength > size)
+    throw std::runtime_error(name + ": truncated header");
+  const std::string header(contents + headerStart, headerLength);
+  if (header.find("'fortran_order': True") != std::string::npos)
+    throw std::runtime_error(name + ": Fortran-ordered arrays are not supported");
+  WeightsView view;
+  view.isFloat64 = header.find("'<f8'") != std::string::npos;
+  if (!view.isFloat64 && header.find("'<f4'") == std::string::npos)
+    throw std::runtime_error(name + ": only little-endian float32/float64 weights are supported");
+  view.data = contents + headerStart + headerLength;
+  view.count = (size - headerStart - headerLength) / (view.isFloat64 ? sizeof(double) : sizeof(float));
+  return view;
+}
+} // namespace npy
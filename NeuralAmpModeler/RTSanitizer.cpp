@@ -0,0 +1,509 @@
+// Interposers and reporting for the real-time safety sanitizer; see RTSanitizer.h.
+
+// Fortified libc headers define open()/read() as inline wrappers, which would clash with the interposers below.
+#undef _FORTIFY_SOURCE
+
+#include "RTSanitizer.h"
+
+#if NAM_RT_SANITIZER
+
+  #include <atomic>
+  #include <cerrno>
+  #include <cstdarg>
+  #include <cstddef>
+  #include <cstdio>
+  #include <cstdlib>
+  #include <new>
+
+  #if defined(__linux__) || defined(__APPLE__)
+    #include <execinfo.h>
+    #include <unistd.h>
+    #define NAM_RT_SANITIZER_HAS_BACKTRACE 1
+  #else
+    #define NAM_RT_SANITIZER_HAS_BACKTRACE 0
+  #endif
+
+  #if defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <fcntl.h>
+    #include <pthread.h>
+    #define NAM_RT_SANITIZER_INTERPOSE_LIBC 1
+extern "C" {
+// glibc's own entry points, so the malloc interposers do not recurse and operator new is not reported twice.
+void* __libc_malloc(size_t size);
+void __libc_free(void* ptr);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+  #else
+    #define NAM_RT_SANITIZER_INTERPOSE_LIBC 0
+  #endif
+
+  #if defined(_WIN32)
+    #include <malloc.h>
+  #endif
+
+  // initial-exec TLS never allocates on first access, which matters when the first access is inside malloc.
+  #if defined(__GNUC__)
+    #define NAM_RT_SANITIZER_TLS __thread __attribute__((tls_model("initial-exec")))
+  #else
+    #define NAM_RT_SANITIZER_TLS thread_local
+  #endif
+
+namespace
+{
+constexpr int kMaxStackFrames = 48;
+constexpr size_t kMaxReportedStacks = 1024;
+
+NAM_RT_SANITIZER_TLS int tRealtimeDepth = 0;
+NAM_RT_SANITIZER_TLS int tAllowUnsafeDepth = 0;
+NAM_RT_SANITIZER_TLS bool tReporting = false;
+
+std::atomic<uint64_t> gViolationCount{0};
+std::atomic<uint64_t> gReportedStackHashes[kMaxReportedStacks] = {};
+bool gAbortOnViolation = false;
+
+// Returns true the first time a stack hash is seen. Once the table is full, new stacks are counted but not printed.
+bool MarkStackReported(const uint64_t hash)
+{
+  for (size_t probe = 0; probe < kMaxReportedStacks; ++probe)
+  {
+    auto& slot = gReportedStackHashes[(hash + probe) % kMaxReportedStacks];
+    uint64_t current = slot.load(std::memory_order_relaxed);
+    if (current == hash)
+      return false;
+    if (current == 0 && slot.compare_exchange_strong(current, hash, std::memory_order_relaxed))
+      return true;
+    if (current == hash)
+      return false;
+  }
+  return false;
+}
+
+struct SanitizerInit
+{
+  SanitizerInit()
+  {
+    const char* abortValue = std::getenv("NAM_RT_SANITIZER_ABORT");
+    gAbortOnViolation = abortValue != nullptr && abortValue[0] != '\0' && abortValue[0] != '0';
+  #if NAM_RT_SANITIZER_HAS_BACKTRACE
+    // The first backtrace() loads the unwinder, which allocates; do it now rather than inside a report.
+    void* frame = nullptr;
+    backtrace(&frame, 1);
+  #endif
+  }
+};
+SanitizerInit gSanitizerInit;
+
+void* RawAlloc(const size_t size)
+{
+  #if NAM_RT_SANITIZER_INTERPOSE_LIBC
+  return __libc_malloc(size == 0 ? 1 : size);
+  #else
+  return std::malloc(size == 0 ? 1 : size);
+  #endif
+}
+
+void RawFree(void* ptr)
+{
+  #if NAM_RT_SANITIZER_INTERPOSE_LIBC
+  __libc_free(ptr);
+  #else
+  std::free(ptr);
+  #endif
+}
+
+void* RawAlignedAlloc(const size_t size, const size_t alignment)
+{
+  #if NAM_RT_SANITIZER_INTERPOSE_LIBC
+  return __libc_memalign(alignment, size == 0 ? 1 : size);
+  #elif defined(_WIN32)
+  return _aligned_malloc(size == 0 ? 1 : size, alignment);
+  #else
+  void* ptr = nullptr;
+  return posix_memalign(&ptr, alignment < sizeof(void*) ? sizeof(void*) : alignment, size == 0 ? 1 : size) == 0
+           ? ptr
+           : nullptr;
+  #endif
+}
+
+void RawAlignedFree(void* ptr)
+{
+  #if defined(_WIN32)
+  _aligned_free(ptr);
+  #else
+  RawFree(ptr);
+  #endif
+}
+
+void* CheckedNew(const size_t size, const char* what)
+{
+  NAM_RT_CHECK(what);
+  if (void* ptr = RawAlloc(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* CheckedAlignedNew(const size_t size, const std::align_val_t alignment, const char* what)
+{
+  NAM_RT_CHECK(what);
+  if (void* ptr = RawAlignedAlloc(size, static_cast<size_t>(alignment)))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void CheckedDelete(void* ptr, const char* what) noexcept
+{
+  if (ptr == nullptr)
+    return;
+  NAM_RT_CHECK(what);
+  RawFree(ptr);
+}
+
+void CheckedAlignedDelete(void* ptr, const char* what) noexcept
+{
+  if (ptr == nullptr)
+    return;
+  NAM_RT_CHECK(what);
+  RawAlignedFree(ptr);
+}
+} // namespace
+
+namespace NAMRTSanitizer
+{
+ScopedRealtimeContext::ScopedRealtimeContext() noexcept
+{
+  ++tRealtimeDepth;
+}
+
+ScopedRealtimeContext::~ScopedRealtimeContext() noexcept
+{
+  --tRealtimeDepth;
+}
+
+ScopedAllowUnsafe::ScopedAllowUnsafe() noexcept
+{
+  ++tAllowUnsafeDepth;
+}
+
+ScopedAllowUnsafe::~ScopedAllowUnsafe() noexcept
+{
+  --tAllowUnsafeDepth;
+}
+
+bool IsInRealtimeContext() noexcept
+{
+  return tRealtimeDepth > 0 && tAllowUnsafeDepth == 0 && !tReporting;
+}
+
+void ReportViolation(const char* what) noexcept
+{
+  if (tReporting)
+    return;
+  tReporting = true;
+  gViolationCount.fetch_add(1, std::memory_order_relaxed);
+
+  void* frames[kMaxStackFrames];
+  int numFrames = 0;
+  #if NAM_RT_SANITIZER_HAS_BACKTRACE
+  numFrames = backtrace(frames, kMaxStackFrames);
+  #endif
+  // FNV-1a over the call kind and return addresses; the low bit keeps 0 free as the empty-slot marker.
+  uint64_t hash = 1469598103934665603ull ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(what));
+  for (int i = 0; i < numFrames; ++i)
+  {
+    hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i]));
+    hash *= 1099511628211ull;
+  }
+  if (MarkStackReported(hash | 1ull))
+  {
+    std::fprintf(stderr, "\n[NAM RT sanitizer] %s while ProcessBlock() is on the stack\n", what);
+  #if NAM_RT_SANITIZER_HAS_BACKTRACE
+    backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+  #else
+    std::fprintf(stderr, "  (no stack trace on this platform)\n");
+  #endif
+    if (gAbortOnViolation)
+      std::abort();
+  }
+  tReporting = false;
+}
+
+uint64_t GetViolationCount() noexcept
+{
+  return gViolationCount.load(std::memory_order_relaxed);
+}
+} // namespace NAMRTSanitizer
+
+// Replaceable global allocation functions (portable).
+void* operator new(std::size_t size)
+{
+  return CheckedNew(size, "operator new");
+}
+
+void* operator new[](std::size_t size)
+{
+  return CheckedNew(size, "operator new[]");
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  NAM_RT_CHECK("operator new");
+  return RawAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  NAM_RT_CHECK("operator new[]");
+  return RawAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  return CheckedAlignedNew(size, alignment, "operator new (aligned)");
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return CheckedAlignedNew(size, alignment, "operator new[] (aligned)");
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  NAM_RT_CHECK("operator new (aligned)");
+  return RawAlignedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  NAM_RT_CHECK("operator new[] (aligned)");
+  return RawAlignedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+  CheckedDelete(ptr, "operator delete");
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  CheckedDelete(ptr, "operator delete[]");
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  CheckedDelete(ptr, "operator delete");
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  CheckedDelete(ptr, "operator delete[]");
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  CheckedDelete(ptr, "operator delete");
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  CheckedDelete(ptr, "operator delete[]");
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete (aligned)");
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete[] (aligned)");
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete (aligned)");
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete[] (aligned)");
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete (aligned)");
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  CheckedAlignedDelete(ptr, "operator delete[] (aligned)");
+}
+
+  #if NAM_RT_SANITIZER_INTERPOSE_LIBC
+namespace
+{
+// Next definition of a libc/libpthread symbol, resolved once. dlsym() may calloc, which is already interposed safely.
+template <typename Fn>
+Fn ResolveNext(std::atomic<Fn>& cached, const char* name)
+{
+  Fn fn = cached.load(std::memory_order_acquire);
+  if (fn == nullptr)
+  {
+    fn = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+    cached.store(fn, std::memory_order_release);
+  }
+  return fn;
+}
+
+std::atomic<int (*)(pthread_mutex_t*)> gRealMutexLock{nullptr};
+std::atomic<int (*)(pthread_rwlock_t*)> gRealRwlockRdlock{nullptr};
+std::atomic<int (*)(pthread_rwlock_t*)> gRealRwlockWrlock{nullptr};
+std::atomic<FILE* (*)(const char*, const char*)> gRealFopen{nullptr};
+std::atomic<FILE* (*)(const char*, const char*)> gRealFopen64{nullptr};
+std::atomic<size_t (*)(void*, size_t, size_t, FILE*)> gRealFread{nullptr};
+std::atomic<size_t (*)(const void*, size_t, size_t, FILE*)> gRealFwrite{nullptr};
+std::atomic<int (*)(const char*, int, ...)> gRealOpen{nullptr};
+std::atomic<int (*)(const char*, int, ...)> gRealOpen64{nullptr};
+std::atomic<ssize_t (*)(int, void*, size_t)> gRealRead{nullptr};
+std::atomic<ssize_t (*)(int, const void*, size_t)> gRealWrite{nullptr};
+
+int GetOpenMode(const int flags, va_list args)
+{
+    #ifdef O_TMPFILE
+  const bool needsMode = (flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE;
+    #else
+  const bool needsMode = (flags & O_CREAT) != 0;
+    #endif
+  return needsMode ? va_arg(args, int) : 0;
+}
+} // namespace
+
+extern "C" {
+void* malloc(size_t size) noexcept
+{
+  NAM_RT_CHECK("malloc");
+  return __libc_malloc(size);
+}
+
+void free(void* ptr) noexcept
+{
+  if (ptr != nullptr)
+    NAM_RT_CHECK("free");
+  __libc_free(ptr);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+  NAM_RT_CHECK("calloc");
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept
+{
+  NAM_RT_CHECK("realloc");
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+  NAM_RT_CHECK("memalign");
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+  NAM_RT_CHECK("aligned_alloc");
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept
+{
+  NAM_RT_CHECK("posix_memalign");
+  if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  void* ptr = __libc_memalign(alignment, size);
+  if (ptr == nullptr)
+    return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+  NAM_RT_CHECK("pthread_mutex_lock");
+  return ResolveNext(gRealMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock) noexcept
+{
+  NAM_RT_CHECK("pthread_rwlock_rdlock");
+  return ResolveNext(gRealRwlockRdlock, "pthread_rwlock_rdlock")(rwlock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock) noexcept
+{
+  NAM_RT_CHECK("pthread_rwlock_wrlock");
+  return ResolveNext(gRealRwlockWrlock, "pthread_rwlock_wrlock")(rwlock);
+}
+
+FILE* fopen(const char* path, const char* mode)
+{
+  NAM_RT_CHECK("fopen");
+  return ResolveNext(gRealFopen, "fopen")(path, mode);
+}
+
+FILE* fopen64(const char* path, const char* mode)
+{
+  NAM_RT_CHECK("fopen");
+  return ResolveNext(gRealFopen64, "fopen64")(path, mode);
+}
+
+size_t fread(void* buffer, size_t size, size_t count, FILE* file)
+{
+  NAM_RT_CHECK("fread");
+  return ResolveNext(gRealFread, "fread")(buffer, size, count, file);
+}
+
+size_t fwrite(const void* buffer, size_t size, size_t count, FILE* file)
+{
+  NAM_RT_CHECK("fwrite");
+  return ResolveNext(gRealFwrite, "fwrite")(buffer, size, count, file);
+}
+
+int open(const char* path, int flags, ...)
+{
+  NAM_RT_CHECK("open");
+  va_list args;
+  va_start(args, flags);
+  const int mode = GetOpenMode(flags, args);
+  va_end(args);
+  return ResolveNext(gRealOpen, "open")(path, flags, mode);
+}
+
+int open64(const char* path, int flags, ...)
+{
+  NAM_RT_CHECK("open");
+  va_list args;
+  va_start(args, flags);
+  const int mode = GetOpenMode(flags, args);
+  va_end(args);
+  return ResolveNext(gRealOpen64, "open64")(path, flags, mode);
+}
+
+ssize_t read(int fd, void* buffer, size_t count)
+{
+  NAM_RT_CHECK("read");
+  return ResolveNext(gRealRead, "read")(fd, buffer, count);
+}
+
+ssize_t write(int fd, const void* buffer, size_t count)
+{
+  NAM_RT_CHECK("write");
+  return ResolveNext(gRealWrite, "write")(fd, buffer, count);
+}
+} // extern "C"
+  #endif // NAM_RT_SANITIZER_INTERPOSE_LIBC
+
+#endif // NAM_RT_SANITIZER
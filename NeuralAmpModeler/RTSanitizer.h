@@ -0,0 +1,58 @@
+#pragma once
+
+// Real-time safety sanitizer (NAM_RT_SANITIZER=1 builds only).
+//
+// NAM_RT_SCOPE marks the audio callback. While it is on the current thread's stack, RTSanitizer.cpp reports every
+// operator new/delete, malloc family call, blocking pthread mutex/rwlock lock and file open/read/write, plus any
+// explicit NAM_RT_CHECK site, with a stack trace on stderr. Identical stacks are reported once. Set the environment
+// variable NAM_RT_SANITIZER_ABORT=1 to abort on the first report instead.
+//
+// malloc, pthread and file interposition need glibc; elsewhere only operator new/delete and NAM_RT_CHECK sites are
+// caught. In normal builds all macros compile to nothing.
+
+#include <cstdint>
+
+#include "config.h"
+
+#if NAM_RT_SANITIZER
+namespace NAMRTSanitizer
+{
+// Counts nesting so a re-entrant callback stays covered until the outermost scope exits.
+class ScopedRealtimeContext
+{
+public:
+  ScopedRealtimeContext() noexcept;
+  ~ScopedRealtimeContext() noexcept;
+  ScopedRealtimeContext(const ScopedRealtimeContext&) = delete;
+  ScopedRealtimeContext& operator=(const ScopedRealtimeContext&) = delete;
+};
+
+// Suspends reporting on this thread, for work that is known and accepted (keep these rare and commented).
+class ScopedAllowUnsafe
+{
+public:
+  ScopedAllowUnsafe() noexcept;
+  ~ScopedAllowUnsafe() noexcept;
+  ScopedAllowUnsafe(const ScopedAllowUnsafe&) = delete;
+  ScopedAllowUnsafe& operator=(const ScopedAllowUnsafe&) = delete;
+};
+
+bool IsInRealtimeContext() noexcept;
+void ReportViolation(const char* what) noexcept;
+// Total violations seen, including repeats of already-reported stacks.
+uint64_t GetViolationCount() noexcept;
+} // namespace NAMRTSanitizer
+
+  #define NAM_RT_SCOPE() NAMRTSanitizer::ScopedRealtimeContext namRTSanitizerScope
+  #define NAM_RT_ALLOW_UNSAFE() NAMRTSanitizer::ScopedAllowUnsafe namRTSanitizerAllow
+  #define NAM_RT_CHECK(what)                            \
+    do                                                  \
+    {                                                   \
+      if (NAMRTSanitizer::IsInRealtimeContext())        \
+        NAMRTSanitizer::ReportViolation(what);          \
+    } while (false)
+#else
+  #define NAM_RT_SCOPE() ((void)0)
+  #define NAM_RT_ALLOW_UNSAFE() ((void)0)
+  #define NAM_RT_CHECK(what) ((void)0)
+#endif
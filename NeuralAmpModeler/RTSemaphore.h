@@ -0,0 +1,81 @@
+#pragma once
+
+// Counting semaphore for handing work between the audio thread and worker threads. Post() takes no lock and doesn't
+// allocate, so the audio thread can wake a worker; Wait() blocks in the kernel instead of spinning. Post() and the
+// Wait() it releases order memory like a mutex unlock/lock pair. (C++17 has no std::counting_semaphore.)
+
+#if defined(_WIN32)
+#include <climits>
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/semaphore.h>
+#include <mach/task.h>
+#else
+#include <cerrno>
+#include <semaphore.h>
+#endif
+
+class RTSemaphore
+{
+public:
+  RTSemaphore()
+  {
+#if defined(_WIN32)
+    mSemaphore = CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr);
+#elif defined(__APPLE__)
+    semaphore_create(mach_task_self(), &mSemaphore, SYNC_POLICY_FIFO, 0);
+#else
+    sem_init(&mSemaphore, 0, 0);
+#endif
+  }
+
+  ~RTSemaphore()
+  {
+#if defined(_WIN32)
+    CloseHandle(mSemaphore);
+#elif defined(__APPLE__)
+    semaphore_destroy(mach_task_self(), mSemaphore);
+#else
+    sem_destroy(&mSemaphore);
+#endif
+  }
+
+  RTSemaphore(const RTSemaphore&) = delete;
+  RTSemaphore& operator=(const RTSemaphore&) = delete;
+
+  void Post()
+  {
+#if defined(_WIN32)
+    ReleaseSemaphore(mSemaphore, 1, nullptr);
+#elif defined(__APPLE__)
+    semaphore_signal(mSemaphore);
+#else
+    sem_post(&mSemaphore);
+#endif
+  }
+
+  void Wait()
+  {
+#if defined(_WIN32)
+    WaitForSingleObject(mSemaphore, INFINITE);
+#elif defined(__APPLE__)
+    while (semaphore_wait(mSemaphore) == KERN_ABORTED)
+    {
+    }
+#else
+    while (sem_wait(&mSemaphore) != 0 && errno == EINTR)
+    {
+    }
+#endif
+  }
+
+private:
+#if defined(_WIN32)
+  HANDLE mSemaphore = nullptr;
+#elif defined(__APPLE__)
+  semaphore_t mSemaphore = 0;
+#else
+  sem_t mSemaphore;
+#endif
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+// Moves the calling worker thread into the OS real-time class, so work the audio callback may wait on is scheduled
+// like the callback itself: MMCSS "Pro Audio" on Windows, a time-constraint policy on macOS, SCHED_FIFO elsewhere.
+// Best effort: without the privilege (or the service) the thread keeps its priority and the function returns false.
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <avrt.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "avrt.lib")
+#endif
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#include <pthread.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+// periodSeconds: how often the thread gets work (one host block); it is expected to need at most half of that.
+inline bool PromoteCurrentThreadToRealtime(const double periodSeconds)
+{
+#if defined(_WIN32)
+  (void) periodSeconds;
+  DWORD taskIndex = 0;
+  if (AvSetMmThreadCharacteristicsW(L"Pro Audio", &taskIndex) != nullptr)
+    return true;
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#elif defined(__APPLE__)
+  mach_timebase_info_data_t timebase;
+  if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.numer == 0)
+    return false;
+  const double ticksPerSecond = 1.0e9 * static_cast<double>(timebase.denom) / static_cast<double>(timebase.numer);
+  const double period = std::clamp(periodSeconds, 0.5e-3, 50.0e-3) * ticksPerSecond;
+  thread_time_constraint_policy_data_t policy;
+  policy.period = static_cast<uint32_t>(period);
+  policy.computation = static_cast<uint32_t>(0.5 * period);
+  policy.constraint = static_cast<uint32_t>(period);
+  policy.preemptible = TRUE;
+  return thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                           reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT)
+         == KERN_SUCCESS;
+#else
+  (void) periodSeconds;
+  // The lowest real-time priority: above every normal thread, below the host's audio threads.
+  sched_param param{};
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+
+// Picks the slimmable model size from the measured ProcessBlock() load (block time over block duration): steps down
+// when the load stays near the deadline, steps back up after a stretch with headroom. Audio thread only.
+class SlimmableGovernor
+{
+public:
+  static constexpr double kHighLoad = 0.7;
+  static constexpr double kLowLoad = 0.35;
+  static constexpr double kSizeStep = 0.1;
+  static constexpr double kStepDownHoldSeconds = 0.25;
+  static constexpr double kStepUpHoldSeconds = 3.0;
+  // Peaks are taken at once and decay over this time, so one slow block is enough to start the step-down hold.
+  static constexpr double kLoadReleaseSeconds = 0.5;
+
+  void Reset()
+  {
+    mSize = -1.0;
+    mLoad = 0.0;
+    mHighLoadSeconds = 0.0;
+    mLowLoadSeconds = 0.0;
+  }
+
+  // Size to run at; maxSize (the instance setting) until the load first forces a step down.
+  double GetSize(const double maxSize) const { return mSize < 0.0 ? maxSize : std::min(mSize, maxSize); }
+
+  void Update(const double elapsedSeconds, const double blockSeconds, const double maxSize)
+  {
+    if (blockSeconds <= 0.0)
+      return;
+
+    const double load = elapsedSeconds / blockSeconds;
+    if (load >= mLoad)
+      mLoad = load;
+    else
+      mLoad += (load - mLoad) * std::min(blockSeconds / kLoadReleaseSeconds, 1.0);
+
+    const double size = GetSize(maxSize);
+    if (mLoad > kHighLoad)
+    {
+      mLowLoadSeconds = 0.0;
+      mHighLoadSeconds += blockSeconds;
+      if (mHighLoadSeconds >= kStepDownHoldSeconds && size > 0.0)
+      {
+        mSize = std::max(size - kSizeStep, 0.0);
+        mHighLoadSeconds = 0.0;
+        // Measure the smaller network afresh instead of waiting for the old peak to decay.
+        mLoad = load;
+      }
+    }
+    else if (mLoad < kLowLoad)
+    {
+      mHighLoadSeconds = 0.0;
+      mLowLoadSeconds += blockSeconds;
+      if (mLowLoadSeconds >= kStepUpHoldSeconds && size < maxSize)
+      {
+        mSize = std::min(size + kSizeStep, maxSize);
+        mLowLoadSeconds = 0.0;
+      }
+    }
+    else
+    {
+      mHighLoadSeconds = 0.0;
+      mLowLoadSeconds = 0.0;
+    }
+  }
+
+private:
+  // < 0: not stepped down yet, follow the instance setting.
+  double mSize = -1.0;
+  double mLoad = 0.0;
+  double mHighLoadSeconds = 0.0;
+  double mLowLoadSeconds = 0.0;
+};
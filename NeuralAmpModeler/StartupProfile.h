@@ -0,0 +1,95 @@
+#pragma once
+
+// Load-path time accounting for the startup benchmark (NAM_STARTUP_PROFILE=1 builds only; the headless tools enable
+// it). Each phase accumulates wall time and call count across all threads, so phases that run on the model loader
+// worker overlap the main thread's. Phases nest (IR loads during a preset restore count towards both).
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+#if NAM_STARTUP_PROFILE
+namespace NAMStartupProfile
+{
+enum class Phase : size_t
+{
+  JsonParse = 0, // nlohmann::json::parse() of a model config in LoadNAMModelSourceForPath(), once per L/R pair
+  GetDsp, // nam::get_dsp() from the model source, once per stereo-core instance
+  ResetAndPrewarm, // ResamplingNAM::Reset() -> ResetAndPrewarm()
+  IRLoad, // dsp::ImpulseResponse construction: WAV read (file IRs) and resampling to the session rate
+  PresetRestore, // UnserializeState()
+  Count
+};
+
+constexpr size_t kPhaseCount = static_cast<size_t>(Phase::Count);
+
+inline const char* GetPhaseName(const Phase phase)
+{
+  constexpr std::array<const char*, kPhaseCount> kNames = {
+    "json-parse", "get_dsp", "reset-and-prewarm", "ir-load", "preset-restore"};
+  const size_t index = static_cast<size_t>(phase);
+  return index < kNames.size() ? kNames[index] : "?";
+}
+
+struct PhaseTotals
+{
+  std::atomic<uint64_t> totalNs{0};
+  std::atomic<uint64_t> count{0};
+};
+
+inline std::array<PhaseTotals, kPhaseCount> gPhaseTotals;
+
+inline void Reset()
+{
+  for (auto& totals : gPhaseTotals)
+  {
+    totals.totalNs.store(0, std::memory_order_relaxed);
+    totals.count.store(0, std::memory_order_relaxed);
+  }
+}
+
+inline uint64_t GetTotalNs(const Phase phase)
+{
+  return gPhaseTotals[static_cast<size_t>(phase)].totalNs.load(std::memory_order_relaxed);
+}
+
+inline uint64_t GetCount(const Phase phase)
+{
+  return gPhaseTotals[static_cast<size_t>(phase)].count.load(std::memory_order_relaxed);
+}
+
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase(const Phase phase)
+  : mPhase(phase)
+  , mStart(std::chrono::steady_clock::now())
+  {
+  }
+  ~ScopedPhase()
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - mStart;
+    auto& totals = gPhaseTotals[static_cast<size_t>(mPhase)];
+    totals.totalNs.fetch_add(
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+      std::memory_order_relaxed);
+    totals.count.fetch_add(1, std::memory_order_relaxed);
+  }
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+  Phase mPhase;
+  std::chrono::steady_clock::time_point mStart;
+};
+} // namespace NAMStartupProfile
+
+  #define NAM_STARTUP_PROFILE_SCOPE(phase) \
+    NAMStartupProfile::ScopedPhase namStartupProfilePhase##phase(NAMStartupProfile::Phase::phase)
+#else
+  #define NAM_STARTUP_PROFILE_SCOPE(phase) ((void)0)
+#endif
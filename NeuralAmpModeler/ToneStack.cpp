@@ -1,4 +1,5 @@
 #include "ToneStack.h"
+#include "RTSanitizer.h"
 
 #include <cmath>
 
@@ -35,6 +36,7 @@ void dsp::tone_stack::BasicNamToneStack::Reset(const double sampleRate, const in
 
 void dsp::tone_stack::BasicNamToneStack::SetParam(const std::string name, const double val)
 {
+  NAM_RT_CHECK("ToneStack::SetParam(std::string)");
   if (name == "bass")
   {
     // HACK: Store for refresh
@@ -119,6 +121,7 @@ void dsp::tone_stack::Amp2ToneStack::Reset(const double sampleRate, const int ma
 
 void dsp::tone_stack::Amp2ToneStack::SetParam(const std::string name, const double val)
 {
+  NAM_RT_CHECK("ToneStack::SetParam(std::string)");
   if (name == "bass")
   {
     mBassVal = val;
@@ -31,6 +31,27 @@ inline constexpr double SlimmableSize = NAM_SLIMMABLE_SIZE;
 
 #define NAM_STARTUP_TMPLOAD_DEFAULTS 1 // Dev/test helper: set to 0 to disable auto-loading tmpLoad defaults on app start.
 #define NAM_DEV_DIAGNOSTICS 1 // Dev/test helper: set to 0 to hide the diagnostics stats overlay.
+// Dev/test build mode: 1 = report heap, lock, file I/O and string-keyed calls made while ProcessBlock() is on the
+// stack, with a stack trace (see RTSanitizer.h). The build must also compile RTSanitizer.cpp.
+#ifndef NAM_RT_SANITIZER
+  #define NAM_RT_SANITIZER 0
+#endif
+// Dev/test build mode: 1 = write a Chrome/Perfetto trace of loader jobs, IR staging, DSP staging commits and audio
+// callbacks to $NAM_TRACE_FILE or the desktop (see NAMTrace.h). The build must also compile NAMTrace.cpp.
+#ifndef NAM_TRACE
+  #define NAM_TRACE 0
+#endif
+// Dev/test build mode: 1 = accumulate model/IR load and preset restore times for nam-startup-bench (see
+// StartupProfile.h). The headless tools always build with it.
+#ifndef NAM_STARTUP_PROFILE
+  #define NAM_STARTUP_PROFILE 0
+#endif
+// 1 = keep a compiled copy (config + float32 weights) of every loaded user .nam file in the per-user cache directory,
+// keyed by content hash and loader/core version, so reloading it skips the JSON float parse. $NAM_MODEL_CACHE_DIR
+// overrides the directory; set it empty to disable.
+#ifndef NAM_MODEL_CACHE
+  #define NAM_MODEL_CACHE 1
+#endif
 // Amp workflow profile: 0 = Rig Mode (editable slot model pickers), 1 = Release Mode (slot model edits locked).
 #define NAM_RELEASE_MODE 0
 // Temporary preset migration guard: in release mode, ignore serialized amp model paths and always restore bundled models.
@@ -0,0 +1,28 @@
+#pragma once
+
+// Synthetic guitar-like test input for the headless tools when no DI file is given.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace headless
+{
+// Decaying two-partial plucks every 250 ms on a low noise floor: keeps envelopes, gates and saturation busy.
+inline std::vector<float> MakePluckTestSignal(const double sampleRate, const double seconds)
+{
+  constexpr double kPi = 3.14159265358979323846;
+  std::vector<float> signal(static_cast<size_t>(std::max(1.0, sampleRate * seconds)));
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<double> noise(-1.0, 1.0);
+  for (size_t s = 0; s < signal.size(); ++s)
+  {
+    const double t = static_cast<double>(s) / sampleRate;
+    const double envelope = std::exp(-std::fmod(t, 0.25) * 12.0);
+    const double tone = std::sin(2.0 * kPi * 110.0 * t) + 0.5 * std::sin(2.0 * kPi * 221.3 * t);
+    signal[s] = static_cast<float>(0.35 * envelope * tone + 0.002 * noise(rng));
+  }
+  return signal;
+}
+} // namespace headless
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "EmbeddedCabIRAssets.h"
+#include "HeadlessStages.h"
+#include "NAMHeadlessProbe.h"
+#include "ToneStack.h"
+
+namespace headless
+{
+namespace
+{
+constexpr const char* kAmpMasterStageNames[3] = {"amp-master/slot1", "amp-master/slot2", "amp-master/slot3"};
+
+void SetParam(NeuralAmpModeler& plug, const int paramIdx, const double value)
+{
+  plug.GetParam(paramIdx)->Set(value);
+}
+
+// Runs numBlocks blocks, refreshing the (possibly in-place processed) input from the source before each block.
+// Returns elapsed seconds. With process == nullptr only the refresh is timed, which is subtracted as overhead.
+double RunBlocks(StageContext& ctx, StageBuffers& buffers, const std::vector<float>& source, const size_t numBlocks,
+                 const std::function<void(StageContext&)>* process)
+{
+  size_t sourcePos = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t block = 0; block < numBlocks; ++block)
+  {
+    if (sourcePos + ctx.numFrames > source.size())
+      sourcePos = 0;
+    for (size_t c = 0; c < kNumChannelsInternal; ++c)
+      std::copy_n(source.data() + sourcePos, ctx.numFrames, buffers.input[c].data());
+    sourcePos += ctx.numFrames;
+    if (process != nullptr)
+      (*process)(ctx);
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+StageBuffers::StageBuffers()
+: input(kNumChannelsInternal, std::vector<iplug::sample>(kMaxStageBlockSize, 0))
+, output(kNumChannelsInternal, std::vector<iplug::sample>(kMaxStageBlockSize, 0))
+{
+  for (size_t c = 0; c < kNumChannelsInternal; ++c)
+  {
+    inputPointers.push_back(input[c].data());
+    outputPointers.push_back(output[c].data());
+  }
+}
+
+std::vector<StageDef> MakeStages()
+{
+  std::vector<StageDef> stages;
+  stages.push_back({"comp",
+                    [](StageContext& ctx) {
+                      SetParam(*ctx.plug, kStompCompressorAmount, 60.0);
+                      SetParam(*ctx.plug, kStompCompressorHard, 0.0);
+                    },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessCompressor(
+                        *ctx.plug, ctx.inputs, ctx.outputs, ctx.numChannelsMonoCore, ctx.numFrames);
+                    },
+                    false});
+  stages.push_back({"ts-boost", [](StageContext& ctx) { SetParam(*ctx.plug, kStompBoostDrive, 6.0); },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessTSBoost(
+                        *ctx.plug, ctx.inputs, ctx.outputs, ctx.numChannelsMonoCore, ctx.numFrames);
+                    },
+                    false});
+  stages.push_back({"precision-boost", [](StageContext& ctx) { SetParam(*ctx.plug, kStompBoostDrive, 6.0); },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessPrecisionBoost(
+                        *ctx.plug, ctx.inputs, ctx.outputs, ctx.numChannelsMonoCore, ctx.numFrames);
+                    },
+                    false});
+  // Master behavior is per amp slot; the saturating master only does extra work past ~6.5 on the knob.
+  for (int slotIndex = 0; slotIndex < 3; ++slotIndex)
+  {
+    stages.push_back({kAmpMasterStageNames[slotIndex],
+                      [slotIndex](StageContext& ctx) {
+                        SetParam(*ctx.plug, kMasterVolume, 8.5);
+                        NAMHeadlessProbe::SetActiveAmpMasterSlot(*ctx.plug, slotIndex);
+                      },
+                      [](StageContext& ctx) {
+                        NAMHeadlessProbe::ProcessAmpMaster(*ctx.plug, ctx.inputs, ctx.numChannelsMonoCore,
+                                                           ctx.numFrames);
+                      }});
+  }
+  stages.push_back({"tonestack/basic",
+                    [](StageContext& ctx) {
+                      ctx.toneStack = std::make_unique<dsp::tone_stack::BasicNamToneStack>();
+                      ctx.toneStack->Reset(ctx.sampleRate, kMaxStageBlockSize);
+                      ctx.toneStack->SetParam("bass", 7.0);
+                      ctx.toneStack->SetParam("treble", 6.0);
+                    },
+                    [](StageContext& ctx) {
+                      ctx.toneStack->Process(
+                        ctx.inputs, static_cast<int>(ctx.numChannelsMonoCore), static_cast<int>(ctx.numFrames));
+                    }});
+  stages.push_back({"tonestack/amp2",
+                    [](StageContext& ctx) {
+                      ctx.toneStack = std::make_unique<dsp::tone_stack::Amp2ToneStack>();
+                      ctx.toneStack->Reset(ctx.sampleRate, kMaxStageBlockSize);
+                      ctx.toneStack->SetParam("amp2_depth_button", 1.0);
+                      ctx.toneStack->SetParam("amp2_scoop_button", 1.0);
+                    },
+                    [](StageContext& ctx) {
+                      ctx.toneStack->Process(
+                        ctx.inputs, static_cast<int>(ctx.numChannelsMonoCore), static_cast<int>(ctx.numFrames));
+                    }});
+  // One cab convolution per core channel, with the first curated capture of the first mic (as the plug-in loads it).
+  stages.push_back({"cab-ir",
+                    [](StageContext& ctx) {
+                      const auto* asset = embedded_cab_ir::GetCuratedCabIRAsset(1, 0);
+                      dsp::ImpulseResponse::IRData irData;
+                      irData.mRawAudio.assign(asset->samples, asset->samples + asset->numSamples);
+                      irData.mRawAudioSampleRate = asset->sampleRate;
+                      for (auto& ir : ctx.irs)
+                        ir = std::make_unique<AccountedImpulseResponse>(irData, ctx.sampleRate);
+                    },
+                    [](StageContext& ctx) {
+                      for (size_t c = 0; c < ctx.numChannelsMonoCore; ++c)
+                      {
+                        iplug::sample* channelInput[1] = {ctx.inputs[c]};
+                        iplug::sample** irOutput = ctx.irs[c]->Process(channelInput, 1, ctx.numFrames);
+                        std::copy_n(irOutput[0], ctx.numFrames, ctx.outputs[c]);
+                      }
+                    },
+                    false});
+  // The stages below run on the stereo FX bus; the core only changes how they treat a dual-mono source.
+  stages.push_back({"post-cab-eq",
+                    [](StageContext& ctx) {
+                      SetParam(*ctx.plug, kFXEQBand125Hz, 3.0);
+                      SetParam(*ctx.plug, kFXEQBand1kHz, -4.0);
+                      SetParam(*ctx.plug, kFXEQBand8kHz, 2.0);
+                    },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessPostCabEQ(*ctx.plug, ctx.inputs, ctx.numFrames, ctx.sampleRate);
+                    }});
+  stages.push_back({"virtual-double", [](StageContext& ctx) { SetParam(*ctx.plug, kVirtualDoubleActive, 1.0); },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessVirtualDouble(
+                        *ctx.plug, ctx.inputs, ctx.numChannelsMonoCore, ctx.numFrames, ctx.sampleRate);
+                    }});
+  stages.push_back({"delay",
+                    [](StageContext& ctx) {
+                      SetParam(*ctx.plug, kFXDelayActive, 1.0);
+                      SetParam(*ctx.plug, kFXDelayFeedback, 40.0);
+                    },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessFXDelay(
+                        *ctx.plug, ctx.inputs, ctx.numChannelsMonoCore, ctx.numFrames, ctx.sampleRate);
+                    }});
+  stages.push_back({"reverb",
+                    [](StageContext& ctx) {
+                      SetParam(*ctx.plug, kFXReverbActive, 1.0);
+                      NAMHeadlessProbe::ResetFXReverb(*ctx.plug);
+                    },
+                    [](StageContext& ctx) {
+                      NAMHeadlessProbe::ProcessFXReverb(
+                        *ctx.plug, ctx.inputs, ctx.numChannelsMonoCore, ctx.numFrames, ctx.sampleRate);
+                    }});
+  return stages;
+}
+
+double MeasureStageNsPerSample(const StageDef& stage, NeuralAmpModeler& plug, const StageMeasureSettings& settings,
+                               const std::vector<float>& source, StageBuffers& buffers)
+{
+  StageContext ctx;
+  ctx.plug = &plug;
+  ctx.sampleRate = settings.sampleRate;
+  ctx.numFrames = static_cast<size_t>(std::clamp(settings.blockSize, 1, kMaxStageBlockSize));
+  ctx.numChannelsMonoCore = settings.numChannelsMonoCore;
+  ctx.inputs = buffers.inputPointers.data();
+  ctx.outputs = buffers.outputPointers.data();
+  stage.setup(ctx);
+
+  const size_t numBlocks = std::max<size_t>(
+    64, static_cast<size_t>(std::ceil(settings.seconds * settings.sampleRate / static_cast<double>(ctx.numFrames))));
+  RunBlocks(ctx, buffers, source, std::max<size_t>(8, numBlocks / 10), &stage.process);
+
+  double bestStageSeconds = 0.0;
+  double bestOverheadSeconds = 0.0;
+  for (int repeat = 0; repeat < std::max(1, settings.repeats); ++repeat)
+  {
+    const double stageSeconds = RunBlocks(ctx, buffers, source, numBlocks, &stage.process);
+    const double overheadSeconds = RunBlocks(ctx, buffers, source, numBlocks, nullptr);
+    bestStageSeconds = (repeat == 0) ? stageSeconds : std::min(bestStageSeconds, stageSeconds);
+    bestOverheadSeconds = (repeat == 0) ? overheadSeconds : std::min(bestOverheadSeconds, overheadSeconds);
+  }
+
+  const double totalFrames = static_cast<double>(numBlocks) * static_cast<double>(ctx.numFrames);
+  return std::max(0.0, bestStageSeconds - bestOverheadSeconds) * 1.0e9 / totalFrames;
+}
+} // namespace headless
@@ -0,0 +1,64 @@
+#pragma once
+
+// Isolated built-in DSP stages of the ProcessBlock() chain, shared by nam-stage-bench, nam-perf-gate and nam-golden.
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../NeuralAmpModeler.h"
+
+namespace headless
+{
+constexpr int kMaxStageBlockSize = 4096;
+
+struct StageContext
+{
+  NeuralAmpModeler* plug = nullptr;
+  double sampleRate = 48000.0;
+  size_t numFrames = 0;
+  size_t numChannelsMonoCore = 1;
+  iplug::sample** inputs = nullptr;
+  iplug::sample** outputs = nullptr;
+  std::unique_ptr<dsp::tone_stack::AbstractToneStack> toneStack;
+  std::array<std::unique_ptr<dsp::ImpulseResponse>, kNumChannelsInternal> irs;
+};
+
+struct StageDef
+{
+  const char* name;
+  // Called once per (sample rate, block size, core) before warm-up.
+  std::function<void(StageContext&)> setup;
+  // Processes ctx.inputs (and ctx.outputs for stages that are not in-place) for ctx.numFrames.
+  std::function<void(StageContext&)> process;
+  // Whether the result ends up in ctx.inputs (true) or ctx.outputs (false).
+  bool inPlace = true;
+};
+
+struct StageBuffers
+{
+  std::vector<std::vector<iplug::sample>> input;
+  std::vector<std::vector<iplug::sample>> output;
+  std::vector<iplug::sample*> inputPointers;
+  std::vector<iplug::sample*> outputPointers;
+
+  StageBuffers();
+};
+
+struct StageMeasureSettings
+{
+  double sampleRate = 48000.0;
+  int blockSize = 64;
+  size_t numChannelsMonoCore = 1;
+  double seconds = 1.0;
+  int repeats = 3;
+};
+
+std::vector<StageDef> MakeStages();
+
+// Runs the stage over `source` after a short warm-up and returns the best-of-repeats cost in ns per sample frame,
+// with the per-block input refresh timed separately and subtracted. plug must be prepared at settings.sampleRate.
+double MeasureStageNsPerSample(const StageDef& stage, NeuralAmpModeler& plug, const StageMeasureSettings& settings,
+                               const std::vector<float>& source, StageBuffers& buffers);
+} // namespace headless
@@ -0,0 +1,50 @@
+#pragma once
+
+// Timing summaries shared by the headless tools.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace headless
+{
+struct TimingSummary
+{
+  size_t count = 0;
+  double min = 0.0;
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p99 = 0.0;
+  double p999 = 0.0;
+  double max = 0.0;
+};
+
+// Nearest-rank percentile of an ascending-sorted vector; fraction in [0, 1].
+inline double PercentileOfSorted(const std::vector<double>& sorted, const double fraction)
+{
+  if (sorted.empty())
+    return 0.0;
+  const double rank = std::ceil(fraction * static_cast<double>(sorted.size()));
+  const size_t index = static_cast<size_t>(std::clamp(rank, 1.0, static_cast<double>(sorted.size()))) - 1;
+  return sorted[index];
+}
+
+inline TimingSummary SummarizeTimings(std::vector<double> values)
+{
+  TimingSummary summary;
+  summary.count = values.size();
+  if (values.empty())
+    return summary;
+  std::sort(values.begin(), values.end());
+  double total = 0.0;
+  for (const double value : values)
+    total += value;
+  summary.min = values.front();
+  summary.mean = total / static_cast<double>(values.size());
+  summary.p50 = PercentileOfSorted(values, 0.50);
+  summary.p99 = PercentileOfSorted(values, 0.99);
+  summary.p999 = PercentileOfSorted(values, 0.999);
+  summary.max = values.back();
+  return summary;
+}
+} // namespace headless
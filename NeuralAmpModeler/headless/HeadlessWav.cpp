@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "HeadlessWav.h"
+
+namespace headless
+{
+namespace
+{
+constexpr uint16_t kWavFormatPCM = 1;
+constexpr uint16_t kWavFormatIEEEFloat = 3;
+constexpr uint16_t kWavFormatExtensible = 0xFFFE;
+
+uint16_t ReadU16(const unsigned char* p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const unsigned char* p)
+{
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16)
+         | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void WriteU16(std::ofstream& out, const uint16_t value)
+{
+  const unsigned char bytes[2] = {static_cast<unsigned char>(value & 0xFF), static_cast<unsigned char>(value >> 8)};
+  out.write(reinterpret_cast<const char*>(bytes), 2);
+}
+
+void WriteU32(std::ofstream& out, const uint32_t value)
+{
+  const unsigned char bytes[4] = {
+    static_cast<unsigned char>(value & 0xFF), static_cast<unsigned char>((value >> 8) & 0xFF),
+    static_cast<unsigned char>((value >> 16) & 0xFF), static_cast<unsigned char>((value >> 24) & 0xFF)};
+  out.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+float DecodeSample(const unsigned char* p, const uint16_t format, const uint16_t bitsPerSample)
+{
+  if (format == kWavFormatIEEEFloat)
+  {
+    if (bitsPerSample == 64)
+    {
+      double value = 0.0;
+      std::memcpy(&value, p, sizeof(value));
+      return static_cast<float>(value);
+    }
+    float value = 0.0f;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  switch (bitsPerSample)
+  {
+    case 16: return static_cast<float>(static_cast<int16_t>(ReadU16(p))) / 32768.0f;
+    case 24:
+    {
+      int32_t value = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+      if (value & 0x800000)
+        value |= ~0xFFFFFF;
+      return static_cast<float>(value) / 8388608.0f;
+    }
+    case 32: return static_cast<float>(static_cast<double>(static_cast<int32_t>(ReadU32(p))) / 2147483648.0);
+    default: return 0.0f;
+  }
+}
+} // namespace
+
+bool ReadWav(const std::string& path, WavData& wav, std::string& errorMessage)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+  {
+    errorMessage = "Cannot open " + path;
+    return false;
+  }
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0)
+  {
+    errorMessage = path + " is not a RIFF/WAVE file";
+    return false;
+  }
+
+  uint16_t format = 0;
+  uint16_t numChannels = 0;
+  uint32_t sampleRate = 0;
+  uint16_t bitsPerSample = 0;
+  const unsigned char* pData = nullptr;
+  size_t dataSize = 0;
+  size_t pos = 12;
+  while (pos + 8 <= bytes.size())
+  {
+    const unsigned char* chunk = bytes.data() + pos;
+    const size_t chunkSize = ReadU32(chunk + 4);
+    const size_t available = std::min(chunkSize, bytes.size() - pos - 8);
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16)
+    {
+      format = ReadU16(chunk + 8);
+      numChannels = ReadU16(chunk + 10);
+      sampleRate = ReadU32(chunk + 12);
+      bitsPerSample = ReadU16(chunk + 22);
+      if (format == kWavFormatExtensible && available >= 26)
+        format = ReadU16(chunk + 32);
+    }
+    else if (std::memcmp(chunk, "data", 4) == 0)
+    {
+      pData = chunk + 8;
+      dataSize = available;
+    }
+    pos += 8 + chunkSize + (chunkSize & 1);
+  }
+
+  const bool supportedPCM =
+    format == kWavFormatPCM && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+  const bool supportedFloat = format == kWavFormatIEEEFloat && (bitsPerSample == 32 || bitsPerSample == 64);
+  const bool supported = supportedPCM || supportedFloat;
+  if (!supported || numChannels == 0 || sampleRate == 0 || pData == nullptr)
+  {
+    errorMessage = path + ": unsupported or incomplete WAV format";
+    return false;
+  }
+
+  const size_t bytesPerSample = bitsPerSample / 8;
+  const size_t frameBytes = bytesPerSample * numChannels;
+  const size_t numFrames = dataSize / frameBytes;
+  wav.sampleRate = static_cast<double>(sampleRate);
+  wav.channels.assign(numChannels, std::vector<float>(numFrames));
+  for (size_t frame = 0; frame < numFrames; ++frame)
+  {
+    const unsigned char* pFrame = pData + frame * frameBytes;
+    for (uint16_t ch = 0; ch < numChannels; ++ch)
+      wav.channels[ch][frame] = DecodeSample(pFrame + ch * bytesPerSample, format, bitsPerSample);
+  }
+  return true;
+}
+
+bool WriteWavFloat32(const std::string& path, const WavData& wav, std::string& errorMessage)
+{
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+  {
+    errorMessage = "Cannot write " + path;
+    return false;
+  }
+  const uint16_t numChannels = static_cast<uint16_t>(wav.channels.size());
+  const size_t numFrames = wav.GetNumFrames();
+  const uint32_t dataSize = static_cast<uint32_t>(numFrames * numChannels * sizeof(float));
+  const uint32_t sampleRate = static_cast<uint32_t>(wav.sampleRate + 0.5);
+
+  out.write("RIFF", 4);
+  WriteU32(out, 36 + dataSize);
+  out.write("WAVE", 4);
+  out.write("fmt ", 4);
+  WriteU32(out, 16);
+  WriteU16(out, kWavFormatIEEEFloat);
+  WriteU16(out, numChannels);
+  WriteU32(out, sampleRate);
+  WriteU32(out, sampleRate * numChannels * sizeof(float));
+  WriteU16(out, static_cast<uint16_t>(numChannels * sizeof(float)));
+  WriteU16(out, 32);
+  out.write("data", 4);
+  WriteU32(out, dataSize);
+
+  std::vector<float> interleaved(numFrames * numChannels);
+  for (size_t frame = 0; frame < numFrames; ++frame)
+    for (uint16_t ch = 0; ch < numChannels; ++ch)
+      interleaved[frame * numChannels + ch] = wav.channels[ch][frame];
+  out.write(reinterpret_cast<const char*>(interleaved.data()), static_cast<std::streamsize>(dataSize));
+  if (!out)
+  {
+    errorMessage = "Failed writing " + path;
+    return false;
+  }
+  return true;
+}
+} // namespace headless
@@ -0,0 +1,22 @@
+#pragma once
+
+// Small WAV reader/writer for the headless tools. Reads PCM 16/24/32-bit and IEEE float 32/64-bit; writes 32-bit
+// float. Samples are stored de-interleaved, one vector per channel.
+
+#include <string>
+#include <vector>
+
+namespace headless
+{
+struct WavData
+{
+  double sampleRate = 48000.0;
+  std::vector<std::vector<float>> channels;
+
+  size_t GetNumFrames() const { return channels.empty() ? 0 : channels.front().size(); }
+};
+
+// Returns false and fills errorMessage on failure.
+bool ReadWav(const std::string& path, WavData& wav, std::string& errorMessage);
+bool WriteWavFloat32(const std::string& path, const WavData& wav, std::string& errorMessage);
+} // namespace headless
@@ -0,0 +1,55 @@
+#include <algorithm>
+
+#include "IPlugHeadless.h"
+
+using namespace iplug;
+
+IPlugHeadless::IPlugHeadless(const InstanceInfo& info, const Config& config)
+: IPlugAPIBase(config, kAPIAPP)
+, IPlugProcessor(config, kAPIAPP)
+{
+  (void) info;
+  SetChannelConnections(ERoute::kInput, 0, MaxNChannels(ERoute::kInput), false);
+  SetChannelConnections(ERoute::kOutput, 0, MaxNChannels(ERoute::kOutput), false);
+}
+
+void IPlugHeadless::Prepare(const double sampleRate, const int maxBlockSize, const int numInputs, const int numOutputs)
+{
+  mNumInputs = std::clamp(numInputs, 0, MaxNChannels(ERoute::kInput));
+  mNumOutputs = std::clamp(numOutputs, 0, MaxNChannels(ERoute::kOutput));
+
+  SetChannelConnections(ERoute::kInput, 0, MaxNChannels(ERoute::kInput), false);
+  SetChannelConnections(ERoute::kInput, 0, mNumInputs, true);
+  SetChannelConnections(ERoute::kOutput, 0, MaxNChannels(ERoute::kOutput), false);
+  SetChannelConnections(ERoute::kOutput, 0, mNumOutputs, true);
+
+  SetSampleRate(sampleRate);
+  SetBlockSize(std::max(1, maxBlockSize));
+  OnReset();
+  OnActivate(true);
+}
+
+void IPlugHeadless::Process(sample** inputs, sample** outputs, const int nFrames)
+{
+  AttachBuffers(ERoute::kInput, 0, mNumInputs, inputs, nFrames);
+  AttachBuffers(ERoute::kOutput, 0, mNumOutputs, outputs, nFrames);
+  ProcessBuffers(static_cast<sample>(0), nFrames);
+}
+
+void IPlugHeadless::SetTransport(const double tempo, const double samplePos, const bool isPlaying)
+{
+  ITimeInfo timeInfo;
+  timeInfo.mTempo = tempo;
+  timeInfo.mSamplePos = samplePos;
+  timeInfo.mTransportIsRunning = isPlaying;
+  SetTimeInfo(timeInfo);
+}
+
+void IPlugHeadless::SetParameterFromHost(const int paramIdx, const double normalizedValue)
+{
+  if (paramIdx < 0 || paramIdx >= NParams())
+    return;
+  GetParam(paramIdx)->SetNormalized(normalizedValue);
+  OnParamChange(paramIdx, kHost, -1);
+  OnParamChangeUI(paramIdx, kHost);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Minimal iPlug2 API class for running the plugin without an editor or a plug-in SDK.
+// The owning tool plays the host: it configures the stream with Prepare(), pushes audio through Process(), and calls
+// OnIdle() itself where a host would run the UI timer.
+
+#include "IPlugAPIBase.h"
+#include "IPlugProcessor.h"
+
+BEGIN_IPLUG_NAMESPACE
+
+/** Used to pass various instance info to the API class */
+struct InstanceInfo
+{
+};
+
+class IPlugHeadless : public IPlugAPIBase, public IPlugProcessor
+{
+public:
+  IPlugHeadless(const InstanceInfo& info, const Config& config);
+
+  // IPlugProcessor
+  bool SendMidiMsg(const IMidiMsg& msg) override { return false; }
+  bool SendSysEx(const ISysEx& msg) override { return false; }
+
+  // Configure channel connections, sample rate and maximum block size, then call OnReset() like a host (re)activating
+  // the plug-in. Call again to simulate a sample rate or buffer size change.
+  void Prepare(double sampleRate, int maxBlockSize, int numInputs, int numOutputs);
+  // Render one block through ProcessBlock(). nFrames must not exceed the maxBlockSize given to Prepare().
+  void Process(sample** inputs, sample** outputs, int nFrames);
+  // Transport state reported to the plug-in via GetTempo()/GetSamplePos()/GetTransportIsRunning().
+  void SetTransport(double tempo, double samplePos, bool isPlaying);
+  // Parameter automation as a host delivers it: set the value, then OnParamChange() and OnParamChangeUI().
+  void SetParameterFromHost(int paramIdx, double normalizedValue);
+
+  int GetNumInputs() const { return mNumInputs; }
+  int GetNumOutputs() const { return mNumOutputs; }
+
+private:
+  int mNumInputs = 0;
+  int mNumOutputs = 0;
+};
+
+IPlugHeadless* MakePlug(const InstanceInfo& info);
+
+END_IPLUG_NAMESPACE
@@ -0,0 +1,96 @@
+// iPlug2's IPlugPaths.cpp and IPlugTimer.cpp have no Linux backend. The headless build compiles this file in their
+// place: every location resolves relative to the running executable or the user's home directory, and timers never
+// fire because the owning tool calls OnIdle() itself.
+
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+
+#include "IPlugPaths.h"
+#include "IPlugTimer.h"
+
+BEGIN_IPLUG_NAMESPACE
+
+namespace
+{
+std::filesystem::path GetExecutableDirectory()
+{
+  std::error_code ec;
+  const std::filesystem::path exePath = std::filesystem::read_symlink("/proc/self/exe", ec);
+  if (ec || exePath.empty())
+    return std::filesystem::current_path(ec);
+  return exePath.parent_path();
+}
+
+void SetPath(WDL_String& path, const std::filesystem::path& value)
+{
+  path.Set(value.string().c_str());
+}
+
+class HeadlessTimer final : public Timer
+{
+public:
+  void Stop() override {}
+};
+} // namespace
+
+Timer* Timer::Create(ITimerFunction func, uint32_t intervalMs)
+{
+  (void) func;
+  (void) intervalMs;
+  return new HeadlessTimer();
+}
+
+void HostPath(WDL_String& path, const char* bundleID)
+{
+  (void) bundleID;
+  SetPath(path, GetExecutableDirectory());
+}
+
+void PluginPath(WDL_String& path, PluginIDType pExtra)
+{
+  (void) pExtra;
+  SetPath(path, GetExecutableDirectory());
+}
+
+void BundleResourcePath(WDL_String& path, PluginIDType pExtra)
+{
+  (void) pExtra;
+  SetPath(path, GetExecutableDirectory() / "resources");
+}
+
+void UserHomePath(WDL_String& path)
+{
+  const char* home = std::getenv("HOME");
+  path.Set(home != nullptr ? home : "");
+}
+
+void DesktopPath(WDL_String& path)
+{
+  UserHomePath(path);
+  if (path.GetLength() > 0)
+    SetPath(path, std::filesystem::path(path.Get()) / "Desktop");
+}
+
+void AppSupportPath(WDL_String& path, bool isSystem)
+{
+  (void) isSystem;
+  const char* configHome = std::getenv("XDG_CONFIG_HOME");
+  if (configHome != nullptr && configHome[0] != '\0')
+  {
+    path.Set(configHome);
+    return;
+  }
+  UserHomePath(path);
+  if (path.GetLength() > 0)
+    SetPath(path, std::filesystem::path(path.Get()) / ".config");
+}
+
+void INIPath(WDL_String& path, const char* pluginName)
+{
+  AppSupportPath(path);
+  if (path.GetLength() > 0 && pluginName != nullptr)
+    SetPath(path, std::filesystem::path(path.Get()) / pluginName);
+}
+
+END_IPLUG_NAMESPACE
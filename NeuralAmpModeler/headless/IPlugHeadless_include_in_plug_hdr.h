@@ -0,0 +1,41 @@
+#pragma once
+
+// Headless counterpart of iPlug2's IPlug_include_in_plug_hdr.h, selected by NeuralAmpModeler.h when HEADLESS_API is
+// defined. The headless build is DSP-only: it must be compiled with NO_IGRAPHICS, IPLUG_EDITOR=0 and IPLUG_DSP=1.
+
+#include <cstdio>
+#include "IPlugPlatform.h"
+#include "config.h"
+
+#if !defined(NO_IGRAPHICS) || IPLUG_EDITOR
+  #error "The headless API is DSP-only. Define NO_IGRAPHICS and IPLUG_EDITOR=0."
+#endif
+
+#include "IPlugHeadless.h"
+#define PLUGIN_API_BASE IPlugHeadless
+#define API_EXT "headless"
+
+#ifndef PUBLIC_NAME
+  #define PUBLIC_NAME PLUG_NAME
+#endif
+
+#ifndef BUNDLE_ID
+  #define BUNDLE_ID BUNDLE_DOMAIN "." BUNDLE_MFR "." BUNDLE_NAME
+#endif
+
+#ifndef APP_GROUP_ID
+  #define APP_GROUP_ID ""
+#endif
+
+#ifndef PLUG_MIN_WIDTH
+  #define PLUG_MIN_WIDTH (PLUG_WIDTH / 2)
+#endif
+
+#ifndef PLUG_MIN_HEIGHT
+  #define PLUG_MIN_HEIGHT (PLUG_HEIGHT / 2)
+#endif
+
+BEGIN_IPLUG_NAMESPACE
+using Plugin = PLUGIN_API_BASE;
+Config MakeConfig(int nParams, int nPresets);
+END_IPLUG_NAMESPACE
@@ -0,0 +1,27 @@
+#pragma once
+
+// Headless counterpart of iPlug2's IPlug_include_in_plug_src.h. Include once, from the plug-in's .cpp.
+
+#ifndef HEADLESS_API
+  #error "IPlugHeadless_include_in_plug_src.h requires HEADLESS_API"
+#endif
+
+// Module handle used by PluginPath(). There is no plug-in binary in a headless build.
+void* gHINSTANCE = nullptr;
+
+BEGIN_IPLUG_NAMESPACE
+
+Config MakeConfig(int nParams, int nPresets)
+{
+  return Config(nParams, nPresets, PLUG_CHANNEL_IO, PUBLIC_NAME, PUBLIC_NAME, PLUG_MFR, PLUG_VERSION_HEX,
+                PLUG_UNIQUE_ID, PLUG_MFR_ID, PLUG_LATENCY, PLUG_DOES_MIDI_IN, PLUG_DOES_MIDI_OUT, PLUG_DOES_MPE,
+                PLUG_DOES_STATE_CHUNKS, PLUG_TYPE, false /* plugHasUI */, PLUG_WIDTH, PLUG_HEIGHT, PLUG_HOST_RESIZE,
+                PLUG_MIN_WIDTH, PLUG_MAX_WIDTH, PLUG_MIN_HEIGHT, PLUG_MAX_HEIGHT, BUNDLE_ID, APP_GROUP_ID);
+}
+
+IPlugHeadless* MakePlug(const InstanceInfo& info)
+{
+  return new PLUG_CLASS_NAME(info);
+}
+
+END_IPLUG_NAMESPACE
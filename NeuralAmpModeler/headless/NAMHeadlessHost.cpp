@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "NAMHeadlessHost.h"
+#include "NAMHeadlessProbe.h"
+
+namespace headless
+{
+NAMHeadlessHost::NAMHeadlessHost()
+: mPlug(std::make_unique<NeuralAmpModeler>(iplug::InstanceInfo{}))
+{
+}
+
+NAMHeadlessHost::~NAMHeadlessHost() = default;
+
+void NAMHeadlessHost::Prepare(const double sampleRate, const int maxBlockSize, const int numInputs)
+{
+  mSampleRate = sampleRate;
+  mMaxBlockSize = std::max(1, maxBlockSize);
+  mNumInputs = std::clamp(numInputs, 1, 2);
+  mSamplePos = 0.0;
+
+  mInputBuffers.assign(static_cast<size_t>(mNumInputs), std::vector<iplug::sample>(mMaxBlockSize, 0.0));
+  mOutputBuffers.assign(kNumOutputs, std::vector<iplug::sample>(mMaxBlockSize, 0.0));
+  mInputPointers.clear();
+  mOutputPointers.clear();
+  for (auto& buffer : mInputBuffers)
+    mInputPointers.push_back(buffer.data());
+  for (auto& buffer : mOutputBuffers)
+    mOutputPointers.push_back(buffer.data());
+
+  mPlug->Prepare(mSampleRate, mMaxBlockSize, mNumInputs, kNumOutputs);
+}
+
+bool NAMHeadlessHost::LoadPreset(const std::string& presetPath)
+{
+  return NAMHeadlessProbe::LoadPresetFile(*mPlug, WDL_String(presetPath.c_str()));
+}
+
+bool NAMHeadlessHost::Settle(const double timeoutSeconds)
+{
+  // Silent blocks let the audio thread pick up staged models; OnIdle() runs the main-thread half of the handoff.
+  std::vector<float> silence(static_cast<size_t>(mMaxBlockSize), 0.0f);
+  std::vector<float> scratch(static_cast<size_t>(mMaxBlockSize * kNumOutputs), 0.0f);
+  const float* inputs[2] = {silence.data(), silence.data()};
+  float* outputs[kNumOutputs] = {scratch.data(), scratch.data() + mMaxBlockSize};
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeoutSeconds);
+  while (true)
+  {
+    Idle();
+    ProcessBlock(inputs, outputs, mMaxBlockSize);
+    if (NAMHeadlessProbe::IsSettled(*mPlug))
+      return true;
+    if (std::chrono::steady_clock::now() >= deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void NAMHeadlessHost::ProcessBlock(const float* const* inputs, float* const* outputs, const int nFrames)
+{
+  const int frames = std::clamp(nFrames, 0, mMaxBlockSize);
+  for (int ch = 0; ch < mNumInputs; ++ch)
+    std::copy(inputs[ch], inputs[ch] + frames, mInputBuffers[static_cast<size_t>(ch)].begin());
+
+  mPlug->SetTransport(120.0, mSamplePos, true);
+  mPlug->Process(mInputPointers.data(), mOutputPointers.data(), frames);
+  mSamplePos += frames;
+
+  for (int ch = 0; ch < kNumOutputs; ++ch)
+    for (int s = 0; s < frames; ++s)
+      outputs[ch][s] = static_cast<float>(mOutputBuffers[static_cast<size_t>(ch)][static_cast<size_t>(s)]);
+}
+
+void NAMHeadlessHost::Idle()
+{
+  mPlug->OnIdle();
+}
+} // namespace headless
@@ -0,0 +1,48 @@
+#pragma once
+
+// Plays the host for a single NeuralAmpModeler instance: owns the plug-in and its channel buffers, drives OnIdle()
+// in place of the UI timer, and pushes float audio through the full ProcessBlock() chain.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../NeuralAmpModeler.h"
+
+namespace headless
+{
+class NAMHeadlessHost
+{
+public:
+  NAMHeadlessHost();
+  ~NAMHeadlessHost();
+
+  // (Re)configure the stream. The plug-in always renders two outputs; numInputs is 1 (mono DI) or 2.
+  void Prepare(double sampleRate, int maxBlockSize, int numInputs);
+  bool LoadPreset(const std::string& presetPath);
+  // Pump OnIdle() and silent blocks until pending model/IR loads have been applied. Returns false on timeout.
+  bool Settle(double timeoutSeconds);
+  // Render nFrames (<= maxBlockSize). inputs holds GetNumInputs() channels, outputs holds two.
+  void ProcessBlock(const float* const* inputs, float* const* outputs, int nFrames);
+  void Idle();
+
+  NeuralAmpModeler& GetPlug() { return *mPlug; }
+  double GetSampleRate() const { return mSampleRate; }
+  int GetMaxBlockSize() const { return mMaxBlockSize; }
+  int GetNumInputs() const { return mNumInputs; }
+  int GetNumOutputs() const { return kNumOutputs; }
+
+private:
+  static constexpr int kNumOutputs = 2;
+
+  std::unique_ptr<NeuralAmpModeler> mPlug;
+  double mSampleRate = 48000.0;
+  int mMaxBlockSize = 0;
+  int mNumInputs = 0;
+  double mSamplePos = 0.0;
+  std::vector<std::vector<iplug::sample>> mInputBuffers;
+  std::vector<std::vector<iplug::sample>> mOutputBuffers;
+  std::vector<iplug::sample*> mInputPointers;
+  std::vector<iplug::sample*> mOutputPointers;
+};
+} // namespace headless
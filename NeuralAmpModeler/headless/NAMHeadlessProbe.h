@@ -0,0 +1,127 @@
+#pragma once
+
+// Befriended by NeuralAmpModeler when HEADLESS_API is defined. Gives the offline tools in this directory access to
+// the loader/staging internals a real host never needs to see.
+
+#include <mutex>
+
+#include "../NeuralAmpModeler.h"
+
+class NAMHeadlessProbe
+{
+public:
+  // Recall a .nampreset the same way the standalone preset browser does.
+  static bool LoadPresetFile(NeuralAmpModeler& plug, const WDL_String& filePath)
+  {
+    return plug._LoadStandalonePresetFromFile(filePath);
+  }
+
+  // True once no model/IR load is queued, in flight, or waiting for the audio thread to pick it up, and the preset
+  // recall mute has released. Call between blocks (from the thread that calls ProcessBlock()).
+  static bool IsSettled(NeuralAmpModeler& plug)
+  {
+    {
+      std::lock_guard<std::mutex> lock(plug.mModelLoadMutex);
+      if (!plug.mModelLoadJobs.empty())
+        return false;
+    }
+    // 1 == Loading (see kAmpSlotModelState* in NeuralAmpModeler.cpp).
+    for (const auto& state : plug.mAmpSlotModelState)
+      if (state.load(std::memory_order_acquire) == 1)
+        return false;
+    for (const auto& pending : plug.mPendingLoadedSlotModel)
+      if (pending.load(std::memory_order_acquire) != nullptr)
+        return false;
+    for (const auto& pending : plug.mPendingLoadedSlotModelRight)
+      if (pending.load(std::memory_order_acquire) != nullptr)
+        return false;
+    if (plug.mPendingAmpModelSelection.load(std::memory_order_acquire) >= 0)
+      return false;
+    if (plug.mStagedModel != nullptr || plug.mStagedStompModel != nullptr || plug.mStagedStompModelB != nullptr)
+      return false;
+    if (plug.mStagedIR != nullptr || plug.mStagedIRRight != nullptr || plug.mStagedCabBIR != nullptr
+        || plug.mStagedCabBIRSecondary != nullptr)
+      return false;
+    return !plug.mPresetRecallMuteActive.load(std::memory_order_acquire);
+  }
+
+  // Same as building with NAM_RELEASE_MODE set accordingly. Call after construction and before the first
+  // Prepare(), which is where the startup model/IR loads are queued.
+  static void SetAmpWorkflowMode(NeuralAmpModeler& plug, const bool releaseMode)
+  {
+    plug.mAmpWorkflowMode =
+      releaseMode ? NeuralAmpModeler::AmpWorkflowMode::Release : NeuralAmpModeler::AmpWorkflowMode::Rig;
+    plug.mAmpSlotModelEditLocked.fill(releaseMode);
+  }
+  // True once the audio thread has an amp model for the selected slot. Call from the thread that calls ProcessBlock().
+  static bool HasLiveAmpModel(const NeuralAmpModeler& plug) { return plug.mModel != nullptr; }
+  // Memory held by models, IRs and FX buffers. Call between blocks (from the thread that calls ProcessBlock()).
+  static void CollectMemoryReport(const NeuralAmpModeler& plug, MemoryReport& report)
+  {
+    plug._CollectMemoryReport(report);
+  }
+
+  // Main-thread actions normally triggered from the editor.
+  static int GetAmpSlotCount(const NeuralAmpModeler& plug) { return static_cast<int>(plug.mAmpNAMPaths.size()); }
+  static int GetAmpModelVariantCount() { return NeuralAmpModeler::kAmpModelVariantCount; }
+  static void SelectAmpSlot(NeuralAmpModeler& plug, int slotIndex) { plug._SelectAmpSlot(slotIndex); }
+  static void SelectAmpSlotModelVariant(NeuralAmpModeler& plug, int slotIndex, int variantIndex)
+  {
+    plug._SelectAmpSlotModelVariant(slotIndex, variantIndex);
+  }
+  // The editor's cab source/position handlers restage the slot IRs; without an editor this must be called explicitly.
+  static void ApplyCabSlotSource(NeuralAmpModeler& plug, int slotIndex) { plug._ApplyCabSlotSource(slotIndex); }
+  // What the editor's IR file browser does for the cab A left/right IR.
+  static dsp::wav::LoadReturnCode StageIRFile(NeuralAmpModeler& plug, const bool right, const WDL_String& irPath)
+  {
+    return right ? plug._StageIRRight(irPath, false) : plug._StageIRLeft(irPath, false);
+  }
+
+  // Individual ProcessBlock() stages, for isolated benchmarking. Same arguments as the plug-in's own call sites.
+  static void ProcessCompressor(NeuralAmpModeler& plug, iplug::sample** inputs, iplug::sample** outputs,
+                                size_t numChannels, size_t numFrames)
+  {
+    plug._ProcessBuiltInCompressor(inputs, outputs, numChannels, numFrames);
+  }
+  static void ProcessTSBoost(NeuralAmpModeler& plug, iplug::sample** inputs, iplug::sample** outputs,
+                             size_t numChannels, size_t numFrames)
+  {
+    plug._ProcessBuiltInTSBoost(inputs, outputs, numChannels, numFrames);
+  }
+  static void ProcessPrecisionBoost(NeuralAmpModeler& plug, iplug::sample** inputs, iplug::sample** outputs,
+                                    size_t numChannels, size_t numFrames)
+  {
+    plug._ProcessBuiltInPrecisionBoost(inputs, outputs, numChannels, numFrames);
+  }
+  // Latch the master behavior of an amp slot, as ProcessBlock() does for the active slot.
+  static void SetActiveAmpMasterSlot(NeuralAmpModeler& plug, int slotIndex)
+  {
+    plug._UpdateActiveAmpMasterState(slotIndex);
+  }
+  static void ProcessAmpMaster(NeuralAmpModeler& plug, iplug::sample** ioPointers, size_t numChannels,
+                               size_t numFrames)
+  {
+    plug._ProcessAmpMasterStage(ioPointers, numChannels, numFrames);
+  }
+  static void ProcessPostCabEQ(NeuralAmpModeler& plug, iplug::sample** ioPointers, size_t numFrames,
+                               double sampleRate)
+  {
+    plug._ProcessPostCabEQStage(ioPointers, kNumChannelsInternal, numFrames, sampleRate);
+  }
+  static void ProcessVirtualDouble(NeuralAmpModeler& plug, iplug::sample** ioPointers, size_t numChannelsMonoCore,
+                                   size_t numFrames, double sampleRate)
+  {
+    plug._ProcessVirtualDoubleStage(ioPointers, kNumChannelsInternal, numChannelsMonoCore, numFrames, sampleRate);
+  }
+  static void ProcessFXDelay(NeuralAmpModeler& plug, iplug::sample** ioPointers, size_t numChannelsMonoCore,
+                             size_t numFrames, double sampleRate)
+  {
+    plug._ProcessFXDelayStage(ioPointers, kNumChannelsInternal, numChannelsMonoCore, numFrames, sampleRate, true);
+  }
+  static void ResetFXReverb(NeuralAmpModeler& plug) { plug._ResetFXReverbState(); }
+  static void ProcessFXReverb(NeuralAmpModeler& plug, iplug::sample** ioPointers, size_t numChannelsMonoCore,
+                              size_t numFrames, double sampleRate)
+  {
+    plug._ProcessFXReverbStage(ioPointers, kNumChannelsInternal, numChannelsMonoCore, numFrames, sampleRate);
+  }
+};
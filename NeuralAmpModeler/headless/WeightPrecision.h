@@ -0,0 +1,288 @@
+#pragma once
+
+// Reduced-precision weight emulation for the headless tools: rounds every weight array of a NAM model config to what
+// fp16, bf16 or int8 storage would hold, so the fp32 kernels show the accuracy cost of storing weights that way. The
+// plug-in keeps storing and running fp32 weights.
+//
+// int8 is symmetric with one scale per output channel: each row of a weight matrix (a conv's (in, tap) weights for one
+// output, a 1x1's or LSTM gate's inputs for one output) gets its own scale, and biases, initial states and the head
+// scale stay fp32. That needs the layer layout, which GetWeightLayout() knows for Linear, LSTM and 0.5-format WaveNet
+// configs only.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+namespace headless
+{
+enum class WeightPrecision
+{
+  Float32 = 0,
+  Float16,
+  BFloat16,
+  Int8
+};
+
+inline const char* GetWeightPrecisionName(const WeightPrecision precision)
+{
+  switch (precision)
+  {
+    case WeightPrecision::Float16: return "fp16";
+    case WeightPrecision::BFloat16: return "bf16";
+    case WeightPrecision::Int8: return "int8";
+    default: return "fp32";
+  }
+}
+
+inline bool ParseWeightPrecision(const std::string& text, WeightPrecision& precision)
+{
+  for (const auto candidate :
+       {WeightPrecision::Float32, WeightPrecision::Float16, WeightPrecision::BFloat16, WeightPrecision::Int8})
+  {
+    if (text == GetWeightPrecisionName(candidate))
+    {
+      precision = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Round to nearest even on the top 16 bits.
+inline float RoundToBFloat16(const float value)
+{
+  if (!std::isfinite(value))
+    return value;
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7FFFu + ((bits >> 16) & 1u);
+  bits &= 0xFFFF0000u;
+  float rounded;
+  std::memcpy(&rounded, &bits, sizeof(rounded));
+  return rounded;
+}
+
+// IEEE half: 11 significant bits, subnormals below 2^-14, saturates to +-65504 (model weights never get near it).
+inline float RoundToFloat16(const float value)
+{
+  if (!std::isfinite(value))
+    return value;
+  constexpr float kMax = 65504.0f;
+  const float magnitude = std::fabs(value);
+  if (magnitude >= kMax)
+    return std::copysign(kMax, value);
+  int exponent;
+  std::frexp(magnitude, &exponent); // magnitude = m * 2^exponent, m in [0.5, 1)
+  // Spacing of representable values: 2^(e - 11) for normals, 2^-24 for subnormals.
+  const float step = std::ldexp(1.0f, std::max(exponent, -13) - 11);
+  return std::copysign(std::nearbyint(magnitude / step) * step, value);
+}
+
+// A run of a model's flat weight array, in order: rows x rowLength weights with one int8 scale per row, or (not
+// quantized) weights kept in fp32.
+struct WeightRun
+{
+  size_t rows = 0;
+  size_t rowLength = 0;
+  bool quantized = false;
+};
+
+// How many weights a config holds and what storing them takes.
+struct WeightStorage
+{
+  size_t numWeights = 0;
+  // int8 only: weights kept in fp32 and per-channel scales.
+  size_t numFloat32 = 0;
+  size_t numScales = 0;
+
+  size_t GetBytes(const WeightPrecision precision) const
+  {
+    switch (precision)
+    {
+      case WeightPrecision::Float16:
+      case WeightPrecision::BFloat16: return numWeights * 2;
+      case WeightPrecision::Int8: return (numWeights - numFloat32) + (numFloat32 + numScales) * sizeof(float);
+      default: return numWeights * sizeof(float);
+    }
+  }
+};
+
+inline void _AddMatrix(std::vector<WeightRun>& runs, const size_t rows, const size_t rowLength)
+{
+  runs.push_back({rows, rowLength, true});
+}
+
+inline void _AddFloat32(std::vector<WeightRun>& runs, const size_t count)
+{
+  runs.push_back({1, count, false});
+}
+
+// Core order: weights over the receptive field, then the bias.
+inline bool _GetLinearLayout(const nlohmann::json& config, std::vector<WeightRun>& runs)
+{
+  _AddMatrix(runs, 1, config.at("receptive_field").get<size_t>());
+  if (config.at("bias").get<bool>())
+    _AddFloat32(runs, 1);
+  return true;
+}
+
+// Core order per layer: the (4 * hidden, input + hidden) gate matrix row by row, the gate biases, the initial hidden
+// and cell states; then the head weights and bias.
+inline bool _GetLSTMLayout(const nlohmann::json& config, std::vector<WeightRun>& runs)
+{
+  const size_t numLayers = config.at("num_layers").get<size_t>();
+  const size_t inputSize = config.at("input_size").get<size_t>();
+  const size_t hiddenSize = config.at("hidden_size").get<size_t>();
+  for (size_t l = 0; l < numLayers; ++l)
+  {
+    _AddMatrix(runs, 4 * hiddenSize, (l == 0 ? inputSize : hiddenSize) + hiddenSize);
+    _AddFloat32(runs, 4 * hiddenSize + 2 * hiddenSize);
+  }
+  _AddMatrix(runs, 1, hiddenSize);
+  _AddFloat32(runs, 1);
+  return true;
+}
+
+// 0.5-format layer arrays, in core order: rechannel; per layer the conv ((out, in, tap), then bias), input mixin and
+// 1x1 ((out, in), then bias); head rechannel; after the last array, the head scale. Newer layer options and post-stack
+// heads change that order, so those configs have no layout here.
+inline bool _GetWaveNetLayout(const nlohmann::json& config, std::vector<WeightRun>& runs)
+{
+  if (config.contains("head") && !config.at("head").is_null())
+    return false;
+  static const std::vector<std::string> kKnownKeys = {
+    "input_size", "condition_size", "head_size", "channels", "kernel_size", "dilations", "activation", "gated",
+    "head_bias"};
+  for (const auto& layer : config.at("layers"))
+  {
+    for (auto it = layer.begin(); it != layer.end(); ++it)
+      if (std::find(kKnownKeys.begin(), kKnownKeys.end(), it.key()) == kKnownKeys.end())
+        return false;
+    const size_t inputSize = layer.at("input_size").get<size_t>();
+    const size_t conditionSize = layer.at("condition_size").get<size_t>();
+    const size_t headSize = layer.at("head_size").get<size_t>();
+    const size_t channels = layer.at("channels").get<size_t>();
+    const size_t kernelSize = layer.at("kernel_size").get<size_t>();
+    const size_t convChannels = layer.at("gated").get<bool>() ? 2 * channels : channels;
+    _AddMatrix(runs, channels, inputSize);
+    for (size_t d = 0; d < layer.at("dilations").size(); ++d)
+    {
+      _AddMatrix(runs, convChannels, channels * kernelSize);
+      _AddFloat32(runs, convChannels);
+      _AddMatrix(runs, convChannels, conditionSize);
+      _AddMatrix(runs, channels, channels);
+      _AddFloat32(runs, channels);
+    }
+    _AddMatrix(runs, headSize, channels);
+    if (layer.at("head_bias").get<bool>())
+      _AddFloat32(runs, headSize);
+  }
+  _AddFloat32(runs, 1);
+  return true;
+}
+
+// Layout of model["weights"] for the architectures above. Returns false if it isn't known or doesn't add up to the
+// weight count.
+inline bool GetWeightLayout(const nlohmann::json& model, std::vector<WeightRun>& runs)
+{
+  runs.clear();
+  const std::string architecture = model.value("architecture", std::string());
+  if (!model.contains("config") || !model.contains("weights"))
+    return false;
+  const auto& config = model.at("config");
+  bool known = false;
+  if (architecture == "Linear")
+    known = _GetLinearLayout(config, runs);
+  else if (architecture == "LSTM")
+    known = _GetLSTMLayout(config, runs);
+  else if (architecture == "WaveNet")
+    known = _GetWaveNetLayout(config, runs);
+  size_t total = 0;
+  for (const auto& run : runs)
+    total += run.rows * run.rowLength;
+  return known && total == model.at("weights").size();
+}
+
+// Symmetric int8, one scale per row of each quantized run.
+inline void RoundToInt8Rows(std::vector<float>& weights, const std::vector<WeightRun>& runs, WeightStorage& storage)
+{
+  float* w = weights.data();
+  for (const auto& run : runs)
+  {
+    const size_t count = run.rows * run.rowLength;
+    if (!run.quantized)
+    {
+      storage.numFloat32 += count;
+      w += count;
+      continue;
+    }
+    for (size_t r = 0; r < run.rows; ++r, w += run.rowLength)
+    {
+      float maxMagnitude = 0.0f;
+      for (size_t i = 0; i < run.rowLength; ++i)
+        maxMagnitude = std::max(maxMagnitude, std::fabs(w[i]));
+      ++storage.numScales;
+      if (maxMagnitude == 0.0f)
+        continue;
+      const float scale = maxMagnitude / 127.0f;
+      for (size_t i = 0; i < run.rowLength; ++i)
+        w[i] = std::clamp(std::nearbyint(w[i] / scale), -127.0f, 127.0f) * scale;
+    }
+  }
+}
+
+// Rounds the "weights" array of every model in the config, including the submodels of a SlimmableContainer, and adds
+// up their storage. Returns false for int8 if some model has no known layout; the config is then partly rounded.
+inline bool RoundModelConfigWeights(nlohmann::json& config, const WeightPrecision precision, WeightStorage& storage)
+{
+  if (config.is_array())
+  {
+    for (auto& element : config)
+      if (!RoundModelConfigWeights(element, precision, storage))
+        return false;
+    return true;
+  }
+  if (!config.is_object())
+    return true;
+
+  for (auto it = config.begin(); it != config.end(); ++it)
+  {
+    auto& value = it.value();
+    if (!(it.key() == "weights" && value.is_array() && !value.empty() && value.front().is_number()))
+    {
+      if (!RoundModelConfigWeights(value, precision, storage))
+        return false;
+      continue;
+    }
+    auto weights = value.get<std::vector<float>>();
+    storage.numWeights += weights.size();
+    switch (precision)
+    {
+      case WeightPrecision::Float16:
+        for (auto& w : weights)
+          w = RoundToFloat16(w);
+        break;
+      case WeightPrecision::BFloat16:
+        for (auto& w : weights)
+          w = RoundToBFloat16(w);
+        break;
+      case WeightPrecision::Int8:
+      {
+        std::vector<WeightRun> runs;
+        if (!GetWeightLayout(config, runs))
+          return false;
+        RoundToInt8Rows(weights, runs, storage);
+        break;
+      }
+      default: break;
+    }
+    value = std::move(weights);
+  }
+  return true;
+}
+} // namespace headless
@@ -0,0 +1,458 @@
+// nam-golden: golden-render equivalence check. Renders a fixed DI through every isolated stage (mono and stereo
+// core) and through the whole ProcessBlock() chain (plug-in defaults plus each recorded preset), and compares each
+// render against the reference WAVs stored next to golden.json.
+//
+//   nam-golden [--golden-dir golden] [--bit-exact] [--max-abs-error 1e-4] [--min-snr-db 90] [--filter stage/reverb]
+//              [--dump-dir renders] [--require-references]
+//              [--update [--input di.wav] [--seconds 4] [--preset rig.nampreset ...]]
+//
+// Tolerance mode (default) passes an entry when its worst-channel max abs error and SNR are both within limits;
+// --bit-exact requires identical samples. Entries with no reference WAV yet are reported as skipped. Exit status: 0
+// all compared entries match, 1 mismatch, 2 usage or manifest error, 3 skipped entries with --require-references.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "architecture.hpp"
+#include "json.hpp"
+#include "HeadlessStages.h"
+#include "HeadlessWav.h"
+#include "NAMHeadlessHost.h"
+
+#ifndef NAM_GOLDEN_DIR
+  #define NAM_GOLDEN_DIR "golden"
+#endif
+#ifndef NAM_GOLDEN_DEFAULT_INPUT
+  #define NAM_GOLDEN_DEFAULT_INPUT "Guitar DI.wav"
+#endif
+
+namespace
+{
+constexpr int kGoldenFormatVersion = 1;
+// The stereo-core right channel is the DI delayed and at -6 dB, so channel mix-ups can't cancel out.
+constexpr size_t kRightChannelDelaySamples = 113;
+constexpr float kRightChannelGain = 0.5f;
+
+struct GoldenOptions
+{
+  std::string goldenDir = NAM_GOLDEN_DIR;
+  std::string inputPath = NAM_GOLDEN_DEFAULT_INPUT; // --update only; afterwards read from golden.json.
+  double seconds = 4.0;
+  std::vector<std::string> presets; // --update only.
+  std::string filter;
+  std::string dumpDir;
+  double maxAbsError = 1.0e-4;
+  double minSnrDb = 90.0;
+  bool bitExact = false;
+  bool update = false;
+  bool requireReferences = false;
+};
+
+struct GoldenManifest
+{
+  std::string inputPath; // Relative to the golden directory.
+  double seconds = 4.0;
+  int blockSize = 64;
+  std::vector<std::string> presets; // Relative to the golden directory.
+  std::string referenceCommit; // Tree the references are rendered from (record-golden.sh); kept across --update.
+};
+
+struct Comparison
+{
+  double maxAbsError = 0.0;
+  double snrDb = std::numeric_limits<double>::infinity(); // Worst channel.
+  bool bitExact = true;
+  bool shapeMatches = true;
+};
+
+void PrintUsage()
+{
+  std::fprintf(stderr,
+               "Usage: nam-golden [--golden-dir dir] [--bit-exact] [--max-abs-error x] [--min-snr-db dB]\n"
+               "                  [--filter text] [--dump-dir dir] [--require-references]\n"
+               "                  [--update [--input di.wav] [--seconds s] [--preset file.nampreset ...]]\n");
+}
+
+bool ParseArgs(int argc, char* argv[], GoldenOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--bit-exact") == 0)
+    {
+      options.bitExact = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--update") == 0)
+    {
+      options.update = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--require-references") == 0)
+    {
+      options.requireReferences = true;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--golden-dir") == 0)
+      options.goldenDir = value;
+    else if (std::strcmp(arg, "--input") == 0)
+      options.inputPath = value;
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--preset") == 0)
+      options.presets.push_back(value);
+    else if (std::strcmp(arg, "--filter") == 0)
+      options.filter = value;
+    else if (std::strcmp(arg, "--dump-dir") == 0)
+      options.dumpDir = value;
+    else if (std::strcmp(arg, "--max-abs-error") == 0)
+      options.maxAbsError = std::atof(value);
+    else if (std::strcmp(arg, "--min-snr-db") == 0)
+      options.minSnrDb = std::atof(value);
+    else
+      return false;
+    ++i;
+  }
+  return options.seconds > 0.0 && options.maxAbsError >= 0.0;
+}
+
+std::filesystem::path ManifestPath(const GoldenOptions& options)
+{
+  return std::filesystem::path(options.goldenDir) / "golden.json";
+}
+
+// "stage/reverb/stereo" -> golden/stage-reverb-stereo.wav
+std::filesystem::path ReferencePath(const std::filesystem::path& dir, const std::string& entry)
+{
+  std::string fileName = entry;
+  std::replace(fileName.begin(), fileName.end(), '/', '-');
+  return dir / (fileName + ".wav");
+}
+
+std::filesystem::path ResolveRelative(const GoldenOptions& options, const std::string& path)
+{
+  const std::filesystem::path resolved(path);
+  return resolved.is_absolute() ? resolved : std::filesystem::absolute(options.goldenDir) / resolved;
+}
+
+bool ReadManifest(const GoldenOptions& options, GoldenManifest& manifest, std::string& errorMessage)
+{
+  std::ifstream file(ManifestPath(options));
+  if (!file.is_open())
+  {
+    errorMessage = "No references at " + ManifestPath(options).string() + " (record them with record-golden.sh)";
+    return false;
+  }
+  try
+  {
+    nlohmann::json json;
+    file >> json;
+    if (json.value("version", 0) != kGoldenFormatVersion)
+    {
+      errorMessage = "Unsupported golden format version in " + ManifestPath(options).string();
+      return false;
+    }
+    manifest.inputPath = json.value("input", std::string());
+    manifest.seconds = json.value("seconds", manifest.seconds);
+    manifest.blockSize = json.value("blockSize", manifest.blockSize);
+    manifest.presets = json.value("presets", std::vector<std::string>());
+    manifest.referenceCommit = json.value("referenceCommit", std::string());
+  }
+  catch (const std::exception& e)
+  {
+    errorMessage = "Malformed " + ManifestPath(options).string() + ": " + e.what();
+    return false;
+  }
+  return true;
+}
+
+bool WriteManifest(const GoldenOptions& options, const GoldenManifest& manifest, std::string& errorMessage)
+{
+  nlohmann::json json;
+  json["version"] = kGoldenFormatVersion;
+  json["input"] = manifest.inputPath;
+  json["seconds"] = manifest.seconds;
+  json["blockSize"] = manifest.blockSize;
+  json["presets"] = manifest.presets;
+  if (!manifest.referenceCommit.empty())
+    json["referenceCommit"] = manifest.referenceCommit;
+  std::ofstream file(ManifestPath(options), std::ios::trunc);
+  if (!file.is_open())
+  {
+    errorMessage = "Cannot write " + ManifestPath(options).string();
+    return false;
+  }
+  file << std::setw(2) << json << "\n";
+  return true;
+}
+
+bool EntrySelected(const GoldenOptions& options, const std::string& name)
+{
+  return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+// Fixed-size blocks over the whole source; stage state carries over between blocks as it does in ProcessBlock().
+headless::WavData RenderStage(const headless::StageDef& stage, const std::vector<std::vector<float>>& source,
+                              const double sampleRate, const int blockSize, const size_t numChannelsMonoCore)
+{
+  headless::NAMHeadlessHost host;
+  host.Prepare(sampleRate, headless::kMaxStageBlockSize, 2);
+  host.Settle(10.0);
+
+  headless::StageBuffers buffers;
+  headless::StageContext ctx;
+  ctx.plug = &host.GetPlug();
+  ctx.sampleRate = sampleRate;
+  ctx.numChannelsMonoCore = numChannelsMonoCore;
+  ctx.inputs = buffers.inputPointers.data();
+  ctx.outputs = buffers.outputPointers.data();
+  stage.setup(ctx);
+
+  const size_t numFrames = source.front().size();
+  headless::WavData render;
+  render.sampleRate = sampleRate;
+  // Both bus channels are kept: the FX-bus stages widen a mono core to stereo.
+  render.channels.assign(kNumChannelsInternal, std::vector<float>(numFrames, 0.0f));
+  for (size_t pos = 0; pos < numFrames; pos += static_cast<size_t>(blockSize))
+  {
+    ctx.numFrames = std::min(static_cast<size_t>(blockSize), numFrames - pos);
+    for (size_t c = 0; c < kNumChannelsInternal; ++c)
+      std::copy_n(source[std::min(c, source.size() - 1)].data() + pos, ctx.numFrames, buffers.input[c].data());
+    stage.process(ctx);
+    const auto& result = stage.inPlace ? buffers.input : buffers.output;
+    for (size_t c = 0; c < kNumChannelsInternal; ++c)
+      std::copy_n(result[c].data(), ctx.numFrames, render.channels[c].data() + pos);
+  }
+  return render;
+}
+
+bool RenderChain(const std::string& presetPath, const std::vector<float>& source, const double sampleRate,
+                 const int blockSize, headless::WavData& render)
+{
+  headless::NAMHeadlessHost host;
+  host.Prepare(sampleRate, blockSize, 1);
+  if (!presetPath.empty() && !host.LoadPreset(presetPath))
+  {
+    std::fprintf(stderr, "Failed to load preset %s\n", presetPath.c_str());
+    return false;
+  }
+  if (!host.Settle(30.0))
+    std::fprintf(stderr, "Warning: model/IR loads for %s did not settle; rendering anyway\n",
+                 presetPath.empty() ? "the default rig" : presetPath.c_str());
+
+  const size_t numFrames = source.size();
+  render.sampleRate = sampleRate;
+  render.channels.assign(static_cast<size_t>(host.GetNumOutputs()), std::vector<float>(numFrames, 0.0f));
+  for (size_t pos = 0; pos < numFrames; pos += static_cast<size_t>(blockSize))
+  {
+    const int nFrames = static_cast<int>(std::min(static_cast<size_t>(blockSize), numFrames - pos));
+    const float* inputs[1] = {source.data() + pos};
+    float* outputs[2] = {render.channels[0].data() + pos, render.channels[1].data() + pos};
+    host.ProcessBlock(inputs, outputs, nFrames);
+  }
+  return true;
+}
+
+Comparison Compare(const headless::WavData& reference, const headless::WavData& render)
+{
+  Comparison comparison;
+  if (reference.channels.size() != render.channels.size() || reference.GetNumFrames() != render.GetNumFrames())
+  {
+    comparison.shapeMatches = false;
+    comparison.bitExact = false;
+    return comparison;
+  }
+  for (size_t c = 0; c < reference.channels.size(); ++c)
+  {
+    const auto& expected = reference.channels[c];
+    const auto& actual = render.channels[c];
+    if (std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) != 0)
+      comparison.bitExact = false;
+    double signalEnergy = 0.0;
+    double errorEnergy = 0.0;
+    for (size_t s = 0; s < expected.size(); ++s)
+    {
+      const double error = static_cast<double>(actual[s]) - static_cast<double>(expected[s]);
+      comparison.maxAbsError = std::max(comparison.maxAbsError, std::fabs(error));
+      signalEnergy += static_cast<double>(expected[s]) * static_cast<double>(expected[s]);
+      errorEnergy += error * error;
+    }
+    if (errorEnergy > 0.0)
+    {
+      // A silent reference with any error at all is as bad as it gets.
+      const double snrDb = signalEnergy > 0.0 ? 10.0 * std::log10(signalEnergy / errorEnergy)
+                                              : -std::numeric_limits<double>::infinity();
+      comparison.snrDb = std::min(comparison.snrDb, snrDb);
+    }
+  }
+  return comparison;
+}
+
+// DI channel 0, trimmed to the recorded length, and the derived right channel for stereo-core stages.
+bool LoadSource(const std::filesystem::path& inputPath, const double seconds, std::vector<std::vector<float>>& source,
+                double& sampleRate)
+{
+  headless::WavData input;
+  std::string errorMessage;
+  if (!headless::ReadWav(inputPath.string(), input, errorMessage))
+  {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    return false;
+  }
+  sampleRate = input.sampleRate;
+  const size_t numFrames = std::min(input.GetNumFrames(), static_cast<size_t>(seconds * input.sampleRate));
+  std::vector<float> left(input.channels.front().begin(),
+                          input.channels.front().begin() + static_cast<std::ptrdiff_t>(numFrames));
+  std::vector<float> right(numFrames, 0.0f);
+  for (size_t s = kRightChannelDelaySamples; s < numFrames; ++s)
+    right[s] = kRightChannelGain * left[s - kRightChannelDelaySamples];
+  source = {std::move(left), std::move(right)};
+  return true;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  GoldenOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    PrintUsage();
+    return 2;
+  }
+
+  // Match the audio thread: ProcessBlock() runs with denormals flushed.
+  disable_denormals();
+
+  std::string errorMessage;
+  GoldenManifest manifest;
+  if (options.update)
+  {
+    GoldenManifest previous;
+    if (ReadManifest(options, previous, errorMessage))
+      manifest.referenceCommit = previous.referenceCommit;
+    std::filesystem::create_directories(options.goldenDir);
+    const auto goldenDir = std::filesystem::absolute(options.goldenDir);
+    manifest.inputPath =
+      std::filesystem::relative(std::filesystem::absolute(options.inputPath), goldenDir).generic_string();
+    manifest.seconds = options.seconds;
+    for (const auto& preset : options.presets)
+      manifest.presets.push_back(
+        std::filesystem::relative(std::filesystem::absolute(preset), goldenDir).generic_string());
+  }
+  else if (!ReadManifest(options, manifest, errorMessage))
+  {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    return 2;
+  }
+
+  std::vector<std::vector<float>> source;
+  double sampleRate = 48000.0;
+  if (!LoadSource(ResolveRelative(options, manifest.inputPath), manifest.seconds, source, sampleRate))
+    return 2;
+
+  std::vector<std::string> entries;
+  std::vector<headless::WavData> renders;
+  for (const auto& stage : headless::MakeStages())
+  {
+    for (const size_t core : {size_t(1), size_t(2)})
+    {
+      const std::string name = std::string("stage/") + stage.name + (core == 1 ? "/mono" : "/stereo");
+      if (!EntrySelected(options, name))
+        continue;
+      entries.push_back(name);
+      renders.push_back(RenderStage(stage, source, sampleRate, manifest.blockSize, core));
+    }
+  }
+  // Whole chain: a fresh instance per preset so no state leaks between rigs.
+  std::vector<std::pair<std::string, std::string>> chains = {{"chain/defaults", ""}};
+  for (const auto& preset : manifest.presets)
+    chains.emplace_back("chain/" + std::filesystem::path(preset).stem().string(), preset);
+  for (const auto& [name, preset] : chains)
+  {
+    if (!EntrySelected(options, name))
+      continue;
+    headless::WavData render;
+    if (!RenderChain(preset.empty() ? preset : ResolveRelative(options, preset).string(), source.front(), sampleRate,
+                     manifest.blockSize, render))
+      return 2;
+    entries.push_back(name);
+    renders.push_back(std::move(render));
+  }
+
+  if (options.update)
+  {
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      if (!headless::WriteWavFloat32(ReferencePath(options.goldenDir, entries[i]).string(), renders[i], errorMessage))
+      {
+        std::fprintf(stderr, "%s\n", errorMessage.c_str());
+        return 2;
+      }
+    }
+    if (!WriteManifest(options, manifest, errorMessage))
+    {
+      std::fprintf(stderr, "%s\n", errorMessage.c_str());
+      return 2;
+    }
+    std::printf("Recorded %zu reference render(s) in %s\n", entries.size(), options.goldenDir.c_str());
+    return 0;
+  }
+
+  if (!options.dumpDir.empty())
+    std::filesystem::create_directories(options.dumpDir);
+  std::printf("%-36s %12s %10s  %s\n", "entry", "max abs err", "SNR dB", "status");
+  int numMismatches = 0;
+  int numMissing = 0;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    headless::WavData reference;
+    if (!headless::ReadWav(ReferencePath(options.goldenDir, entries[i]).string(), reference, errorMessage))
+    {
+      std::printf("%-36s %12s %10s  skipped (no reference)\n", entries[i].c_str(), "-", "-");
+      ++numMissing;
+      continue;
+    }
+    const Comparison comparison = Compare(reference, renders[i]);
+    bool pass = comparison.shapeMatches;
+    if (pass)
+      pass = options.bitExact ? comparison.bitExact
+                              : (comparison.maxAbsError <= options.maxAbsError && comparison.snrDb >= options.minSnrDb);
+    const char* status = !comparison.shapeMatches ? "LENGTH/CHANNELS DIFFER"
+                         : pass                   ? (comparison.bitExact ? "bit-exact" : "within tolerance")
+                                                  : "MISMATCH";
+    char snrText[32];
+    if (std::isinf(comparison.snrDb) && comparison.snrDb > 0.0)
+      std::snprintf(snrText, sizeof(snrText), "inf");
+    else
+      std::snprintf(snrText, sizeof(snrText), "%.1f", comparison.snrDb);
+    std::printf("%-36s %12.3g %10s  %s\n", entries[i].c_str(), comparison.maxAbsError, snrText, status);
+    if (!pass)
+    {
+      ++numMismatches;
+      if (!options.dumpDir.empty())
+        headless::WriteWavFloat32(ReferencePath(options.dumpDir, entries[i]).string(), renders[i], errorMessage);
+    }
+  }
+
+  if (numMismatches > 0)
+    std::printf("%d of %zu entries differ from the references\n", numMismatches, entries.size());
+  if (numMissing > 0)
+    std::printf("SKIPPED: %d of %zu entries have no reference and were not compared; record them with "
+                "record-golden.sh\n",
+                numMissing, entries.size());
+  if (numMismatches > 0)
+    return 1;
+  return (numMissing > 0 && options.requireReferences) ? 3 : 0;
+}
@@ -0,0 +1,414 @@
+// nam-jitter: replays a realistic host schedule through the plug-in and reports deadline misses and tail latency.
+//
+// An audio thread issues callbacks with a variable nFrames (paced to real time by default) while a main thread runs
+// OnIdle() at UI-timer rate and injects amp slot, model variant and cab IR switches at random (Poisson) times.
+// Sample-rate changes are applied between callbacks through Prepare()/OnReset(), as a host does after stopping
+// the stream. Callbacks within --event-window-ms of an injected event are summarized separately, which is where
+// _ApplyDSPStaging() commits and crossfades show up.
+//
+//   nam-jitter --preset rig.nampreset [--input di.wav] [--seconds 30] [--block-size 128]
+//              [--schedule fixed|variable|split] [--sample-rates 48000,44100,96000] [--sr-changes 2]
+//              [--events-per-second 2] [--deadline-fraction 1.0] [--no-pace] [--seed 1]
+//              [--slimmable-size 0.4] [--slimmable-governor] [--slimmable-events] [--pipelined-model]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HeadlessSignal.h"
+#include "HeadlessStats.h"
+#include "HeadlessWav.h"
+#include "NAMHeadlessHost.h"
+#include "NAMHeadlessProbe.h"
+#include "RTSanitizer.h"
+
+namespace
+{
+enum class Schedule
+{
+  Fixed,
+  Variable,
+  Split
+};
+
+enum class EventKind : int
+{
+  AmpSlot = 0,
+  ModelVariant,
+  CabIR,
+  SlimmableSize, // Only with --slimmable-events.
+  Count
+};
+
+constexpr const char* kEventKindNames[] = {"amp slot", "model variant", "cab IR", "slimmable size"};
+// Typical editor timer period; the main thread idles this often.
+constexpr auto kIdlePeriod = std::chrono::milliseconds(20);
+
+struct JitterOptions
+{
+  std::string presetPath;
+  std::string inputPath;
+  double seconds = 30.0;
+  int blockSize = 128;
+  Schedule schedule = Schedule::Variable;
+  std::vector<double> sampleRates = {48000.0, 44100.0, 96000.0};
+  int sampleRateChanges = 2;
+  double eventsPerSecond = 2.0;
+  double eventWindowMs = 250.0;
+  double deadlineFraction = 1.0;
+  bool pace = true;
+  unsigned int seed = 1;
+  int numInputs = 1;
+  // < 0: keep the plug-in default (NAMConfig::SlimmableSize).
+  double slimmableSize = -1.0;
+  bool slimmableGovernor = false;
+  bool slimmableEvents = false;
+  bool pipelinedModel = false;
+};
+
+struct CallbackRecord
+{
+  double micros = 0.0;
+  double budgetMicros = 0.0;
+  bool nearEvent = false;
+};
+
+bool ParseArgs(int argc, char* argv[], JitterOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--no-pace") == 0)
+    {
+      options.pace = false;
+      continue;
+    }
+    if (std::strcmp(arg, "--slimmable-governor") == 0)
+    {
+      options.slimmableGovernor = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--slimmable-events") == 0)
+    {
+      options.slimmableEvents = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--pipelined-model") == 0)
+    {
+      options.pipelinedModel = true;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--preset") == 0)
+      options.presetPath = value;
+    else if (std::strcmp(arg, "--input") == 0)
+      options.inputPath = value;
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--block-size") == 0)
+      options.blockSize = std::atoi(value);
+    else if (std::strcmp(arg, "--schedule") == 0)
+    {
+      if (std::strcmp(value, "fixed") == 0)
+        options.schedule = Schedule::Fixed;
+      else if (std::strcmp(value, "variable") == 0)
+        options.schedule = Schedule::Variable;
+      else if (std::strcmp(value, "split") == 0)
+        options.schedule = Schedule::Split;
+      else
+        return false;
+    }
+    else if (std::strcmp(arg, "--sample-rates") == 0)
+    {
+      options.sampleRates.clear();
+      std::stringstream stream(value);
+      std::string item;
+      while (std::getline(stream, item, ','))
+        if (!item.empty())
+          options.sampleRates.push_back(std::atof(item.c_str()));
+    }
+    else if (std::strcmp(arg, "--sr-changes") == 0)
+      options.sampleRateChanges = std::atoi(value);
+    else if (std::strcmp(arg, "--events-per-second") == 0)
+      options.eventsPerSecond = std::atof(value);
+    else if (std::strcmp(arg, "--event-window-ms") == 0)
+      options.eventWindowMs = std::atof(value);
+    else if (std::strcmp(arg, "--deadline-fraction") == 0)
+      options.deadlineFraction = std::atof(value);
+    else if (std::strcmp(arg, "--seed") == 0)
+      options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+    else if (std::strcmp(arg, "--channels") == 0)
+      options.numInputs = std::clamp(std::atoi(value), 1, 2);
+    else if (std::strcmp(arg, "--slimmable-size") == 0)
+      options.slimmableSize = std::clamp(std::atof(value), 0.0, 1.0);
+    else
+      return false;
+    ++i;
+  }
+  return !options.presetPath.empty() && options.seconds > 0.0 && options.blockSize > 0 && !options.sampleRates.empty()
+         && options.deadlineFraction > 0.0;
+}
+
+// nFrames for the next callback. "variable" mimics hosts that hand over whatever the device delivered;
+// "split" mimics hosts that cut blocks at automation points.
+std::vector<int> NextCallbackSizes(const Schedule schedule, const int blockSize, std::mt19937& rng)
+{
+  switch (schedule)
+  {
+    case Schedule::Fixed: return {blockSize};
+    case Schedule::Variable:
+    {
+      std::uniform_int_distribution<int> frames(std::max(1, blockSize / 4), blockSize);
+      return {frames(rng)};
+    }
+    case Schedule::Split:
+    {
+      std::uniform_real_distribution<double> chance(0.0, 1.0);
+      if (blockSize < 2 || chance(rng) >= 0.2)
+        return {blockSize};
+      std::uniform_int_distribution<int> splitAt(1, blockSize - 1);
+      const int first = splitAt(rng);
+      return {first, blockSize - first};
+    }
+  }
+  return {blockSize};
+}
+
+void PrintSummary(const char* label, const std::vector<CallbackRecord>& records, const bool nearEvent,
+                  const double deadlineFraction)
+{
+  std::vector<double> micros;
+  std::vector<double> loads;
+  size_t misses = 0;
+  for (const auto& record : records)
+  {
+    if (record.nearEvent != nearEvent)
+      continue;
+    micros.push_back(record.micros);
+    loads.push_back(record.micros / record.budgetMicros);
+    if (record.micros > record.budgetMicros * deadlineFraction)
+      ++misses;
+  }
+  const headless::TimingSummary timing = headless::SummarizeTimings(micros);
+  const headless::TimingSummary load = headless::SummarizeTimings(loads);
+  std::printf("%-12s callbacks %8zu  misses %6zu  p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  max %9.1f us"
+              "  max load %6.1f%%\n",
+              label, timing.count, misses, timing.p50, timing.p99, timing.p999, timing.max, load.max * 100.0);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  JitterOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    std::fprintf(stderr,
+                 "Usage: nam-jitter --preset <file.nampreset> [--input di.wav] [--seconds 30] [--block-size 128]\n"
+                 "                  [--schedule fixed|variable|split] [--sample-rates 48000,44100,96000]\n"
+                 "                  [--sr-changes 2] [--events-per-second 2] [--event-window-ms 250]\n"
+                 "                  [--deadline-fraction 1.0] [--channels 1|2] [--no-pace] [--seed 1]\n"
+                 "                  [--slimmable-size 0.4] [--slimmable-governor] [--slimmable-events]\n"
+                 "                  [--pipelined-model]\n");
+    return 2;
+  }
+
+  std::vector<float> source;
+  if (!options.inputPath.empty())
+  {
+    headless::WavData wav;
+    std::string errorMessage;
+    if (!headless::ReadWav(options.inputPath, wav, errorMessage))
+    {
+      std::fprintf(stderr, "%s\n", errorMessage.c_str());
+      return 1;
+    }
+    // Played back as-is at every sample rate; pitch is irrelevant for timing.
+    source = wav.channels.front();
+  }
+  if (source.empty())
+    source = headless::MakePluckTestSignal(options.sampleRates.front(), 4.0);
+
+  headless::NAMHeadlessHost host;
+  // Read by OnReset(), so it has to be set before Prepare().
+  host.GetPlug().SetPipelinedModelEnabled(options.pipelinedModel);
+  host.Prepare(options.sampleRates.front(), options.blockSize, options.numInputs);
+  if (!host.LoadPreset(options.presetPath))
+  {
+    std::fprintf(stderr, "Failed to load preset %s\n", options.presetPath.c_str());
+    return 1;
+  }
+  if (!host.Settle(30.0))
+    std::fprintf(stderr, "Warning: preset loads did not settle\n");
+
+  NeuralAmpModeler& plug = host.GetPlug();
+  if (options.slimmableSize >= 0.0)
+    plug.SetSlimmableSize(options.slimmableSize);
+  plug.SetSlimmableGovernorEnabled(options.slimmableGovernor);
+  // Serializes main-thread work against the (rare) stream restarts for sample-rate changes.
+  std::mutex hostMutex;
+  std::atomic<bool> audioDone{false};
+  std::atomic<double> lastEventAudioSeconds{-1.0e9};
+  std::atomic<double> audioSecondsRendered{0.0};
+  const int numEventKinds = static_cast<int>(options.slimmableEvents ? EventKind::Count : EventKind::SlimmableSize);
+  std::vector<size_t> eventCounts(static_cast<size_t>(numEventKinds), 0);
+
+  std::thread mainThread([&]() {
+    std::mt19937 rng(options.seed * 7919u + 17u);
+    std::exponential_distribution<double> nextEventGap(std::max(1.0e-6, options.eventsPerSecond));
+    std::uniform_int_distribution<int> eventKind(0, numEventKinds - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const int numSlots = NAMHeadlessProbe::GetAmpSlotCount(plug);
+    const int numVariants = NAMHeadlessProbe::GetAmpModelVariantCount();
+    auto nextEventTime = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                               std::chrono::duration<double>(nextEventGap(rng)));
+    while (!audioDone.load(std::memory_order_acquire))
+    {
+      {
+        std::lock_guard<std::mutex> lock(hostMutex);
+        if (options.eventsPerSecond > 0.0 && std::chrono::steady_clock::now() >= nextEventTime)
+        {
+          const auto kind = static_cast<EventKind>(eventKind(rng));
+          switch (kind)
+          {
+            case EventKind::AmpSlot:
+              NAMHeadlessProbe::SelectAmpSlot(plug, static_cast<int>(unit(rng) * numSlots) % numSlots);
+              break;
+            case EventKind::ModelVariant:
+            {
+              const int slotIndex = static_cast<int>(unit(rng) * numSlots) % numSlots;
+              NAMHeadlessProbe::SelectAmpSlotModelVariant(
+                plug, slotIndex, static_cast<int>(unit(rng) * numVariants) % numVariants);
+              break;
+            }
+            case EventKind::CabIR:
+            {
+              const bool cabB = unit(rng) < 0.5;
+              const int paramIdx = (unit(rng) < 0.5) ? (cabB ? kCabBSource : kCabASource)
+                                                     : (cabB ? kCabBPosition : kCabAPosition);
+              plug.SetParameterFromHost(paramIdx, unit(rng));
+              NAMHeadlessProbe::ApplyCabSlotSource(plug, cabB ? 1 : 0);
+              break;
+            }
+            case EventKind::SlimmableSize:
+              // The next OnIdle() has the loader rebuild the running amp model at this size and it swaps in like a
+              // reload, so size changes exercise the model handoff under load.
+              plug.SetSlimmableSize(std::round(unit(rng) * 4.0) / 4.0);
+              break;
+            case EventKind::Count: break;
+          }
+          ++eventCounts[static_cast<size_t>(kind)];
+          lastEventAudioSeconds.store(audioSecondsRendered.load(std::memory_order_relaxed), std::memory_order_relaxed);
+          nextEventTime = std::chrono::steady_clock::now()
+                          + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::duration<double>(nextEventGap(rng)));
+        }
+        host.Idle();
+      }
+      std::this_thread::sleep_for(kIdlePeriod);
+    }
+  });
+
+  std::mt19937 rng(options.seed);
+  std::vector<CallbackRecord> records;
+  records.reserve(static_cast<size_t>(options.seconds * options.sampleRates.front() / (options.blockSize / 4.0)) + 16);
+  std::vector<float> outputLeft(static_cast<size_t>(options.blockSize));
+  std::vector<float> outputRight(static_cast<size_t>(options.blockSize));
+  float* outputs[2] = {outputLeft.data(), outputRight.data()};
+  std::vector<double> resetMicros;
+
+  // Sample-rate changes are spread evenly over the run, cycling through --sample-rates.
+  const int numSegments = std::max(1, options.sampleRateChanges + 1);
+  const double segmentSeconds = options.seconds / static_cast<double>(numSegments);
+  size_t sourcePos = 0;
+  double renderedSeconds = 0.0;
+  for (int segment = 0; segment < numSegments; ++segment)
+  {
+    const double sampleRate = options.sampleRates[static_cast<size_t>(segment) % options.sampleRates.size()];
+    if (segment > 0)
+    {
+      std::lock_guard<std::mutex> lock(hostMutex);
+      const auto resetStart = std::chrono::steady_clock::now();
+      host.Prepare(sampleRate, options.blockSize, options.numInputs);
+      resetMicros.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - resetStart).count());
+    }
+
+    const auto segmentStart = std::chrono::steady_clock::now();
+    double segmentRendered = 0.0;
+    while (segmentRendered < segmentSeconds)
+    {
+      for (const int nFrames : NextCallbackSizes(options.schedule, options.blockSize, rng))
+      {
+        if (sourcePos + static_cast<size_t>(nFrames) > source.size())
+          sourcePos = 0;
+        const float* inputs[2] = {source.data() + sourcePos, source.data() + sourcePos};
+        sourcePos += static_cast<size_t>(nFrames);
+
+        const auto callbackStart = std::chrono::steady_clock::now();
+        host.ProcessBlock(inputs, outputs, nFrames);
+        const auto callbackEnd = std::chrono::steady_clock::now();
+
+        CallbackRecord record;
+        record.micros = std::chrono::duration<double, std::micro>(callbackEnd - callbackStart).count();
+        record.budgetMicros = 1.0e6 * static_cast<double>(nFrames) / sampleRate;
+        record.nearEvent = (renderedSeconds - lastEventAudioSeconds.load(std::memory_order_relaxed))
+                           <= options.eventWindowMs * 1.0e-3;
+        records.push_back(record);
+
+        const double callbackSeconds = static_cast<double>(nFrames) / sampleRate;
+        segmentRendered += callbackSeconds;
+        renderedSeconds += callbackSeconds;
+        audioSecondsRendered.store(renderedSeconds, std::memory_order_relaxed);
+        if (options.pace)
+          std::this_thread::sleep_until(segmentStart + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                         std::chrono::duration<double>(segmentRendered)));
+      }
+    }
+  }
+  audioDone.store(true, std::memory_order_release);
+  mainThread.join();
+
+  std::printf("schedule       %s, block %d, %.1f s audio, %d sample-rate change(s)%s\n",
+              options.schedule == Schedule::Fixed      ? "fixed"
+              : options.schedule == Schedule::Variable ? "variable"
+                                                       : "split",
+              options.blockSize, renderedSeconds, numSegments - 1, options.pace ? "" : " (unpaced)");
+  std::printf("events         ");
+  for (size_t kind = 0; kind < eventCounts.size(); ++kind)
+    std::printf("%s%zu %s", kind > 0 ? ", " : "", eventCounts[kind], kEventKindNames[kind]);
+  std::printf("\n");
+  if (!resetMicros.empty())
+  {
+    const headless::TimingSummary reset = headless::SummarizeTimings(resetMicros);
+    std::printf("OnReset        mean %.1f us, max %.1f us (outside the callback budget)\n", reset.mean, reset.max);
+  }
+  std::printf("deadline       %.0f%% of nFrames / sample rate\n", options.deadlineFraction * 100.0);
+  std::printf("slimmable      size %.2f at the end%s\n", plug.GetSlimmableSize(),
+              options.slimmableGovernor ? " (governor on)" : "");
+  if (options.pipelinedModel)
+    std::printf("model stage    pipelined, %d sample(s) reported latency\n", plug.GetLatency());
+  PrintSummary("quiet", records, false, options.deadlineFraction);
+  PrintSummary("near event", records, true, options.deadlineFraction);
+#if NAM_RT_SANITIZER
+  std::printf("RT violations  %llu (reports on stderr)\n",
+              static_cast<unsigned long long>(NAMRTSanitizer::GetViolationCount()));
+#endif
+
+  size_t totalMisses = 0;
+  for (const auto& record : records)
+    if (record.micros > record.budgetMicros * options.deadlineFraction)
+      ++totalMisses;
+  return totalMisses > 0 ? 3 : 0;
+}
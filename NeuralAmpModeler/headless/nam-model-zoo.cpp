@@ -0,0 +1,440 @@
+// nam-model-zoo: load and throughput benchmark for every model the plug-in can ship or be pointed at.
+//
+// By default it covers the legacy config.json + weights.npy directories under Models/, REAPER/model.nam and the
+// embedded amp/stomp assets (SlimmableContainer and WaveNet). Each model is loaded the way the plug-in's loader does
+// (parse, nam::get_dsp(), slimmable size, ResamplingNAM wrap + Reset()) once per slimmable size and sample rate, then
+// streamed through ResamplingNAM::process() in fixed blocks. Models that aren't slimmable get a single size row.
+//
+//   nam-model-zoo [--models a.nam,Models/dir] [--no-embedded] [--slim-sizes 0,0.25,0.5,0.75,1]
+//                 [--sample-rates 48000,96000] [--block-size 64] [--seconds 5] [--csv]
+//                 [--precisions fp32,fp16,bf16,int8] [--esr-input "REAPER/Guitar DI.wav"]
+//
+// --precisions adds a row per weight storage precision (WeightPrecision.h): the weights are rounded to what that
+// storage holds before get_dsp(), and the fp32 kernels run as usual, so this measures accuracy, not speed. Those rows
+// also render the ESR input and report the error-to-signal ratio against the fp32 row of the same model, size and rate.
+// int8 needs the layer layout for its per-channel scales; models without one get no int8 row.
+//
+// "load" is JSON/.npy read + parse + get_dsp(); "prewarm" is the ResamplingNAM wrap and Reset() at the session rate;
+// "rtf" is processing time / audio time (below 1 keeps up; the plug-in runs two of these in stereo core). "heap" is
+// the net heap growth across load + prewarm (MemoryAccounting.h); "rss" the resident set growth, which stays at 0
+// when the allocator reuses memory freed by the previous row. "weights" is the weight storage at the row's precision.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "architecture.hpp"
+#include "json.hpp"
+#include "NAM/get_dsp.h"
+#include "NAM/slimmable.h"
+#include "EmbeddedModelAssets.h"
+#include "EmbeddedModelConfig.h"
+#include "HeadlessSignal.h"
+#include "HeadlessWav.h"
+#include "MemoryAccounting.h"
+#include "NpyWeights.h"
+#include "NeuralAmpModeler.h"
+#include "WeightPrecision.h"
+
+#ifndef NAM_MODEL_ZOO_ROOT
+  #define NAM_MODEL_ZOO_ROOT "."
+#endif
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct ZooOptions
+{
+  std::vector<std::string> modelPaths; // Empty: Models/*, REAPER/model.nam under NAM_MODEL_ZOO_ROOT.
+  bool embedded = true;
+  std::vector<double> slimSizes = {0.0, 0.25, 0.5, 0.75, 1.0};
+  std::vector<double> sampleRates = {48000.0, 96000.0};
+  int blockSize = 64;
+  double seconds = 5.0;
+  bool csv = false;
+  // fp32 always comes first: it is the ESR reference for the other precisions.
+  std::vector<headless::WeightPrecision> precisions = {headless::WeightPrecision::Float32};
+  std::string esrInput = std::string(NAM_MODEL_ZOO_ROOT) + "/REAPER/Guitar DI.wav";
+};
+
+// Where a model's JSON comes from; the JSON itself is re-read for every row so each load is measured cold.
+struct ZooModel
+{
+  std::string name;
+  std::filesystem::path path; // .nam file or legacy directory
+  const embedded_model::EmbeddedModelAsset* asset = nullptr;
+};
+
+struct ZooRow
+{
+  std::string architecture;
+  bool slimmable = false;
+  double loadMs = 0.0;
+  double prewarmMs = 0.0;
+  double realTimeFactor = 0.0;
+  headless::WeightStorage weights;
+  size_t heapBytes = 0;
+  size_t rssBytes = 0;
+};
+
+template <typename T, typename Parse>
+std::vector<T> ParseList(const char* text, Parse parse)
+{
+  std::vector<T> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    if (!item.empty())
+      values.push_back(parse(item));
+  return values;
+}
+
+bool ParseArgs(int argc, char* argv[], ZooOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--csv") == 0)
+    {
+      options.csv = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--no-embedded") == 0)
+    {
+      options.embedded = false;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--models") == 0)
+      options.modelPaths = ParseList<std::string>(value, [](const std::string& s) { return s; });
+    else if (std::strcmp(arg, "--slim-sizes") == 0)
+      options.slimSizes = ParseList<double>(value, [](const std::string& s) { return std::atof(s.c_str()); });
+    else if (std::strcmp(arg, "--sample-rates") == 0)
+      options.sampleRates = ParseList<double>(value, [](const std::string& s) { return std::atof(s.c_str()); });
+    else if (std::strcmp(arg, "--block-size") == 0)
+      options.blockSize = std::atoi(value);
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--esr-input") == 0)
+      options.esrInput = value;
+    else if (std::strcmp(arg, "--precisions") == 0)
+    {
+      options.precisions = {headless::WeightPrecision::Float32};
+      for (const auto& name : ParseList<std::string>(value, [](const std::string& s) { return s; }))
+      {
+        headless::WeightPrecision precision;
+        if (!headless::ParseWeightPrecision(name, precision))
+          return false;
+        if (std::find(options.precisions.begin(), options.precisions.end(), precision) == options.precisions.end())
+          options.precisions.push_back(precision);
+      }
+    }
+    else
+      return false;
+    ++i;
+  }
+  for (const double slimSize : options.slimSizes)
+    if (slimSize < 0.0 || slimSize > 1.0)
+      return false;
+  return !options.slimSizes.empty() && !options.sampleRates.empty() && options.blockSize > 0
+         && options.seconds > 0.0;
+}
+
+std::vector<ZooModel> CollectModels(const ZooOptions& options)
+{
+  std::vector<ZooModel> models;
+  std::vector<std::filesystem::path> paths;
+  if (options.modelPaths.empty())
+  {
+    const std::filesystem::path root(NAM_MODEL_ZOO_ROOT);
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(root / "Models", error))
+      if (entry.is_directory())
+        paths.push_back(entry.path());
+    std::sort(paths.begin(), paths.end());
+    paths.push_back(root / "REAPER" / "model.nam");
+  }
+  else
+  {
+    for (const auto& path : options.modelPaths)
+      paths.emplace_back(path);
+  }
+  for (const auto& path : paths)
+  {
+    const std::string name = path.filename().string();
+    models.push_back({std::filesystem::is_directory(path) ? name + "/" : name, path, nullptr});
+  }
+
+  if (options.embedded)
+  {
+    for (const char* token : {"Amp1A", "Amp1B", "Amp2A", "Amp2B", "Amp3A", "Amp3B"})
+      if (const auto* asset = embedded_model::GetAmpModelAsset(token))
+        models.push_back({std::string("embedded:") + token, {}, asset});
+    for (const char* token : {"BoostA", "BoostB"})
+      if (const auto* asset = embedded_model::GetStompModelAsset(token))
+        models.push_back({std::string("embedded:") + token, {}, asset});
+  }
+  return models;
+}
+
+std::string ReadTextFile(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("Can't open " + path.string());
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+std::vector<float> ReadNpyWeights(const std::filesystem::path& path)
+{
+  const std::string contents = ReadTextFile(path);
+  const npy::WeightsView view = npy::ParseWeights(contents.data(), contents.size(), path.string());
+  std::vector<float> weights(view.count);
+  for (size_t i = 0; i < view.count; ++i)
+    weights[i] = view[i];
+  return weights;
+}
+
+nlohmann::json LoadModelConfig(const ZooModel& model)
+{
+  if (model.asset != nullptr)
+  {
+    // Same as the plug-in loader: the embedded config has its weight arrays stored separately as floats.
+    nlohmann::json config = nlohmann::json::parse(model.asset->json, model.asset->json + model.asset->jsonSize);
+    embedded_model::InsertWeightArrays(*model.asset, config);
+    return config;
+  }
+  if (!std::filesystem::is_directory(model.path))
+    return nlohmann::json::parse(ReadTextFile(model.path));
+
+  // Legacy export: the same architecture/config as a .nam file, with the weights in a separate .npy. Like the plug-in
+  // loader, the config keeps its own version, so exports older than get_dsp() accepts show up as load failures.
+  nlohmann::json config = nlohmann::json::parse(ReadTextFile(model.path / "config.json"));
+  config["weights"] = ReadNpyWeights(model.path / "weights.npy");
+  return config;
+}
+
+size_t GetResidentBytes()
+{
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  if (!(statm >> totalPages >> residentPages))
+    return 0;
+  return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+double MillisecondsSince(const Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Loads a fresh instance at the given slimmable size, weight precision and rate and streams the source through it.
+// With esrSource, then renders it from a fresh state into esrOutput. Returns false, without running, if the weights
+// can't be stored at that precision. Throws on load errors.
+bool RunModel(const ZooModel& model, const double slimSize, const headless::WeightPrecision precision,
+              const double sampleRate, const ZooOptions& options, const std::vector<NAM_SAMPLE>& source,
+              const std::vector<NAM_SAMPLE>* esrSource, std::vector<NAM_SAMPLE>* esrOutput, ZooRow& row)
+{
+  const size_t heapBefore = GetHeapBytesInUse();
+  const size_t rssBefore = GetResidentBytes();
+
+  const auto loadStart = Clock::now();
+  double roundingMs = 0.0;
+  std::unique_ptr<nam::DSP> dsp;
+  {
+    nlohmann::json config = LoadModelConfig(model);
+    row.architecture = config.value("architecture", std::string("?"));
+    // Emulation only, so not part of the load time.
+    const auto roundingStart = Clock::now();
+    if (!headless::RoundModelConfigWeights(config, precision, row.weights))
+      return false;
+    roundingMs = MillisecondsSince(roundingStart);
+    dsp = nam::get_dsp(config);
+  }
+  auto* slimmable = dynamic_cast<nam::SlimmableModel*>(dsp.get());
+  row.slimmable = (slimmable != nullptr);
+  if (slimmable != nullptr)
+    slimmable->SetSlimmableSize(slimSize);
+  row.loadMs = MillisecondsSince(loadStart) - roundingMs;
+  if (dsp->NumInputChannels() != 1 || dsp->NumOutputChannels() != 1)
+    throw std::runtime_error("Model must be mono in, mono out");
+
+  const auto prewarmStart = Clock::now();
+  auto resampled = std::make_unique<ResamplingNAM>(std::move(dsp), sampleRate, options.blockSize);
+  row.prewarmMs = MillisecondsSince(prewarmStart);
+
+  const size_t heapAfter = GetHeapBytesInUse();
+  const size_t rssAfter = GetResidentBytes();
+  row.heapBytes = heapAfter > heapBefore ? heapAfter - heapBefore : 0;
+  row.rssBytes = rssAfter > rssBefore ? rssAfter - rssBefore : 0;
+
+  const size_t blockSize = static_cast<size_t>(options.blockSize);
+  std::vector<NAM_SAMPLE> input(blockSize);
+  std::vector<NAM_SAMPLE> output(blockSize);
+  NAM_SAMPLE* inputPointers[1] = {input.data()};
+  NAM_SAMPLE* outputPointers[1] = {output.data()};
+  double processSeconds = 0.0;
+  for (size_t pos = 0; pos + blockSize <= source.size(); pos += blockSize)
+  {
+    std::copy(source.begin() + static_cast<std::ptrdiff_t>(pos),
+              source.begin() + static_cast<std::ptrdiff_t>(pos + blockSize), input.begin());
+    const auto blockStart = Clock::now();
+    resampled->process(inputPointers, outputPointers, options.blockSize);
+    processSeconds += std::chrono::duration<double>(Clock::now() - blockStart).count();
+  }
+  const double audioSeconds = static_cast<double>(source.size() - source.size() % blockSize) / sampleRate;
+  row.realTimeFactor = audioSeconds > 0.0 ? processSeconds / audioSeconds : 0.0;
+
+  if (esrSource == nullptr)
+    return true;
+  resampled->Reset(sampleRate, options.blockSize);
+  esrOutput->assign(esrSource->size(), 0.0);
+  for (size_t pos = 0; pos < esrSource->size(); pos += blockSize)
+  {
+    const size_t frames = std::min(blockSize, esrSource->size() - pos);
+    std::copy_n(esrSource->begin() + static_cast<std::ptrdiff_t>(pos), frames, input.begin());
+    resampled->process(inputPointers, outputPointers, static_cast<int>(frames));
+    std::copy_n(output.begin(), frames, esrOutput->begin() + static_cast<std::ptrdiff_t>(pos));
+  }
+  return true;
+}
+
+// Error-to-signal ratio of output against reference; 0 is identical.
+double ComputeESR(const std::vector<NAM_SAMPLE>& output, const std::vector<NAM_SAMPLE>& reference)
+{
+  double error = 0.0;
+  double energy = 0.0;
+  for (size_t s = 0; s < std::min(output.size(), reference.size()); ++s)
+  {
+    const double difference = static_cast<double>(output[s]) - static_cast<double>(reference[s]);
+    error += difference * difference;
+    energy += static_cast<double>(reference[s]) * static_cast<double>(reference[s]);
+  }
+  return energy > 0.0 ? error / energy : 0.0;
+}
+
+double ToMegabytes(const size_t bytes)
+{
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  ZooOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    std::fprintf(stderr,
+                 "Usage: nam-model-zoo [--models a.nam,dir,...] [--no-embedded] [--slim-sizes 0,0.25,...,1]\n"
+                 "                     [--sample-rates 48000,96000] [--block-size 64] [--seconds 5] [--csv]\n"
+                 "                     [--precisions fp32,fp16,bf16,int8] [--esr-input di.wav]\n");
+    return 2;
+  }
+
+  // Only needed to compare reduced precisions with fp32. The DI's samples are fed at each row's rate.
+  std::vector<NAM_SAMPLE> esrSource;
+  if (options.precisions.size() > 1)
+  {
+    headless::WavData wav;
+    std::string errorMessage;
+    if (!headless::ReadWav(options.esrInput, wav, errorMessage) || wav.channels.empty())
+    {
+      std::fprintf(stderr, "Can't read ESR input %s: %s\n", options.esrInput.c_str(), errorMessage.c_str());
+      return 2;
+    }
+    esrSource.assign(wav.channels.front().begin(), wav.channels.front().end());
+  }
+
+  // Match the audio thread: ProcessBlock() runs with denormals flushed.
+  disable_denormals();
+
+  const std::vector<ZooModel> models = CollectModels(options);
+  if (options.csv)
+    std::printf("model,architecture,slim_size,precision,sample_rate,load_ms,prewarm_ms,rtf,weights_mib,heap_mib,"
+                "rss_mib,esr\n");
+  else
+    std::printf("%-26s %-18s %5s %5s %7s %9s %10s %8s %11s %9s %8s %10s\n", "model", "architecture", "slim", "prec",
+                "rate", "load ms", "prewarm ms", "rtf", "weights MiB", "heap MiB", "rss MiB", "esr");
+
+  bool anyFailed = false;
+  for (const double sampleRate : options.sampleRates)
+  {
+    const std::vector<float> signal = headless::MakePluckTestSignal(sampleRate, options.seconds);
+    const std::vector<NAM_SAMPLE> source(signal.begin(), signal.end());
+    for (const auto& model : models)
+    {
+      bool modelFailed = false;
+      for (const double slimSize : options.slimSizes)
+      {
+        bool slimmable = false;
+        std::vector<NAM_SAMPLE> referenceOutput;
+        std::vector<NAM_SAMPLE> esrOutput;
+        for (const auto precision : options.precisions)
+        {
+          const bool isReference = (precision == headless::WeightPrecision::Float32);
+          const char* precisionName = headless::GetWeightPrecisionName(precision);
+          ZooRow row;
+          try
+          {
+            if (!RunModel(model, slimSize, precision, sampleRate, options, source,
+                          esrSource.empty() ? nullptr : &esrSource, isReference ? &referenceOutput : &esrOutput, row))
+            {
+              std::fprintf(stderr, "%s: no %s row, the layer layout isn't known for this config\n", model.name.c_str(),
+                           precisionName);
+              continue;
+            }
+          }
+          catch (const std::exception& e)
+          {
+            std::fprintf(stderr, "%s: %s\n", model.name.c_str(), e.what());
+            modelFailed = true;
+            break;
+          }
+          slimmable = row.slimmable;
+          char slimText[16] = "-";
+          if (row.slimmable)
+            std::snprintf(slimText, sizeof(slimText), "%.2f", slimSize);
+          char esrText[16] = "-";
+          if (!isReference && !esrSource.empty())
+            std::snprintf(esrText, sizeof(esrText), "%.3e", ComputeESR(esrOutput, referenceOutput));
+          const double weightsMiB = ToMegabytes(row.weights.GetBytes(precision));
+          if (options.csv)
+            std::printf("%s,%s,%s,%s,%.0f,%.3f,%.3f,%.4f,%.3f,%.3f,%.3f,%s\n", model.name.c_str(),
+                        row.architecture.c_str(), slimText, precisionName, sampleRate, row.loadMs, row.prewarmMs,
+                        row.realTimeFactor, weightsMiB, ToMegabytes(row.heapBytes), ToMegabytes(row.rssBytes),
+                        esrText);
+          else
+            std::printf("%-26s %-18s %5s %5s %7.0f %9.2f %10.2f %8.4f %11.3f %9.2f %8.2f %10s\n", model.name.c_str(),
+                        row.architecture.c_str(), slimText, precisionName, sampleRate, row.loadMs, row.prewarmMs,
+                        row.realTimeFactor, weightsMiB, ToMegabytes(row.heapBytes), ToMegabytes(row.rssBytes),
+                        esrText);
+        }
+        if (modelFailed)
+          break;
+        // Sizes only mean something to slimmable models; the rest get one row.
+        if (!slimmable)
+          break;
+      }
+      anyFailed = anyFailed || modelFailed;
+    }
+  }
+  return anyFailed ? 1 : 0;
+}
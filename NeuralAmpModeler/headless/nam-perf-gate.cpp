@@ -0,0 +1,396 @@
+// nam-perf-gate: CPU regression gate against the ns/sample baselines checked in as perf-baselines.json.
+// Measures every built-in stage (mono and stereo core) plus the whole ProcessBlock() chain with plug-in defaults and
+// with each baseline preset, then prints a diff against the stored numbers and fails if anything got slower than the
+// threshold allows.
+//
+//   nam-perf-gate [--baseline perf-baselines.json] [--threshold 10] [--min-delta-ns 0.5] [--filter chain/]
+//                 [--preset rig.nampreset ...] [--seconds 1.0] [--repeats 5] [--update] [--require-baselines]
+//
+// Entries with no stored baseline are reported as skipped and not gated, so a baseline file that hasn't been recorded
+// on this machine class yet doesn't fail the run. Exit status: 0 within threshold (skipped entries included), 1
+// regression, 2 usage or baseline file error, 3 skipped entries with --require-baselines.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "architecture.hpp"
+#include "json.hpp"
+#include "HeadlessSignal.h"
+#include "HeadlessStages.h"
+#include "NAMHeadlessHost.h"
+
+#ifndef NAM_PERF_BASELINE_PATH
+  #define NAM_PERF_BASELINE_PATH "perf-baselines.json"
+#endif
+
+namespace
+{
+constexpr int kBaselineFormatVersion = 1;
+
+struct GateOptions
+{
+  std::string baselinePath = NAM_PERF_BASELINE_PATH;
+  std::vector<std::string> presets; // Empty: use the presets recorded in the baseline file.
+  std::string filter;
+  double thresholdPercent = 10.0;
+  // Ignore differences below this many ns/sample; cheap stages are otherwise dominated by timer noise.
+  double minDeltaNs = 0.5;
+  double seconds = 1.0;
+  int repeats = 5;
+  bool update = false;
+  bool requireBaselines = false;
+};
+
+struct Baseline
+{
+  double sampleRate = 48000.0;
+  int blockSize = 64;
+  std::string hostDescription;
+  std::vector<std::string> presets;
+  std::map<std::string, double> nsPerSample;
+};
+
+void PrintUsage()
+{
+  std::fprintf(stderr,
+               "Usage: nam-perf-gate [--baseline <file.json>] [--threshold percent] [--min-delta-ns ns]\n"
+               "                     [--filter substring] [--preset <file.nampreset>]... [--seconds s]\n"
+               "                     [--repeats n] [--update] [--require-baselines]\n");
+}
+
+bool ParseArgs(int argc, char* argv[], GateOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--update") == 0)
+    {
+      options.update = true;
+      continue;
+    }
+    if (std::strcmp(arg, "--require-baselines") == 0)
+    {
+      options.requireBaselines = true;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--baseline") == 0)
+      options.baselinePath = value;
+    else if (std::strcmp(arg, "--preset") == 0)
+      options.presets.push_back(value);
+    else if (std::strcmp(arg, "--filter") == 0)
+      options.filter = value;
+    else if (std::strcmp(arg, "--threshold") == 0)
+      options.thresholdPercent = std::atof(value);
+    else if (std::strcmp(arg, "--min-delta-ns") == 0)
+      options.minDeltaNs = std::atof(value);
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--repeats") == 0)
+      options.repeats = std::atoi(value);
+    else
+      return false;
+    ++i;
+  }
+  return options.thresholdPercent >= 0.0 && options.minDeltaNs >= 0.0 && options.seconds > 0.0
+         && options.repeats > 0;
+}
+
+std::string GetHostDescription()
+{
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line))
+  {
+    if (line.rfind("model name", 0) == 0)
+    {
+      const size_t colon = line.find(':');
+      if (colon != std::string::npos)
+        return line.substr(line.find_first_not_of(' ', colon + 1));
+    }
+  }
+  return "unknown";
+}
+
+bool ReadBaseline(const std::string& path, Baseline& baseline, std::string& errorMessage)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    errorMessage = "Cannot open baseline file " + path;
+    return false;
+  }
+  try
+  {
+    nlohmann::json json;
+    file >> json;
+    if (json.value("version", 0) != kBaselineFormatVersion)
+    {
+      errorMessage = "Unsupported baseline format version in " + path;
+      return false;
+    }
+    baseline.sampleRate = json.value("sampleRate", baseline.sampleRate);
+    baseline.blockSize = json.value("blockSize", baseline.blockSize);
+    baseline.hostDescription = json.value("host", std::string());
+    baseline.presets = json.value("presets", std::vector<std::string>());
+    baseline.nsPerSample = json.value("nsPerSample", std::map<std::string, double>());
+  }
+  catch (const std::exception& e)
+  {
+    errorMessage = "Malformed baseline file " + path + ": " + e.what();
+    return false;
+  }
+  return true;
+}
+
+bool WriteBaseline(const std::string& path, const Baseline& baseline, std::string& errorMessage)
+{
+  nlohmann::json json;
+  json["version"] = kBaselineFormatVersion;
+  json["sampleRate"] = baseline.sampleRate;
+  json["blockSize"] = baseline.blockSize;
+  json["host"] = baseline.hostDescription;
+  json["presets"] = baseline.presets;
+  // Round so re-baselining produces a readable diff instead of churn in the last digits.
+  nlohmann::json entries = nlohmann::json::object();
+  for (const auto& [name, value] : baseline.nsPerSample)
+    entries[name] = std::round(value * 1000.0) / 1000.0;
+  json["nsPerSample"] = entries;
+
+  std::ofstream file(path, std::ios::trunc);
+  if (!file.is_open())
+  {
+    errorMessage = "Cannot write baseline file " + path;
+    return false;
+  }
+  file << std::setw(2) << json << "\n";
+  return true;
+}
+
+// Preset paths in the baseline are relative to the baseline file so the gate can run from any directory.
+std::string ResolvePresetPath(const std::string& baselinePath, const std::string& presetPath)
+{
+  const std::filesystem::path preset(presetPath);
+  if (preset.is_absolute())
+    return presetPath;
+  return (std::filesystem::absolute(baselinePath).parent_path() / preset).string();
+}
+
+// Best-of-repeats cost of the full chain (the host's ProcessBlock() plus its float conversion) in ns/sample.
+double MeasureChainNsPerSample(headless::NAMHeadlessHost& host, const std::vector<float>& source,
+                               const double seconds, const int repeats)
+{
+  const int blockSize = host.GetMaxBlockSize();
+  std::vector<float> scratch(static_cast<size_t>(blockSize * host.GetNumOutputs()), 0.0f);
+  float* outputs[2] = {scratch.data(), scratch.data() + blockSize};
+  const size_t numBlocks =
+    std::max<size_t>(64, static_cast<size_t>(std::ceil(seconds * host.GetSampleRate() / blockSize)));
+
+  const auto runBlocks = [&](const size_t count) {
+    size_t sourcePos = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t block = 0; block < count; ++block)
+    {
+      if (sourcePos + static_cast<size_t>(blockSize) > source.size())
+        sourcePos = 0;
+      const float* inputs[2] = {source.data() + sourcePos, source.data() + sourcePos};
+      host.ProcessBlock(inputs, outputs, blockSize);
+      sourcePos += static_cast<size_t>(blockSize);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  runBlocks(std::max<size_t>(8, numBlocks / 10));
+  double bestSeconds = 0.0;
+  for (int repeat = 0; repeat < repeats; ++repeat)
+  {
+    const double elapsed = runBlocks(numBlocks);
+    bestSeconds = (repeat == 0) ? elapsed : std::min(bestSeconds, elapsed);
+  }
+  return bestSeconds * 1.0e9 / (static_cast<double>(numBlocks) * static_cast<double>(blockSize));
+}
+
+bool EntrySelected(const GateOptions& options, const std::string& name)
+{
+  return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+bool Measure(const GateOptions& options, const Baseline& config, std::map<std::string, double>& results)
+{
+  const std::vector<float> source = headless::MakePluckTestSignal(config.sampleRate, 1.0);
+
+  {
+    headless::NAMHeadlessHost host;
+    host.Prepare(config.sampleRate, config.blockSize, 2);
+    host.Settle(10.0);
+    headless::StageBuffers buffers;
+    for (const auto& stage : headless::MakeStages())
+    {
+      for (const size_t core : {size_t(1), size_t(2)})
+      {
+        const std::string name = std::string("stage/") + stage.name + (core == 1 ? "/mono" : "/stereo");
+        if (!EntrySelected(options, name))
+          continue;
+        headless::StageMeasureSettings settings;
+        settings.sampleRate = config.sampleRate;
+        settings.blockSize = config.blockSize;
+        settings.numChannelsMonoCore = core;
+        settings.seconds = options.seconds;
+        settings.repeats = options.repeats;
+        results[name] = headless::MeasureStageNsPerSample(stage, host.GetPlug(), settings, source, buffers);
+        std::fprintf(stderr, "  %-36s %10.3f\n", name.c_str(), results[name]);
+      }
+    }
+  }
+
+  // Whole chain: a fresh instance per preset so no state leaks between rigs.
+  std::vector<std::pair<std::string, std::string>> chains = {{"chain/defaults", ""}};
+  for (const auto& preset : config.presets)
+    chains.emplace_back("chain/" + std::filesystem::path(preset).stem().string(), preset);
+  for (const auto& [name, preset] : chains)
+  {
+    if (!EntrySelected(options, name))
+      continue;
+    headless::NAMHeadlessHost host;
+    host.Prepare(config.sampleRate, config.blockSize, 1);
+    if (!preset.empty() && !host.LoadPreset(ResolvePresetPath(options.baselinePath, preset)))
+    {
+      std::fprintf(stderr, "Failed to load preset %s\n", preset.c_str());
+      return false;
+    }
+    if (!host.Settle(30.0))
+      std::fprintf(stderr, "Warning: %s did not settle; measuring anyway\n", name.c_str());
+    results[name] = MeasureChainNsPerSample(host, source, options.seconds, options.repeats);
+    std::fprintf(stderr, "  %-36s %10.3f\n", name.c_str(), results[name]);
+  }
+  return true;
+}
+
+struct DiffSummary
+{
+  int numRegressions = 0;
+  int numSkipped = 0;
+};
+
+// Prints one row per entry.
+DiffSummary PrintDiff(const GateOptions& options, const Baseline& baseline,
+                      const std::map<std::string, double>& results)
+{
+  DiffSummary summary;
+  std::printf("%-36s %10s %10s %9s  %s\n", "entry (ns/sample)", "baseline", "current", "delta", "status");
+  int numRegressions = 0;
+  for (const auto& [name, current] : results)
+  {
+    const auto it = baseline.nsPerSample.find(name);
+    if (it == baseline.nsPerSample.end())
+    {
+      std::printf("%-36s %10s %10.3f %9s  skipped (no baseline)\n", name.c_str(), "-", current, "-");
+      ++summary.numSkipped;
+      continue;
+    }
+    const double reference = it->second;
+    const double deltaNs = current - reference;
+    const double deltaPercent = reference > 0.0 ? 100.0 * deltaNs / reference : 0.0;
+    const char* status = "ok";
+    if (deltaPercent > options.thresholdPercent && deltaNs > options.minDeltaNs)
+    {
+      status = "REGRESSED";
+      ++summary.numRegressions;
+    }
+    else if (deltaPercent < -options.thresholdPercent && -deltaNs > options.minDeltaNs)
+      status = "faster (consider --update)";
+    std::printf("%-36s %10.3f %10.3f %+8.1f%%  %s\n", name.c_str(), reference, current, deltaPercent, status);
+  }
+  for (const auto& [name, reference] : baseline.nsPerSample)
+    if (EntrySelected(options, name) && results.find(name) == results.end())
+      std::printf("%-36s %10.3f %10s %9s  not measured\n", name.c_str(), reference, "-", "-");
+  return summary;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  GateOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    PrintUsage();
+    return 2;
+  }
+
+  Baseline baseline;
+  std::string errorMessage;
+  const bool haveBaseline = ReadBaseline(options.baselinePath, baseline, errorMessage);
+  if (!haveBaseline && !options.update)
+  {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    return 2;
+  }
+  if (!options.presets.empty())
+  {
+    const auto baselineDir = std::filesystem::absolute(options.baselinePath).parent_path();
+    baseline.presets.clear();
+    for (const auto& preset : options.presets)
+      baseline.presets.push_back(
+        std::filesystem::relative(std::filesystem::absolute(preset), baselineDir).generic_string());
+  }
+
+  const std::string hostDescription = GetHostDescription();
+  if (haveBaseline && !options.update && baseline.hostDescription != hostDescription)
+    std::fprintf(stderr, "Warning: baseline was recorded on \"%s\", this is \"%s\"; numbers may not compare\n",
+                 baseline.hostDescription.c_str(), hostDescription.c_str());
+
+  // Match the audio thread: ProcessBlock() runs with denormals flushed.
+  disable_denormals();
+
+  std::fprintf(stderr, "Measuring at %.0f Hz, block %d...\n", baseline.sampleRate, baseline.blockSize);
+  std::map<std::string, double> results;
+  if (!Measure(options, baseline, results))
+    return 2;
+
+  if (options.update)
+  {
+    // A filtered update only replaces the entries it measured.
+    for (const auto& [name, value] : results)
+      baseline.nsPerSample[name] = value;
+    baseline.hostDescription = hostDescription;
+    if (!WriteBaseline(options.baselinePath, baseline, errorMessage))
+    {
+      std::fprintf(stderr, "%s\n", errorMessage.c_str());
+      return 2;
+    }
+    std::printf("Wrote %zu entries to %s\n", baseline.nsPerSample.size(), options.baselinePath.c_str());
+    return 0;
+  }
+
+  const DiffSummary summary = PrintDiff(options, baseline, results);
+  if (summary.numRegressions > 0)
+  {
+    std::printf("\nFAIL: %d of %zu entries regressed by more than %.1f%% (and %.2f ns/sample)\n",
+                summary.numRegressions, results.size(), options.thresholdPercent, options.minDeltaNs);
+    return 1;
+  }
+  const int numGated = static_cast<int>(results.size()) - summary.numSkipped;
+  if (summary.numSkipped > 0)
+  {
+    std::printf("\nSKIPPED: %d of %zu entries have no baseline and were not gated; record them with --update on the "
+                "reference machine\n",
+                summary.numSkipped, results.size());
+    if (options.requireBaselines)
+      return 3;
+  }
+  std::printf("%sOK: %d entries within %.1f%% of baseline\n", summary.numSkipped > 0 ? "" : "\n", numGated,
+              options.thresholdPercent);
+  return 0;
+}
@@ -0,0 +1,206 @@
+// nam-render: offline render of a WAV file through the full NeuralAmpModeler ProcessBlock() chain with a saved
+// .nampreset, without a UI or plug-in SDK. Reports real-time factor, per-block timing, peak RSS and the memory held by
+// each model, IR and FX buffer after the render.
+//
+//   nam-render --input "REAPER/Guitar DI.wav" --preset rig.nampreset --output out.wav [--block-size 64]
+//              [--channels 1|2] [--settle-timeout 30]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "HeadlessStats.h"
+#include "HeadlessWav.h"
+#include "NAMHeadlessHost.h"
+#include "NAMHeadlessProbe.h"
+#include "RTSanitizer.h"
+
+namespace
+{
+struct RenderOptions
+{
+  std::string inputPath;
+  std::string presetPath;
+  std::string outputPath;
+  int blockSize = 64;
+  int channels = 0; // 0 = follow the input file
+  double settleTimeoutSeconds = 30.0;
+};
+
+void PrintUsage()
+{
+  std::fprintf(stderr,
+               "Usage: nam-render --input <in.wav> --preset <file.nampreset> [--output <out.wav>]\n"
+               "                  [--block-size N] [--channels 1|2] [--settle-timeout seconds]\n");
+}
+
+bool ParseArgs(int argc, char* argv[], RenderOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+      return false;
+    if (value == nullptr)
+    {
+      std::fprintf(stderr, "Missing value for %s\n", arg);
+      return false;
+    }
+    if (std::strcmp(arg, "--input") == 0)
+      options.inputPath = value;
+    else if (std::strcmp(arg, "--preset") == 0)
+      options.presetPath = value;
+    else if (std::strcmp(arg, "--output") == 0)
+      options.outputPath = value;
+    else if (std::strcmp(arg, "--block-size") == 0)
+      options.blockSize = std::atoi(value);
+    else if (std::strcmp(arg, "--channels") == 0)
+      options.channels = std::atoi(value);
+    else if (std::strcmp(arg, "--settle-timeout") == 0)
+      options.settleTimeoutSeconds = std::atof(value);
+    else
+    {
+      std::fprintf(stderr, "Unknown option %s\n", arg);
+      return false;
+    }
+    ++i;
+  }
+  return !options.inputPath.empty() && !options.presetPath.empty() && options.blockSize > 0
+         && options.channels >= 0 && options.channels <= 2;
+}
+
+double GetPeakRSSMegabytes()
+{
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+  return static_cast<double>(usage.ru_maxrss) / 1024.0; // ru_maxrss is in KiB on Linux.
+}
+
+double ToMegabytes(const size_t bytes)
+{
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+void PrintMemoryReport(const MemoryReport& report)
+{
+  std::printf("memory         %.2f MiB held by models, IRs and FX buffers
+", ToMegabytes(report.GetTotalBytes()));
+  for (size_t c = 0; c < kMemoryCategoryCount; ++c)
+  {
+    const auto category = static_cast<MemoryCategory>(c);
+    const size_t categoryBytes = report.GetTotalBytes(category);
+    if (categoryBytes == 0)
+      continue;
+    std::printf("  %-14s %9.2f MiB\n", GetMemoryCategoryName(category), ToMegabytes(categoryBytes));
+    for (size_t i = 0; i < report.numEntries; ++i)
+    {
+      const MemoryReportEntry& entry = report.entries[i];
+      if (entry.category != category)
+        continue;
+      char label[64];
+      if (entry.index >= 0)
+        std::snprintf(label, sizeof(label), "%s[%d]", entry.name, entry.index);
+      else
+        std::snprintf(label, sizeof(label), "%s", entry.name);
+      std::printf("    %-30s %9.2f MiB\n", label, ToMegabytes(entry.bytes));
+    }
+  }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  RenderOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    PrintUsage();
+    return 2;
+  }
+
+  headless::WavData input;
+  std::string errorMessage;
+  if (!headless::ReadWav(options.inputPath, input, errorMessage))
+  {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    return 1;
+  }
+  const int numInputs = options.channels > 0 ? options.channels : std::min(2, static_cast<int>(input.channels.size()));
+  // A mono file feeding a stereo input is duplicated to both sides.
+  while (static_cast<int>(input.channels.size()) < numInputs)
+    input.channels.push_back(input.channels.front());
+
+  headless::NAMHeadlessHost host;
+  host.Prepare(input.sampleRate, options.blockSize, numInputs);
+  if (!host.LoadPreset(options.presetPath))
+  {
+    std::fprintf(stderr, "Failed to load preset %s\n", options.presetPath.c_str());
+    return 1;
+  }
+  const auto settleStart = std::chrono::steady_clock::now();
+  if (!host.Settle(options.settleTimeoutSeconds))
+    std::fprintf(stderr, "Warning: model/IR loads did not settle within %.1f s\n", options.settleTimeoutSeconds);
+  const double settleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - settleStart).count();
+
+  const size_t numFrames = input.GetNumFrames();
+  headless::WavData output;
+  output.sampleRate = input.sampleRate;
+  output.channels.assign(static_cast<size_t>(host.GetNumOutputs()), std::vector<float>(numFrames, 0.0f));
+
+  std::vector<double> blockMicros;
+  blockMicros.reserve(numFrames / static_cast<size_t>(options.blockSize) + 1);
+  std::vector<const float*> inputPointers(static_cast<size_t>(numInputs));
+  std::vector<float*> outputPointers(static_cast<size_t>(host.GetNumOutputs()));
+  double totalSeconds = 0.0;
+  for (size_t pos = 0; pos < numFrames; pos += static_cast<size_t>(options.blockSize))
+  {
+    const int nFrames = static_cast<int>(std::min(static_cast<size_t>(options.blockSize), numFrames - pos));
+    for (int ch = 0; ch < numInputs; ++ch)
+      inputPointers[ch] = input.channels[static_cast<size_t>(ch)].data() + pos;
+    for (size_t ch = 0; ch < outputPointers.size(); ++ch)
+      outputPointers[ch] = output.channels[ch].data() + pos;
+
+    const auto blockStart = std::chrono::steady_clock::now();
+    host.ProcessBlock(inputPointers.data(), outputPointers.data(), nFrames);
+    const double blockSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - blockStart).count();
+    totalSeconds += blockSeconds;
+    blockMicros.push_back(blockSeconds * 1.0e6);
+    host.Idle();
+  }
+
+  if (!options.outputPath.empty() && !headless::WriteWavFloat32(options.outputPath, output, errorMessage))
+  {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    return 1;
+  }
+
+  const double audioSeconds = static_cast<double>(numFrames) / input.sampleRate;
+  const headless::TimingSummary blockSummary = headless::SummarizeTimings(blockMicros);
+  const double blockBudgetMicros = 1.0e6 * static_cast<double>(options.blockSize) / input.sampleRate;
+
+  std::printf("input          %s (%.0f Hz, %d ch in, %.2f s)\n", options.inputPath.c_str(), input.sampleRate,
+              numInputs, audioSeconds);
+  std::printf("preset         %s (settled in %.2f s)\n", options.presetPath.c_str(), settleSeconds);
+  std::printf("block size     %d (budget %.1f us)\n", options.blockSize, blockBudgetMicros);
+  std::printf("real-time x    %.4f (%.2f s processing / %.2f s audio)\n",
+              audioSeconds > 0.0 ? totalSeconds / audioSeconds : 0.0, totalSeconds, audioSeconds);
+  std::printf("block min      %.2f us\n", blockSummary.min);
+  std::printf("block mean     %.2f us\n", blockSummary.mean);
+  std::printf("block p99      %.2f us\n", blockSummary.p99);
+  std::printf("peak RSS       %.1f MiB\n", GetPeakRSSMegabytes());
+  MemoryReport memoryReport;
+  NAMHeadlessProbe::CollectMemoryReport(host.GetPlug(), memoryReport);
+  PrintMemoryReport(memoryReport);
+#if NAM_RT_SANITIZER
+  std::printf("RT violations  %llu (reports on stderr)\n",
+              static_cast<unsigned long long>(NAMRTSanitizer::GetViolationCount()));
+#endif
+  return 0;
+}
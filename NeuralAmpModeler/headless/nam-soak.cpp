@@ -0,0 +1,341 @@
+// nam-soak: concurrency soak test for model/IR staging and slot switching.
+//
+// The audio thread runs ProcessBlock() back to back (paced to real time by default) while a control thread hammers
+// the editor-side entry points at random: _SelectAmpSlot(), _SelectAmpSlotModelVariant(), cab source/position +
+// _ApplyCabSlotSource(), IR file loads (_StageIRLeft/_StageIRRight, including a missing file) and preset recall,
+// pumping OnIdle() in between as the UI timer would. Every output block is checked for glitches:
+//   - non-finite samples (NaN/Inf),
+//   - discontinuities: a sample-to-sample step above --jump-threshold (across block boundaries too),
+//   - blocks that take longer than --deadline-fraction of their real-time budget.
+//
+// Build the headless tools with -DNAM_TSAN=ON to run it under ThreadSanitizer; races in the mStaged* /
+// mPendingLoadedSlotModel handoff are then reported on stderr. TSan slows everything down ~5-15x, so use --no-pace
+// and ignore the deadline column there.
+//
+//   nam-soak [--preset a.nampreset ...] [--input di.wav] [--seconds 60] [--block-size 64] [--sample-rate 48000]
+//            [--actions-per-second 200] [--jump-threshold 0.5] [--deadline-fraction 1.0] [--no-pace] [--seed 1]
+//
+// Exit status: 0 clean, 1 NaN/Inf or discontinuities, 3 deadline misses only, 2 usage error.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EmbeddedCabIRAssets.h"
+#include "HeadlessSignal.h"
+#include "HeadlessStats.h"
+#include "HeadlessWav.h"
+#include "NAMHeadlessHost.h"
+#include "NAMHeadlessProbe.h"
+#include "RTSanitizer.h"
+
+namespace
+{
+enum class ActionKind : int
+{
+  AmpSlot = 0,
+  ModelVariant,
+  CabSource,
+  IRFile,
+  PresetRecall,
+  Count
+};
+
+constexpr const char* kActionKindNames[] = {"amp slot", "model variant", "cab source", "IR file", "preset recall"};
+// Glitches are counted per block; only the first few are described.
+constexpr size_t kMaxReportedGlitches = 20;
+
+struct SoakOptions
+{
+  std::vector<std::string> presetPaths;
+  std::string inputPath;
+  double seconds = 60.0;
+  int blockSize = 64;
+  double sampleRate = 48000.0;
+  double actionsPerSecond = 200.0;
+  double jumpThreshold = 0.5;
+  double deadlineFraction = 1.0;
+  bool pace = true;
+  unsigned int seed = 1;
+};
+
+struct GlitchCounts
+{
+  size_t nonFiniteBlocks = 0;
+  size_t discontinuityBlocks = 0;
+  size_t deadlineMisses = 0;
+  size_t reported = 0;
+};
+
+bool ParseArgs(int argc, char* argv[], SoakOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--no-pace") == 0)
+    {
+      options.pace = false;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--preset") == 0)
+      options.presetPaths.push_back(value);
+    else if (std::strcmp(arg, "--input") == 0)
+      options.inputPath = value;
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--block-size") == 0)
+      options.blockSize = std::atoi(value);
+    else if (std::strcmp(arg, "--sample-rate") == 0)
+      options.sampleRate = std::atof(value);
+    else if (std::strcmp(arg, "--actions-per-second") == 0)
+      options.actionsPerSecond = std::atof(value);
+    else if (std::strcmp(arg, "--jump-threshold") == 0)
+      options.jumpThreshold = std::atof(value);
+    else if (std::strcmp(arg, "--deadline-fraction") == 0)
+      options.deadlineFraction = std::atof(value);
+    else if (std::strcmp(arg, "--seed") == 0)
+      options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+    else
+      return false;
+    ++i;
+  }
+  return options.seconds > 0.0 && options.blockSize > 0 && options.sampleRate > 0.0 && options.actionsPerSecond > 0.0
+         && options.jumpThreshold > 0.0 && options.deadlineFraction > 0.0;
+}
+
+// The curated cab captures written out as WAV files, so IR loads go through the file path rather than the embedded
+// shortcut. The last entry doesn't exist, to exercise the load-failure path too.
+std::vector<WDL_String> WriteSoakIRFiles(const std::filesystem::path& dir)
+{
+  std::filesystem::create_directories(dir);
+  std::vector<WDL_String> paths;
+  for (int sourceChoice = 1; sourceChoice <= 4; ++sourceChoice)
+  {
+    for (int captureIndex = 0; captureIndex < 3; ++captureIndex)
+    {
+      const auto* asset = embedded_cab_ir::GetCuratedCabIRAsset(sourceChoice, captureIndex);
+      if (asset == nullptr)
+        break;
+      headless::WavData wav;
+      wav.sampleRate = asset->sampleRate;
+      wav.channels.emplace_back(asset->samples, asset->samples + asset->numSamples);
+      const auto path = dir / ("ir-" + std::to_string(sourceChoice) + "-" + std::to_string(captureIndex) + ".wav");
+      std::string errorMessage;
+      if (headless::WriteWavFloat32(path.string(), wav, errorMessage))
+        paths.emplace_back(path.string().c_str());
+    }
+  }
+  paths.emplace_back((dir / "missing.wav").string().c_str());
+  return paths;
+}
+
+void ReportGlitch(GlitchCounts& counts, const char* what, const double audioSeconds, const size_t channel,
+                  const double value)
+{
+  if (counts.reported++ < kMaxReportedGlitches)
+    std::fprintf(stderr, "glitch: %s at %.4f s, channel %zu (%g)\n", what, audioSeconds, channel, value);
+}
+
+// Checks one rendered block; previous holds the last sample of each channel from the block before.
+void CheckBlock(const float* const* outputs, const int nFrames, const double blockStartSeconds,
+                const double sampleRate, const double jumpThreshold, float (&previous)[2], GlitchCounts& counts)
+{
+  bool nonFinite = false;
+  bool discontinuity = false;
+  for (size_t c = 0; c < 2; ++c)
+  {
+    for (int s = 0; s < nFrames; ++s)
+    {
+      const float sample = outputs[c][s];
+      if (!std::isfinite(sample))
+      {
+        if (!nonFinite)
+          ReportGlitch(counts, "non-finite sample", blockStartSeconds + s / sampleRate, c, sample);
+        nonFinite = true;
+        previous[c] = 0.0f;
+        continue;
+      }
+      const float step = std::fabs(sample - previous[c]);
+      if (step > jumpThreshold)
+      {
+        if (!discontinuity)
+          ReportGlitch(counts, "discontinuity", blockStartSeconds + s / sampleRate, c, step);
+        discontinuity = true;
+      }
+      previous[c] = sample;
+    }
+  }
+  counts.nonFiniteBlocks += nonFinite ? 1 : 0;
+  counts.discontinuityBlocks += discontinuity ? 1 : 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  SoakOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    std::fprintf(stderr,
+                 "Usage: nam-soak [--preset a.nampreset ...] [--input di.wav] [--seconds 60] [--block-size 64]\n"
+                 "                [--sample-rate 48000] [--actions-per-second 200] [--jump-threshold 0.5]\n"
+                 "                [--deadline-fraction 1.0] [--no-pace] [--seed 1]\n");
+    return 2;
+  }
+
+  std::vector<float> source;
+  if (!options.inputPath.empty())
+  {
+    headless::WavData wav;
+    std::string errorMessage;
+    if (!headless::ReadWav(options.inputPath, wav, errorMessage))
+    {
+      std::fprintf(stderr, "%s\n", errorMessage.c_str());
+      return 2;
+    }
+    source = wav.channels.front();
+  }
+  if (source.empty())
+    source = headless::MakePluckTestSignal(options.sampleRate, 4.0);
+
+  const std::vector<WDL_String> irPaths =
+    WriteSoakIRFiles(std::filesystem::temp_directory_path() / ("nam-soak-irs-" + std::to_string(options.seed)));
+
+  headless::NAMHeadlessHost host;
+  host.Prepare(options.sampleRate, options.blockSize, 1);
+  if (!options.presetPaths.empty() && !host.LoadPreset(options.presetPaths.front()))
+  {
+    std::fprintf(stderr, "Failed to load preset %s\n", options.presetPaths.front().c_str());
+    return 2;
+  }
+  if (!host.Settle(30.0))
+    std::fprintf(stderr, "Warning: startup loads did not settle\n");
+
+  NeuralAmpModeler& plug = host.GetPlug();
+  std::atomic<bool> audioDone{false};
+  std::vector<size_t> actionCounts(static_cast<size_t>(ActionKind::Count), 0);
+  size_t failedPresetRecalls = 0;
+
+  // Control thread: plays the editor, as fast as --actions-per-second allows.
+  std::thread controlThread([&]() {
+    std::mt19937 rng(options.seed * 7919u + 17u);
+    std::exponential_distribution<double> nextActionGap(options.actionsPerSecond);
+    const int numKinds = options.presetPaths.empty() ? static_cast<int>(ActionKind::PresetRecall)
+                                                     : static_cast<int>(ActionKind::Count);
+    std::uniform_int_distribution<int> actionKind(0, numKinds - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const auto pick = [&](const size_t count) { return std::min(count - 1, static_cast<size_t>(unit(rng) * count)); };
+    const int numSlots = NAMHeadlessProbe::GetAmpSlotCount(plug);
+    const int numVariants = NAMHeadlessProbe::GetAmpModelVariantCount();
+    while (!audioDone.load(std::memory_order_acquire))
+    {
+      const auto kind = static_cast<ActionKind>(actionKind(rng));
+      switch (kind)
+      {
+        case ActionKind::AmpSlot:
+          NAMHeadlessProbe::SelectAmpSlot(plug, static_cast<int>(pick(static_cast<size_t>(numSlots))));
+          break;
+        case ActionKind::ModelVariant:
+          NAMHeadlessProbe::SelectAmpSlotModelVariant(plug, static_cast<int>(pick(static_cast<size_t>(numSlots))),
+                                                      static_cast<int>(pick(static_cast<size_t>(numVariants))));
+          break;
+        case ActionKind::CabSource:
+        {
+          const bool cabB = unit(rng) < 0.5;
+          const int paramIdx = (unit(rng) < 0.5) ? (cabB ? kCabBSource : kCabASource)
+                                                 : (cabB ? kCabBPosition : kCabAPosition);
+          plug.SetParameterFromHost(paramIdx, unit(rng));
+          NAMHeadlessProbe::ApplyCabSlotSource(plug, cabB ? 1 : 0);
+          break;
+        }
+        case ActionKind::IRFile:
+          NAMHeadlessProbe::StageIRFile(plug, unit(rng) < 0.5, irPaths[pick(irPaths.size())]);
+          break;
+        case ActionKind::PresetRecall:
+          if (!host.LoadPreset(options.presetPaths[pick(options.presetPaths.size())]))
+            ++failedPresetRecalls;
+          break;
+        case ActionKind::Count: break;
+      }
+      ++actionCounts[static_cast<size_t>(kind)];
+      host.Idle();
+      std::this_thread::sleep_for(std::chrono::duration<double>(nextActionGap(rng)));
+    }
+  });
+
+  std::vector<float> outputLeft(static_cast<size_t>(options.blockSize));
+  std::vector<float> outputRight(static_cast<size_t>(options.blockSize));
+  float* outputs[2] = {outputLeft.data(), outputRight.data()};
+  float previous[2] = {0.0f, 0.0f};
+  GlitchCounts glitches;
+  std::vector<double> blockMicros;
+  blockMicros.reserve(static_cast<size_t>(options.seconds * options.sampleRate / options.blockSize) + 16);
+  const double budgetMicros = 1.0e6 * static_cast<double>(options.blockSize) / options.sampleRate;
+
+  const auto start = std::chrono::steady_clock::now();
+  double renderedSeconds = 0.0;
+  size_t sourcePos = 0;
+  while (renderedSeconds < options.seconds)
+  {
+    if (sourcePos + static_cast<size_t>(options.blockSize) > source.size())
+      sourcePos = 0;
+    const float* inputs[1] = {source.data() + sourcePos};
+    sourcePos += static_cast<size_t>(options.blockSize);
+
+    const auto blockStart = std::chrono::steady_clock::now();
+    host.ProcessBlock(inputs, outputs, options.blockSize);
+    const double micros =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - blockStart).count();
+    blockMicros.push_back(micros);
+    if (micros > budgetMicros * options.deadlineFraction)
+      ++glitches.deadlineMisses;
+    CheckBlock(outputs, options.blockSize, renderedSeconds, options.sampleRate, options.jumpThreshold, previous,
+               glitches);
+
+    renderedSeconds += static_cast<double>(options.blockSize) / options.sampleRate;
+    if (options.pace)
+      std::this_thread::sleep_until(
+        start + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(renderedSeconds)));
+  }
+  audioDone.store(true, std::memory_order_release);
+  controlThread.join();
+
+  const headless::TimingSummary timing = headless::SummarizeTimings(blockMicros);
+  std::printf("audio          %.1f s, block %d @ %.0f Hz%s\n", renderedSeconds, options.blockSize, options.sampleRate,
+              options.pace ? "" : " (unpaced)");
+  std::printf("actions        ");
+  for (size_t kind = 0; kind < actionCounts.size(); ++kind)
+    std::printf("%s%zu %s", kind > 0 ? ", " : "", actionCounts[kind], kActionKindNames[kind]);
+  std::printf("\n");
+  if (failedPresetRecalls > 0)
+    std::printf("               %zu preset recall(s) failed\n", failedPresetRecalls);
+  std::printf("blocks         %zu  p50 %.1f us  p99 %.1f us  max %.1f us  (budget %.1f us)\n", timing.count,
+              timing.p50, timing.p99, timing.max, budgetMicros);
+  std::printf("non-finite     %zu block(s)\n", glitches.nonFiniteBlocks);
+  std::printf("discontinuity  %zu block(s) with a step > %.3f\n", glitches.discontinuityBlocks, options.jumpThreshold);
+  std::printf("deadline miss  %zu block(s) over %.0f%% of budget\n", glitches.deadlineMisses,
+              options.deadlineFraction * 100.0);
+#if NAM_RT_SANITIZER
+  std::printf("RT violations  %llu (reports on stderr)\n",
+              static_cast<unsigned long long>(NAMRTSanitizer::GetViolationCount()));
+#endif
+
+  std::error_code error;
+  std::filesystem::remove_all(std::filesystem::temp_directory_path()
+                                / ("nam-soak-irs-" + std::to_string(options.seed)),
+                              error);
+  if (glitches.nonFiniteBlocks > 0 || glitches.discontinuityBlocks > 0)
+    return 1;
+  return glitches.deadlineMisses > 0 ? 3 : 0;
+}
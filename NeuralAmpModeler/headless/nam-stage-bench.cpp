@@ -0,0 +1,150 @@
+// nam-stage-bench: per-stage microbenchmark for the built-in DSP stages of the ProcessBlock() chain.
+// Each stage runs in isolation on a plug-in prepared at the given sample rate, over a sweep of block sizes and
+// mono/stereo core, and the cost is reported in ns per sample frame (and as a fraction of the real-time budget).
+//
+//   nam-stage-bench [--stages comp,reverb] [--block-sizes 16,64,4096] [--sample-rates 48000,96000]
+//                   [--cores mono,stereo] [--seconds 1.0] [--repeats 3] [--csv]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "architecture.hpp"
+#include "HeadlessSignal.h"
+#include "HeadlessStages.h"
+#include "NAMHeadlessHost.h"
+
+namespace
+{
+struct BenchOptions
+{
+  std::vector<std::string> stages;
+  std::vector<int> blockSizes = {16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+  std::vector<double> sampleRates = {44100.0, 48000.0, 88200.0, 96000.0, 192000.0};
+  std::vector<size_t> cores = {1, 2};
+  double seconds = 1.0;
+  int repeats = 3;
+  bool csv = false;
+};
+
+template <typename T, typename Parse>
+std::vector<T> ParseList(const char* text, Parse parse)
+{
+  std::vector<T> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    if (!item.empty())
+      values.push_back(parse(item));
+  return values;
+}
+
+bool ParseArgs(int argc, char* argv[], BenchOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    if (std::strcmp(arg, "--csv") == 0)
+    {
+      options.csv = true;
+      continue;
+    }
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr)
+      return false;
+    if (std::strcmp(arg, "--stages") == 0)
+      options.stages = ParseList<std::string>(value, [](const std::string& s) { return s; });
+    else if (std::strcmp(arg, "--block-sizes") == 0)
+      options.blockSizes = ParseList<int>(value, [](const std::string& s) { return std::atoi(s.c_str()); });
+    else if (std::strcmp(arg, "--sample-rates") == 0)
+      options.sampleRates = ParseList<double>(value, [](const std::string& s) { return std::atof(s.c_str()); });
+    else if (std::strcmp(arg, "--cores") == 0)
+      options.cores =
+        ParseList<size_t>(value, [](const std::string& s) { return static_cast<size_t>(s == "stereo" ? 2 : 1); });
+    else if (std::strcmp(arg, "--seconds") == 0)
+      options.seconds = std::atof(value);
+    else if (std::strcmp(arg, "--repeats") == 0)
+      options.repeats = std::atoi(value);
+    else
+      return false;
+    ++i;
+  }
+  for (const int blockSize : options.blockSizes)
+    if (blockSize <= 0 || blockSize > headless::kMaxStageBlockSize)
+      return false;
+  return options.seconds > 0.0 && options.repeats > 0;
+}
+
+bool StageSelected(const BenchOptions& options, const char* stageName)
+{
+  if (options.stages.empty())
+    return true;
+  for (const auto& filter : options.stages)
+    if (std::strstr(stageName, filter.c_str()) != nullptr)
+      return true;
+  return false;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    std::fprintf(stderr,
+                 "Usage: nam-stage-bench [--stages a,b] [--block-sizes 16,...,4096] [--sample-rates 44100,...]\n"
+                 "                       [--cores mono,stereo] [--seconds 1.0] [--repeats 3] [--csv]\n");
+    return 2;
+  }
+
+  // Match the audio thread: ProcessBlock() runs with denormals flushed.
+  disable_denormals();
+
+  const std::vector<headless::StageDef> stages = headless::MakeStages();
+  headless::NAMHeadlessHost host;
+  headless::StageBuffers buffers;
+
+  if (options.csv)
+    std::printf("stage,sample_rate,block_size,core,ns_per_sample,realtime_percent\n");
+  else
+    std::printf("%-20s %8s %6s %-6s %12s %9s\n", "stage", "rate", "block", "core", "ns/sample", "% budget");
+
+  for (const double sampleRate : options.sampleRates)
+  {
+    host.Prepare(sampleRate, headless::kMaxStageBlockSize, 2);
+    host.Settle(10.0);
+    const std::vector<float> source = headless::MakePluckTestSignal(sampleRate, 1.0);
+
+    for (const auto& stage : stages)
+    {
+      if (!StageSelected(options, stage.name))
+        continue;
+      for (const int blockSize : options.blockSizes)
+      {
+        for (const size_t core : options.cores)
+        {
+          headless::StageMeasureSettings settings;
+          settings.sampleRate = sampleRate;
+          settings.blockSize = blockSize;
+          settings.numChannelsMonoCore = core;
+          settings.seconds = options.seconds;
+          settings.repeats = options.repeats;
+          const double nsPerSample =
+            headless::MeasureStageNsPerSample(stage, host.GetPlug(), settings, source, buffers);
+          const double realtimePercent = nsPerSample * sampleRate * 1.0e-7;
+          const char* coreName = (core == 1) ? "mono" : "stereo";
+          if (options.csv)
+            std::printf("%s,%.0f,%d,%s,%.3f,%.4f\n", stage.name, sampleRate, blockSize, coreName, nsPerSample,
+                        realtimePercent);
+          else
+            std::printf("%-20s %8.0f %6d %-6s %12.3f %8.3f%%\n", stage.name, sampleRate, blockSize, coreName,
+                        nsPerSample, realtimePercent);
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,284 @@
+// nam-startup-bench: time-to-first-sound of a fresh plug-in instance, in Rig and Release amp workflow modes.
+//
+// Each run constructs a new instance, calls Prepare() (OnReset(), which queues the startup model/IR loads),
+// optionally restores a preset the way a host restores a session, then feeds a pluck signal in real-time-paced blocks
+// while pumping OnIdle(). Milestones are wall time since construction began; the load-path phases come from
+// StartupProfile.h and are summed over all threads, so loader-worker phases overlap main-thread ones.
+//
+//   nam-startup-bench [--modes rig,release] [--preset session.nampreset] [--runs 5] [--sample-rate 48000]
+//                     [--block-size 64] [--threshold-db -60] [--timeout 30]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HeadlessSignal.h"
+#include "HeadlessStats.h"
+#include "NAMHeadlessHost.h"
+#include "NAMHeadlessProbe.h"
+#include "StartupProfile.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using NAMStartupProfile::Phase;
+
+struct StartupOptions
+{
+  std::vector<bool> releaseModes = {false, true};
+  std::string presetPath;
+  int runs = 5;
+  double sampleRate = 48000.0;
+  int blockSize = 64;
+  double thresholdDb = -60.0;
+  double timeoutSeconds = 30.0;
+};
+
+// Milliseconds since construction began; negative = not reached before the timeout.
+struct StartupRun
+{
+  double constructMs = 0.0;
+  double prepareMs = 0.0;
+  double presetMs = -1.0;
+  double firstSoundMs = -1.0;
+  double modelLiveMs = -1.0;
+  double settledMs = -1.0;
+  std::array<double, NAMStartupProfile::kPhaseCount> phaseMs = {};
+  std::array<uint64_t, NAMStartupProfile::kPhaseCount> phaseCounts = {};
+};
+
+void PrintUsage()
+{
+  std::fprintf(stderr,
+               "Usage: nam-startup-bench [--modes rig,release] [--preset <file.nampreset>] [--runs N]\n"
+               "                         [--sample-rate Hz] [--block-size N] [--threshold-db dBFS] [--timeout s]\n");
+}
+
+bool ParseModes(const char* value, std::vector<bool>& releaseModes)
+{
+  releaseModes.clear();
+  std::stringstream stream(value);
+  std::string token;
+  while (std::getline(stream, token, ','))
+  {
+    if (token == "rig")
+      releaseModes.push_back(false);
+    else if (token == "release")
+      releaseModes.push_back(true);
+    else
+    {
+      std::fprintf(stderr, "Unknown mode %s (expected rig or release)\n", token.c_str());
+      return false;
+    }
+  }
+  return !releaseModes.empty();
+}
+
+bool ParseArgs(int argc, char* argv[], StartupOptions& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+      return false;
+    if (value == nullptr)
+    {
+      std::fprintf(stderr, "Missing value for %s\n", arg);
+      return false;
+    }
+    if (std::strcmp(arg, "--modes") == 0)
+    {
+      if (!ParseModes(value, options.releaseModes))
+        return false;
+    }
+    else if (std::strcmp(arg, "--preset") == 0)
+      options.presetPath = value;
+    else if (std::strcmp(arg, "--runs") == 0)
+      options.runs = std::atoi(value);
+    else if (std::strcmp(arg, "--sample-rate") == 0)
+      options.sampleRate = std::atof(value);
+    else if (std::strcmp(arg, "--block-size") == 0)
+      options.blockSize = std::atoi(value);
+    else if (std::strcmp(arg, "--threshold-db") == 0)
+      options.thresholdDb = std::atof(value);
+    else if (std::strcmp(arg, "--timeout") == 0)
+      options.timeoutSeconds = std::atof(value);
+    else
+    {
+      std::fprintf(stderr, "Unknown option %s\n", arg);
+      return false;
+    }
+    ++i;
+  }
+  return options.runs > 0 && options.sampleRate > 0.0 && options.blockSize > 0 && options.timeoutSeconds > 0.0;
+}
+
+double MillisecondsSince(const Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool RunStartup(const StartupOptions& options, const bool releaseMode, const std::vector<float>& source,
+                StartupRun& run)
+{
+  NAMStartupProfile::Reset();
+  const auto start = Clock::now();
+  {
+    headless::NAMHeadlessHost host;
+    NAMHeadlessProbe::SetAmpWorkflowMode(host.GetPlug(), releaseMode);
+    run.constructMs = MillisecondsSince(start);
+
+    host.Prepare(options.sampleRate, options.blockSize, 1);
+    run.prepareMs = MillisecondsSince(start);
+
+    if (!options.presetPath.empty())
+    {
+      if (!host.LoadPreset(options.presetPath))
+      {
+        std::fprintf(stderr, "Failed to load preset %s\n", options.presetPath.c_str());
+        return false;
+      }
+      run.presetMs = MillisecondsSince(start);
+    }
+
+    const size_t blockSize = static_cast<size_t>(options.blockSize);
+    const float threshold = static_cast<float>(std::pow(10.0, options.thresholdDb / 20.0));
+    std::vector<float> left(blockSize, 0.0f);
+    std::vector<float> right(blockSize, 0.0f);
+    float* outputs[2] = {left.data(), right.data()};
+    // Real-time pacing, so the loader worker competes with the audio thread as it would in a host.
+    const auto blockPeriod = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(blockSize) / options.sampleRate));
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double>(options.timeoutSeconds));
+    auto nextBlock = Clock::now();
+    size_t sourcePos = 0;
+    while (Clock::now() < deadline)
+    {
+      if (sourcePos + blockSize > source.size())
+        sourcePos = 0;
+      const float* inputs[1] = {source.data() + sourcePos};
+      sourcePos += blockSize;
+
+      host.Idle();
+      host.ProcessBlock(inputs, outputs, options.blockSize);
+      const double nowMs = MillisecondsSince(start);
+      float peak = 0.0f;
+      for (size_t s = 0; s < blockSize; ++s)
+        peak = std::max(peak, std::max(std::fabs(left[s]), std::fabs(right[s])));
+      if (run.firstSoundMs < 0.0 && peak > threshold)
+        run.firstSoundMs = nowMs;
+      if (run.modelLiveMs < 0.0 && NAMHeadlessProbe::HasLiveAmpModel(host.GetPlug()))
+        run.modelLiveMs = nowMs;
+      if (run.settledMs < 0.0 && NAMHeadlessProbe::IsSettled(host.GetPlug()))
+        run.settledMs = nowMs;
+      if (run.firstSoundMs >= 0.0 && run.settledMs >= 0.0)
+        break;
+
+      nextBlock += blockPeriod;
+      std::this_thread::sleep_until(nextBlock);
+    }
+  }
+
+  // Destroying the host joins the loader worker, so phases of jobs still in flight are complete here.
+  for (size_t p = 0; p < NAMStartupProfile::kPhaseCount; ++p)
+  {
+    run.phaseMs[p] = static_cast<double>(NAMStartupProfile::GetTotalNs(static_cast<Phase>(p))) * 1.0e-6;
+    run.phaseCounts[p] = NAMStartupProfile::GetCount(static_cast<Phase>(p));
+  }
+  return true;
+}
+
+void PrintMilestone(const char* label, const double ms)
+{
+  if (ms < 0.0)
+    std::printf("  %-10s      n/a", label);
+  else
+    std::printf("  %-10s %8.1f", label, ms);
+}
+
+// Median over runs that reached the milestone; negative if none did.
+double MedianReached(const std::vector<StartupRun>& runs, double StartupRun::*field)
+{
+  std::vector<double> values;
+  for (const auto& run : runs)
+    if (run.*field >= 0.0)
+      values.push_back(run.*field);
+  if (values.empty())
+    return -1.0;
+  std::sort(values.begin(), values.end());
+  return headless::PercentileOfSorted(values, 0.5);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  StartupOptions options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    PrintUsage();
+    return 2;
+  }
+
+  const std::vector<float> source = headless::MakePluckTestSignal(options.sampleRate, 2.0);
+  std::printf("sample rate %.0f Hz, block %d, first sound above %.1f dBFS, %d run(s) per mode\n", options.sampleRate,
+              options.blockSize, options.thresholdDb, options.runs);
+  std::printf("milestones in ms since construction; phases in ms summed over all threads (calls)\n");
+
+  bool anyMissed = false;
+  for (const bool releaseMode : options.releaseModes)
+  {
+    const char* modeName = releaseMode ? "release" : "rig";
+    std::vector<StartupRun> runs;
+    for (int runIndex = 0; runIndex < options.runs; ++runIndex)
+    {
+      StartupRun run;
+      if (!RunStartup(options, releaseMode, source, run))
+        return 1;
+      std::printf("%-7s #%d", modeName, runIndex + 1);
+      PrintMilestone("construct", run.constructMs);
+      PrintMilestone("prepare", run.prepareMs);
+      if (!options.presetPath.empty())
+        PrintMilestone("preset", run.presetMs);
+      PrintMilestone("sound", run.firstSoundMs);
+      PrintMilestone("model", run.modelLiveMs);
+      PrintMilestone("settled", run.settledMs);
+      std::printf("\n");
+      anyMissed = anyMissed || (run.firstSoundMs < 0.0);
+      runs.push_back(run);
+    }
+
+    std::printf("%-7s median", modeName);
+    PrintMilestone("construct", MedianReached(runs, &StartupRun::constructMs));
+    PrintMilestone("prepare", MedianReached(runs, &StartupRun::prepareMs));
+    if (!options.presetPath.empty())
+      PrintMilestone("preset", MedianReached(runs, &StartupRun::presetMs));
+    PrintMilestone("sound", MedianReached(runs, &StartupRun::firstSoundMs));
+    PrintMilestone("model", MedianReached(runs, &StartupRun::modelLiveMs));
+    PrintMilestone("settled", MedianReached(runs, &StartupRun::settledMs));
+    std::printf("\n");
+    for (size_t p = 0; p < NAMStartupProfile::kPhaseCount; ++p)
+    {
+      std::vector<double> phaseMs;
+      for (const auto& run : runs)
+        phaseMs.push_back(run.phaseMs[p]);
+      const headless::TimingSummary summary = headless::SummarizeTimings(phaseMs);
+      std::printf("          %-20s median %8.1f  min %8.1f  max %8.1f  (%llu calls in the last run)\n",
+                  NAMStartupProfile::GetPhaseName(static_cast<Phase>(p)), summary.p50, summary.min, summary.max,
+                  static_cast<unsigned long long>(runs.back().phaseCounts[p]));
+    }
+  }
+
+  if (anyMissed)
+    std::fprintf(stderr, "Warning: some runs produced no sound within %.1f s\n", options.timeoutSeconds);
+  return anyMissed ? 3 : 0;
+}
@@ -0,0 +1,59 @@
+#!/bin/bash
+# Records the nam-golden references from the tree pinned by "referenceCommit" in golden/golden.json (the last
+# commit before the DSP and loader optimizations) and writes golden/SHA256SUMS. Building the pinned tree keeps the
+# references independent of whatever is checked out.
+#
+#   NeuralAmpModeler/headless/record-golden.sh [--preset rig.nampreset ...]
+#
+# Needs git, cmake, python3 and access to the submodule remotes. Verify a checkout with:
+#
+#   (cd NeuralAmpModeler/headless/golden && sha256sum -c SHA256SUMS)
+
+set -euo pipefail
+
+HEADLESS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+GOLDEN_DIR="$HEADLESS_DIR/golden"
+MANIFEST="$GOLDEN_DIR/golden.json"
+REPO_DIR="$(git -C "$HEADLESS_DIR" rev-parse --show-toplevel)"
+
+manifest_value() {
+  python3 -c 'import json, sys; print(json.load(open(sys.argv[1]))[sys.argv[2]])' "$MANIFEST" "$1"
+}
+
+COMMIT="$(manifest_value referenceCommit)"
+DURATION="$(manifest_value seconds)"
+BLOCK_SIZE="$(manifest_value blockSize)"
+if [ "$BLOCK_SIZE" != "64" ]; then
+  # The pinned nam-golden always renders with 64-sample blocks.
+  echo "golden.json blockSize must be 64 (got $BLOCK_SIZE)" >&2
+  exit 2
+fi
+
+WORK_DIR="$(mktemp -d)"
+cleanup() {
+  git -C "$REPO_DIR" worktree remove --force "$WORK_DIR/src" > /dev/null 2>&1 || true
+  rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+git -C "$REPO_DIR" worktree add --detach "$WORK_DIR/src" "$COMMIT"
+git -C "$WORK_DIR/src" submodule update --init --recursive
+cmake -S "$WORK_DIR/src/NeuralAmpModeler/headless" -B "$WORK_DIR/build" -DCMAKE_BUILD_TYPE=Release
+cmake --build "$WORK_DIR/build" --target nam-golden -j"$(nproc)"
+
+"$WORK_DIR/build/nam-golden" --update --golden-dir "$GOLDEN_DIR" \
+  --input "$(cd "$GOLDEN_DIR" && realpath "$(manifest_value input)")" --seconds "$DURATION" "$@"
+
+# The pinned tool predates referenceCommit and drops it when it rewrites the manifest.
+python3 - "$MANIFEST" "$COMMIT" << 'PY'
+import json, sys
+with open(sys.argv[1]) as f:
+    manifest = json.load(f)
+manifest["referenceCommit"] = sys.argv[2]
+with open(sys.argv[1], "w") as f:
+    json.dump(manifest, f, indent=2, sort_keys=True)
+    f.write("\n")
+PY
+
+(cd "$GOLDEN_DIR" && sha256sum -- *.wav > SHA256SUMS)
+echo "Recorded $(wc -l < "$GOLDEN_DIR/SHA256SUMS") references from $COMMIT; commit NeuralAmpModeler/headless/golden/"
@@ -2,7 +2,10 @@
 
 from __future__ import annotations
 
+import json
+import math
 import pathlib
+import struct
 
 
 ROOT = pathlib.Path(__file__).resolve().parents[1]
@@ -10,6 +13,9 @@ INPUT_ROOT = ROOT / "NeuralAmpModeler" / "resources" / "tmpLoad"
 OUTPUT_HEADER = ROOT / "NeuralAmpModeler" / "EmbeddedModelAssets.h"
 OUTPUT_SOURCE = ROOT / "NeuralAmpModeler" / "EmbeddedModelAssets.cpp"
 RAW_STRING_DELIMITER = "NAMMDL"
+# Offsets of the weight arrays are padded to this many floats so each array starts 16-byte aligned.
+WEIGHT_ALIGNMENT_FLOATS = 4
+WEIGHTS_PER_LINE = 8
 AMP_ASSETS = (
     ("Amp1A", "Amp1A.nam"),
     ("Amp1B", "Amp1B.nam"),
@@ -32,6 +38,34 @@ def _read_model_json(path: pathlib.Path) -> str:
     return text
 
 
+def _split_weights(config: object, pointer: str, arrays: list[tuple[str, list[float]]]) -> None:
+    """Moves every non-empty "weights" list out of config (left empty in place), recording its JSON pointer."""
+    if isinstance(config, dict):
+        for key, value in config.items():
+            child_pointer = f"{pointer}/{key.replace('~', '~0').replace('/', '~1')}"
+            if key == "weights" and isinstance(value, list) and value:
+                if not all(isinstance(v, (int, float)) for v in value):
+                    raise ValueError(f"Non-numeric weights at {child_pointer}")
+                arrays.append((child_pointer, [float(v) for v in value]))
+                config[key] = []
+            else:
+                _split_weights(value, child_pointer, arrays)
+    elif isinstance(config, list):
+        for index, value in enumerate(config):
+            _split_weights(value, f"{pointer}/{index}", arrays)
+
+
+def _float_literal(value: float) -> str:
+    # Same double -> float rounding as the JSON loader, printed with enough digits to round-trip.
+    (value32,) = struct.unpack("<f", struct.pack("<f", value))
+    if not math.isfinite(value32):
+        raise ValueError(f"Non-finite weight {value}")
+    text = f"{value32:.9g}"
+    if "." not in text and "e" not in text:
+        text += ".0"
+    return text + "f"
+
+
 def _write_header() -> None:
     OUTPUT_HEADER.write_text(
         """#pragma once
@@ -40,11 +74,25 @@ def _write_header() -> None:
 
 namespace embedded_model
 {
+// One "weights" array of a model config, stored as float32 rather than JSON text.
+struct EmbeddedModelWeightArray
+{
+  const char* jsonPointer; // where the array goes in the config, e.g. "/config/submodels/1/model/weights"
+  size_t offset; // into EmbeddedModelAsset::weights; a multiple of 4, so every array is 16-byte aligned
+  size_t count;
+};
+
+// The model config is JSON with every non-empty "weights" array emptied; the arrays themselves are stored in
+// weights. The loader parses the (small) config and copies the arrays back in (EmbeddedModelConfig.h), so no float
+// text is parsed.
 struct EmbeddedModelAsset
 {
   const char* token;
   const char* json;
   size_t jsonSize;
+  const float* weights;
+  const EmbeddedModelWeightArray* weightArrays;
+  size_t numWeightArrays;
 };
 
 const EmbeddedModelAsset* GetAmpModelAsset(const char* token);
@@ -69,15 +117,45 @@ def _write_source() -> None:
     ]
 
     def append_asset(token: str, file_name: str) -> str:
-        json_text = _read_model_json(INPUT_ROOT / file_name)
+        config = json.loads(_read_model_json(INPUT_ROOT / file_name))
+        weight_arrays: list[tuple[str, list[float]]] = []
+        _split_weights(config, "", weight_arrays)
+        json_text = json.dumps(config, separators=(",", ":"))
         json_symbol = f"k{token}Json"
+        weights_symbol = f"k{token}Weights"
+        arrays_symbol = f"k{token}WeightArrays"
         asset_symbol = f"k{token}Asset"
         lines.append(f"const char {json_symbol}[] =")
         for start in range(0, len(json_text), 2048):
             chunk = json_text[start : start + 2048]
             lines.append(f"  R\"{RAW_STRING_DELIMITER}({chunk}){RAW_STRING_DELIMITER}\"")
         lines.append(";")
-        lines.append(f'const EmbeddedModelAsset {asset_symbol} = {{"{token}", {json_symbol}, sizeof({json_symbol}) - 1}};')
+
+        weights: list[float] = []
+        table: list[tuple[str, int, int]] = []
+        for pointer, values in weight_arrays:
+            weights.extend([0.0] * (-len(weights) % WEIGHT_ALIGNMENT_FLOATS))
+            table.append((pointer, len(weights), len(values)))
+            weights.extend(values)
+        if not weights:
+            weights.append(0.0)
+        lines.append(f"alignas(16) const float {weights_symbol}[] = {{")
+        for start in range(0, len(weights), WEIGHTS_PER_LINE):
+            chunk = weights[start : start + WEIGHTS_PER_LINE]
+            lines.append("  " + ", ".join(_float_literal(v) for v in chunk) + ",")
+        lines.append("};")
+        if table:
+            lines.append(f"const EmbeddedModelWeightArray {arrays_symbol}[] = {{")
+            for pointer, offset, count in table:
+                lines.append(f'  {{"{pointer}", {offset}, {count}}},')
+            lines.append("};")
+            arrays_value = f"{arrays_symbol}, {len(table)}"
+        else:
+            arrays_value = "nullptr, 0"
+        lines.append(
+            f'const EmbeddedModelAsset {asset_symbol} = {{"{token}", {json_symbol}, sizeof({json_symbol}) - 1, '
+            f"{weights_symbol}, {arrays_value}}};"
+        )
         lines.append("")
         return asset_symbol
 